@@ -5,3 +5,4 @@ find_package(GEOS 3.11.1 CONFIG REQUIRED)
         add_compile_definitions(GEOS_COMPATIBILITY_REQUIRED)
     endif ()
 find_package(cubpackpp CONFIG REQUIRED)
+find_package(Threads REQUIRED)
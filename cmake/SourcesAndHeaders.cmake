@@ -2,7 +2,15 @@ set(sources
         src/geometry.cpp
         src/integration/continuous.cpp
         src/integration/discrete.cpp
+        src/integration/fixed.cpp
+        src/integration/gradient.cpp
+        src/integration/qmc.cpp
+        src/integration/quadtree.cpp
+        src/integration/warm_start.cpp
         src/environment.cpp
+        src/trace.cpp
+        src/async.cpp
+        src/sweep.cpp
         src/geometry/coord_sequence_from_array.cpp
         )
 
@@ -17,12 +25,32 @@ set(headers
         include/jpathgen/function.h
         include/jpathgen/error.h
         include/jpathgen/geos_compat.h
+        include/jpathgen/cubature.h
+        include/jpathgen/inline_integration.h
+        include/jpathgen/qmc.h
+        include/jpathgen/gradient.h
+        include/jpathgen/result.h
+        include/jpathgen/trace.h
+        include/jpathgen/raster.h
+        include/jpathgen/discrete_grid.h
+        include/jpathgen/async.h
+        include/jpathgen/sweep.h
         )
 
 set(test_sources
         src/environment_test.cpp
+        src/cubature_test.cpp
+        src/qmc_test.cpp
+        src/gradient_test.cpp
+        src/trace_test.cpp
+        src/raster_test.cpp
+        src/async_test.cpp
+        src/sweep_test.cpp
         src/integration/continuous_test.cpp
         src/integration/discrete_test.cpp
+        src/integration/fixed_test.cpp
+        src/integration/qmc_integration_test.cpp
+        src/integration/quadtree_integration_test.cpp
         )
 
 set(fuzz_sources
@@ -30,3 +58,14 @@ set(fuzz_sources
         variable_length_path.cpp
         variable_length_gmm_and_path.cpp
 )
+
+set(benchmark_sources
+        integrand_dispatch.cpp
+        discrete_scaling.cpp
+        pipeline_stages.cpp
+        entry_points.cpp
+)
+
+set(tool_sources
+        accuracy_sweep.cpp
+)
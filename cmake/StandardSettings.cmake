@@ -8,6 +8,9 @@ option(${PROJECT_NAME_UPPERCASE}_WARNINGS_AS_ERRORS "Treat compiler warnings as
 option(${PROJECT_NAME_UPPERCASE}_ENABLE_UNIT_TESTING "Enable unit tests for the projects (from the `test` subfolder)." OFF)
 option(${PROJECT_NAME_UPPERCASE}_ENABLE_FUZZING "Enable unit tests for the projects (from the `test/fuzzing` subfolder)." OFF)
 option(${PROJECT_NAME_UPPERCASE}_ENABLE_VECTORIZATION "Enable Eigen3 vectorization." OFF)
+option(${PROJECT_NAME_UPPERCASE}_ENABLE_BENCHMARKS "Enable benchmarks for the project (from the `test/benchmarks` subfolder)." OFF)
+option(${PROJECT_NAME_UPPERCASE}_BUILD_TOOLS "Build the command line tools (from the `tools` subfolder)." OFF)
+option(${PROJECT_NAME_UPPERCASE}_ENABLE_TRACING "Enable per-stage timing of the integration pipeline." OFF)
 
 
 #
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_ASYNC_H
+#define JPATHGEN_ASYNC_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace jpathgen
+{
+  namespace async
+  {
+    /**
+     * Asks for the tasks submitted with it to be skipped. A task that has not started yet when it is cancelled is never
+     * run and its future throws instead. A task that has already started runs to completion. Copies share their state.
+     */
+    class Cancellation
+    {
+     protected:
+      std::shared_ptr<std::atomic<bool>> _cancelled = std::make_shared<std::atomic<bool>>(false);
+
+     public:
+      void cancel() const
+      {
+        *_cancelled = true;
+      }
+
+      [[nodiscard]] bool is_cancelled() const
+      {
+        return *_cancelled;
+      }
+    };
+
+    /**
+     * A fixed number of worker threads running the posted tasks first in, first out. The tasks still queued when the
+     * pool is destroyed are run before the workers are joined.
+     */
+    class ThreadPool
+    {
+     protected:
+      std::mutex _mutex;
+      std::condition_variable _has_task, _is_idle;
+      std::deque<std::function<void()>> _tasks;
+      std::size_t _n_running = 0;
+      bool _stopping = false;
+      std::vector<std::thread> _workers;
+
+      void work();
+
+     public:
+      /**
+       * A pool of n_threads workers, or of one per hardware thread for a non-positive n_threads.
+       */
+      explicit ThreadPool(int n_threads = 0);
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator=(const ThreadPool&) = delete;
+      ~ThreadPool();
+
+      [[nodiscard]] int size() const
+      {
+        return static_cast<int>(_workers.size());
+      }
+
+      /**
+       * Queue task for the next free worker. The task must not throw.
+       */
+      void post(std::function<void()> task);
+
+      /**
+       * Block until no task is queued or running.
+       */
+      void wait();
+
+      /**
+       * Run fn(args...) on a worker, with copies of fn and args taken now. Its result, or the exception it threw, is
+       * returned through the future. A task cancelled before it starts throws "The task was cancelled" instead.
+       */
+      template<typename FN, typename... ARGS>
+      std::future<std::invoke_result_t<FN&, ARGS&...>> submit(const Cancellation& cancellation, FN fn, ARGS... args)
+      {
+        typedef std::invoke_result_t<FN&, ARGS&...> R;
+        auto promise = std::make_shared<std::promise<R>>();
+        std::future<R> future = promise->get_future();
+        post(
+            [promise, cancellation, fn, args...]() mutable
+            {
+              if (cancellation.is_cancelled())
+              {
+                promise->set_exception(std::make_exception_ptr("The task was cancelled"));
+                return;
+              }
+              try
+              {
+                if constexpr (std::is_void_v<R>)
+                {
+                  fn(args...);
+                  promise->set_value();
+                }
+                else
+                {
+                  promise->set_value(fn(args...));
+                }
+              }
+              catch (...)
+              {
+                promise->set_exception(std::current_exception());
+              }
+            });
+        return future;
+      }
+
+      template<typename FN, typename... ARGS>
+      std::future<std::invoke_result_t<FN&, ARGS&...>> submit(FN fn, ARGS... args)
+      {
+        return submit(Cancellation(), std::move(fn), std::move(args)...);
+      }
+    };
+
+    /**
+     * The pool shared by submit and the Python bindings, with one worker per hardware thread. It is created on first use.
+     */
+    ThreadPool& default_pool();
+
+    /**
+     * Run fn(args...) on the default pool, e.g. to integrate a path without blocking the calling thread:
+     *
+     *    auto future = async::submit(
+     *        [&args, mmbg](const EigenCoords& path) { return continuous_integration_over_path(mmbg, path, &args); },
+     *        path);
+     *
+     * As with std::async the arguments are copied, so pointers and references such as those to the integration arguments
+     * must stay valid until the future is ready.
+     */
+    template<typename FN, typename... ARGS>
+    std::future<std::invoke_result_t<FN&, ARGS&...>> submit(FN fn, ARGS... args)
+    {
+      return default_pool().submit(std::move(fn), std::move(args)...);
+    }
+
+    template<typename FN, typename... ARGS>
+    std::future<std::invoke_result_t<FN&, ARGS&...>> submit(const Cancellation& cancellation, FN fn, ARGS... args)
+    {
+      return default_pool().submit(cancellation, std::move(fn), std::move(args)...);
+    }
+  }  // namespace async
+}  // namespace jpathgen
+
+#endif  // JPATHGEN_ASYNC_H
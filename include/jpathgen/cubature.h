@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_CUBATURE_H
+#define JPATHGEN_CUBATURE_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "jpathgen/result.h"
+#include "jpathgen/trace.h"
+
+namespace jpathgen
+{
+  namespace cubature
+  {
+    struct Triangle
+    {
+      double ax, ay, bx, by, cx, cy;
+
+      [[nodiscard]] double area() const
+      {
+        return std::abs((bx - ax) * (cy - ay) - (cx - ax) * (by - ay)) / 2;
+      }
+
+      /**
+       * Split into four congruent triangles through the edge midpoints.
+       */
+      [[nodiscard]] std::array<Triangle, 4> split() const
+      {
+        double abx = (ax + bx) / 2, aby = (ay + by) / 2;
+        double bcx = (bx + cx) / 2, bcy = (by + cy) / 2;
+        double cax = (cx + ax) / 2, cay = (cy + ay) / 2;
+        return { Triangle{ ax, ay, abx, aby, cax, cay },
+                 Triangle{ abx, aby, bx, by, bcx, bcy },
+                 Triangle{ cax, cay, bcx, bcy, cx, cy },
+                 Triangle{ abx, aby, bcx, bcy, cax, cay } };
+      }
+    };
+
+    /**
+     * A cubature node in barycentric coordinates with its weight, normalised such that the weights sum to one.
+     */
+    struct Node
+    {
+      double l1, l2, l3, w;
+    };
+
+    // Degree 8, 16 nodes. D.A. Dunavant, "High degree efficient symmetrical Gaussian quadrature rules for the
+    // triangle", 1985. The centroid (weight 0.144315607677787) is evaluated separately as it is shared with RADON_5.
+    inline constexpr double DUNAVANT_8_CENTROID_WEIGHT = 0.144315607677787;
+    inline constexpr std::array<Node, 15> DUNAVANT_8 = {
+      Node{ 0.081414823414554, 0.459292588292723, 0.459292588292723, 0.095091634267285 },
+      Node{ 0.459292588292723, 0.081414823414554, 0.459292588292723, 0.095091634267285 },
+      Node{ 0.459292588292723, 0.459292588292723, 0.081414823414554, 0.095091634267285 },
+      Node{ 0.658861384496480, 0.170569307751760, 0.170569307751760, 0.103217370534718 },
+      Node{ 0.170569307751760, 0.658861384496480, 0.170569307751760, 0.103217370534718 },
+      Node{ 0.170569307751760, 0.170569307751760, 0.658861384496480, 0.103217370534718 },
+      Node{ 0.898905543365938, 0.050547228317031, 0.050547228317031, 0.032458497623198 },
+      Node{ 0.050547228317031, 0.898905543365938, 0.050547228317031, 0.032458497623198 },
+      Node{ 0.050547228317031, 0.050547228317031, 0.898905543365938, 0.032458497623198 },
+      Node{ 0.008394777409958, 0.263112829634638, 0.728492392955404, 0.027230314174435 },
+      Node{ 0.008394777409958, 0.728492392955404, 0.263112829634638, 0.027230314174435 },
+      Node{ 0.263112829634638, 0.008394777409958, 0.728492392955404, 0.027230314174435 },
+      Node{ 0.263112829634638, 0.728492392955404, 0.008394777409958, 0.027230314174435 },
+      Node{ 0.728492392955404, 0.008394777409958, 0.263112829634638, 0.027230314174435 },
+      Node{ 0.728492392955404, 0.263112829634638, 0.008394777409958, 0.027230314174435 },
+    };
+
+    // Degree 5, 7 nodes. J. Radon, 1948. Only used to estimate the error of DUNAVANT_8.
+    inline constexpr double RADON_5_CENTROID_WEIGHT = 0.225;
+    inline constexpr std::array<Node, 6> RADON_5 = {
+      Node{ 0.7974269853530873, 0.10128650732345633, 0.10128650732345633, 0.12593918054482717 },
+      Node{ 0.10128650732345633, 0.7974269853530873, 0.10128650732345633, 0.12593918054482717 },
+      Node{ 0.10128650732345633, 0.10128650732345633, 0.7974269853530873, 0.12593918054482717 },
+      Node{ 0.05971587178976989, 0.47014206410511505, 0.47014206410511505, 0.13239415278850616 },
+      Node{ 0.47014206410511505, 0.05971587178976989, 0.47014206410511505, 0.13239415278850616 },
+      Node{ 0.47014206410511505, 0.47014206410511505, 0.05971587178976989, 0.13239415278850616 },
+    };
+
+    inline constexpr unsigned long NODES_PER_TRIANGLE = 1 + DUNAVANT_8.size() + RADON_5.size();
+
+    struct Estimate
+    {
+      double value, error;
+    };
+
+    /**
+     * An integrand is either pointwise, `double f(double x, double y)`, or batched,
+     * `void f(const double* xs, const double* ys, double* out, std::size_t n)`. A batched integrand is handed every node
+     * of one or more rule applications at once as contiguous arrays and is preferred when a type provides both.
+     */
+    template<typename FUNC>
+    inline constexpr bool is_batch_integrand_v =
+        std::is_invocable_v<FUNC&, const double*, const double*, double*, std::size_t>;
+
+    template<typename FUNC>
+    void evaluate(FUNC& f, const double* xs, const double* ys, double* out, std::size_t n)
+    {
+      if constexpr (is_batch_integrand_v<FUNC>)
+      {
+        f(xs, ys, out, n);
+      }
+      else
+      {
+        for (std::size_t i = 0; i < n; i++)
+        {
+          out[i] = f(xs[i], ys[i]);
+        }
+      }
+    }
+
+    /**
+     * Write the NODES_PER_TRIANGLE nodes of `t` into xs and ys: the centroid, then DUNAVANT_8, then RADON_5.
+     */
+    inline void rule_nodes(const Triangle& t, double* xs, double* ys)
+    {
+      xs[0] = (t.ax + t.bx + t.cx) / 3;
+      ys[0] = (t.ay + t.by + t.cy) / 3;
+      std::size_t k = 1;
+      for (const Node& n : DUNAVANT_8)
+      {
+        xs[k] = n.l1 * t.ax + n.l2 * t.bx + n.l3 * t.cx;
+        ys[k++] = n.l1 * t.ay + n.l2 * t.by + n.l3 * t.cy;
+      }
+      for (const Node& n : RADON_5)
+      {
+        xs[k] = n.l1 * t.ax + n.l2 * t.bx + n.l3 * t.cx;
+        ys[k++] = n.l1 * t.ay + n.l2 * t.by + n.l3 * t.cy;
+      }
+    }
+
+    /**
+     * Combine the integrand values at the nodes written by rule_nodes into the degree 8 estimate, using its difference
+     * to the degree 5 rule as the error estimate.
+     */
+    inline Estimate rule_estimate(const Triangle& t, const double* values)
+    {
+      double high = DUNAVANT_8_CENTROID_WEIGHT * values[0];
+      double low = RADON_5_CENTROID_WEIGHT * values[0];
+      std::size_t k = 1;
+      for (const Node& n : DUNAVANT_8)
+      {
+        high += n.w * values[k++];
+      }
+      for (const Node& n : RADON_5)
+      {
+        low += n.w * values[k++];
+      }
+      double area = t.area();
+      return { high * area, std::abs(high - low) * area };
+    }
+
+    /**
+     * Scratch buffers for batched rule applications, reused between calls to avoid reallocating them on every split.
+     */
+    struct Workspace
+    {
+      std::vector<double> xs, ys, values;
+
+      void resize(std::size_t n_triangles)
+      {
+        xs.resize(n_triangles * NODES_PER_TRIANGLE);
+        ys.resize(n_triangles * NODES_PER_TRIANGLE);
+        values.resize(n_triangles * NODES_PER_TRIANGLE);
+      }
+    };
+
+    /**
+     * Apply the rule to `n` triangles with a single call to `evaluate`, i.e. a single call to a batched integrand.
+     */
+    template<typename FUNC>
+    void apply_rule(FUNC& f, const Triangle* triangles, std::size_t n, Estimate* out, Workspace& workspace)
+    {
+      workspace.resize(n);
+      for (std::size_t i = 0; i < n; i++)
+      {
+        rule_nodes(triangles[i], &workspace.xs[i * NODES_PER_TRIANGLE], &workspace.ys[i * NODES_PER_TRIANGLE]);
+      }
+      evaluate(f, workspace.xs.data(), workspace.ys.data(), workspace.values.data(), n * NODES_PER_TRIANGLE);
+      for (std::size_t i = 0; i < n; i++)
+      {
+        out[i] = rule_estimate(triangles[i], &workspace.values[i * NODES_PER_TRIANGLE]);
+      }
+    }
+
+    /**
+     * Apply the degree 8 rule to a single triangle, using its difference to the degree 5 rule as the error estimate.
+     * FUNC is called directly, so that it can be inlined.
+     */
+    template<typename FUNC>
+    Estimate apply_rule(FUNC& f, const Triangle& t)
+    {
+      std::array<double, NODES_PER_TRIANGLE> xs, ys, values;
+      rule_nodes(t, xs.data(), ys.data());
+      evaluate(f, xs.data(), ys.data(), values.data(), NODES_PER_TRIANGLE);
+      return rule_estimate(t, values.data());
+    }
+
+    /**
+     * Globally adaptive cubature over a set of triangles. The triangle with the largest error estimate is split into
+     * four until the total error satisfies max(abs_err_req, rel_err_req * |value|) or a further split would exceed
+     * max_eval integrand evaluations, or `deadline` has passed. A batched FUNC is called once for all initial
+     * triangles and then once per split, with the nodes of all four children.
+     */
+    template<typename FUNC>
+    IntegrationResult integrate(
+        FUNC& f,
+        const std::vector<Triangle>& triangles,
+        double abs_err_req,
+        double rel_err_req,
+        unsigned long max_eval,
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max())
+    {
+      JPATHGEN_TRACE_SCOPE(CUBATURE);
+      struct Region
+      {
+        Triangle triangle;
+        Estimate estimate;
+      };
+      auto smaller_error = [](const Region& a, const Region& b) { return a.estimate.error < b.estimate.error; };
+
+      Workspace workspace;
+      std::vector<Estimate> estimates(triangles.size());
+      apply_rule(f, triangles.data(), triangles.size(), estimates.data(), workspace);
+
+      std::vector<Region> heap;
+      heap.reserve(triangles.size());
+      double value = 0, error = 0;
+      unsigned long n_evals = triangles.size() * NODES_PER_TRIANGLE;
+      for (std::size_t i = 0; i < triangles.size(); i++)
+      {
+        value += estimates[i].value;
+        error += estimates[i].error;
+        heap.push_back(Region{ triangles[i], estimates[i] });
+      }
+      std::make_heap(heap.begin(), heap.end(), smaller_error);
+
+      std::array<Estimate, 4> child_estimates;
+      bool has_deadline = deadline != std::chrono::steady_clock::time_point::max();
+      bool timed_out = false;
+      while (!heap.empty() && error > std::max(abs_err_req, rel_err_req * std::abs(value)) &&
+             n_evals + 4 * NODES_PER_TRIANGLE <= max_eval)
+      {
+        if (has_deadline && std::chrono::steady_clock::now() >= deadline)
+        {
+          timed_out = true;
+          break;
+        }
+        std::pop_heap(heap.begin(), heap.end(), smaller_error);
+        Region worst = heap.back();
+        heap.pop_back();
+        value -= worst.estimate.value;
+        error -= worst.estimate.error;
+
+        std::array<Triangle, 4> children = worst.triangle.split();
+        apply_rule(f, children.data(), children.size(), child_estimates.data(), workspace);
+        for (std::size_t i = 0; i < children.size(); i++)
+        {
+          value += child_estimates[i].value;
+          error += child_estimates[i].error;
+          heap.push_back(Region{ children[i], child_estimates[i] });
+          std::push_heap(heap.begin(), heap.end(), smaller_error);
+        }
+        n_evals += 4 * NODES_PER_TRIANGLE;
+      }
+
+      bool converged = error <= std::max(abs_err_req, rel_err_req * std::abs(value));
+
+      // Re-sum from the leaves as the running total accumulates cancellation error over many splits
+      IntegrationResult result;
+      for (const Region& region : heap)
+      {
+        result.value += region.estimate.value;
+        result.error += region.estimate.error;
+      }
+      result.n_evals = n_evals;
+      result.n_regions = triangles.size();
+      if (converged)
+      {
+        result.termination = Termination::CONVERGED;
+      }
+      else
+      {
+        result.termination = timed_out ? Termination::DEADLINE : Termination::MAX_EVAL;
+      }
+      return result;
+    }
+
+    /**
+     * Non-adaptive cubature. Every triangle is uniformly split `refinement` times and the rule applied once to each
+     * piece. Without refinement the error is estimated from the degree 5 rule, otherwise from the change of each piece
+     * of the previous level against its four children. Only those two levels are evaluated, the ones before are split
+     * without applying the rule, so the cost is always triangles * (4^(refinement - 1) + 4^refinement) *
+     * NODES_PER_TRIANGLE evaluations, or triangles * NODES_PER_TRIANGLE without refinement.
+     */
+    template<typename FUNC>
+    IntegrationResult integrate_fixed(FUNC& f, std::vector<Triangle> triangles, int refinement = 0)
+    {
+      JPATHGEN_TRACE_SCOPE(CUBATURE);
+      auto split = [](const std::vector<Triangle>& parents, std::vector<Triangle>& children)
+      {
+        children.clear();
+        children.reserve(4 * parents.size());
+        for (const Triangle& t : parents)
+        {
+          for (const Triangle& child : t.split())
+          {
+            children.push_back(child);
+          }
+        }
+      };
+
+      IntegrationResult result;
+      result.n_regions = triangles.size();
+      std::vector<Triangle> children;
+      for (int level = 1; level < refinement; level++)
+      {
+        split(triangles, children);
+        std::swap(triangles, children);
+      }
+
+      Workspace workspace;
+      std::vector<Estimate> estimates(triangles.size());
+      apply_rule(f, triangles.data(), triangles.size(), estimates.data(), workspace);
+      result.n_evals = triangles.size() * NODES_PER_TRIANGLE;
+      if (refinement <= 0)
+      {
+        for (const Estimate& estimate : estimates)
+        {
+          result.value += estimate.value;
+          result.error += estimate.error;
+        }
+        return result;
+      }
+
+      split(triangles, children);
+      std::vector<Estimate> child_estimates(children.size());
+      apply_rule(f, children.data(), children.size(), child_estimates.data(), workspace);
+      result.n_evals += children.size() * NODES_PER_TRIANGLE;
+      for (std::size_t i = 0; i < triangles.size(); i++)
+      {
+        double value = 0;
+        for (std::size_t j = 4 * i; j < 4 * i + 4; j++)
+        {
+          value += child_estimates[j].value;
+        }
+        result.value += value;
+        result.error += std::abs(value - estimates[i].value);
+      }
+      return result;
+    }
+  }  // namespace cubature
+}  // namespace jpathgen
+#endif  // JPATHGEN_CUBATURE_H
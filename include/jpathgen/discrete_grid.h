@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_DISCRETE_GRID_H
+#define JPATHGEN_DISCRETE_GRID_H
+
+#include <geos/geom/Geometry.h>
+
+#include <cstddef>
+#include <eigen3/Eigen/Core>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "jpathgen/cubature.h"
+#include "jpathgen/geometry.h"
+#include "jpathgen/integration.h"
+#include "jpathgen/raster.h"
+#include "jpathgen/result.h"
+
+namespace jpathgen
+{
+  namespace integration
+  {
+    /**
+     * An integrand evaluated once at every point of the grid of a DiscreteArgs. Discrete integrations over a grid only
+     * sum the stored values of the points inside the region, so one grid serves any number of paths, polygons or
+     * rectangles over the same environment. With `single_precision` the values are stored as float, which halves the
+     * memory and bandwidth at the cost of rounding every value to about 7 significant digits.
+     *
+     * The values are never modified once stored, so copies of a grid share them, and a grid can also be made over
+     * values held elsewhere, e.g. in shared memory, without copying them.
+     */
+    class DiscreteGrid
+    {
+     protected:
+      const DiscreteArgs _args;
+      const Eigen::VectorXd _xs, _ys;
+      std::shared_ptr<const double> _values;
+      std::shared_ptr<const float> _single_values;
+      const bool _single_precision;
+
+      // Evaluate f at every grid point, a column at a time on DiscreteArgs::n_threads threads
+      template<typename T, typename FUNC>
+      std::shared_ptr<const T> evaluate(FUNC& f) const;
+
+     public:
+      /**
+       * Evaluate f at every grid point. A batched f is called once per column of M points. The columns are shared out
+       * between `args.get_n_threads()` threads, so f must be safe to call concurrently.
+       */
+      template<typename FUNC>
+      explicit DiscreteGrid(FUNC f, const DiscreteArgs& args, bool single_precision = false);
+
+      /**
+       * A grid over N * M values computed before, in the order of index(i, j). They are not copied, and `values` keeps
+       * them alive for as long as the grid or any of its copies.
+       */
+      DiscreteGrid(const DiscreteArgs& args, std::shared_ptr<const double> values);
+      DiscreteGrid(const DiscreteArgs& args, std::shared_ptr<const float> values);
+
+      [[nodiscard]] const DiscreteArgs& get_args() const
+      {
+        return _args;
+      }
+      [[nodiscard]] const Eigen::VectorXd& get_xs() const
+      {
+        return _xs;
+      }
+      [[nodiscard]] const Eigen::VectorXd& get_ys() const
+      {
+        return _ys;
+      }
+      [[nodiscard]] bool is_single_precision() const
+      {
+        return _single_precision;
+      }
+
+      // Values are stored column by column, i.e. contiguously in y
+      [[nodiscard]] std::size_t index(int i, int j) const
+      {
+        return static_cast<std::size_t>(i) * _args.get_M() + j;
+      }
+      [[nodiscard]] const double* data() const
+      {
+        return _values.get();
+      }
+      [[nodiscard]] const float* single_data() const
+      {
+        return _single_values.get();
+      }
+      [[nodiscard]] double value(int i, int j) const
+      {
+        return _single_precision ? _single_values.get()[index(i, j)] : _values.get()[index(i, j)];
+      }
+
+      /**
+       * The stored values as an N by M matrix.
+       */
+      [[nodiscard]] Eigen::MatrixXd values() const
+      {
+        Eigen::MatrixXd values(_args.get_N(), _args.get_M());
+        for (int i = 0; i < _args.get_N(); i++)
+        {
+          for (int j = 0; j < _args.get_M(); j++)
+          {
+            values(i, j) = value(i, j);
+          }
+        }
+        return values;
+      }
+    };
+
+    /**
+     * Discrete integrations over the stored values of a DiscreteGrid, with the same grid, buffer radius and deadline as
+     * the DiscreteArgs it was built with. They give the same results as the integrations calling the integrand, except
+     * that n_evals counts the values summed rather than integrand calls.
+     */
+    IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        const DiscreteGrid& grid,
+        std::unique_ptr<geos::geom::Geometry> polygon);
+    double discrete_integration_over_polygon(const DiscreteGrid& grid, std::unique_ptr<geos::geom::Geometry> polygon);
+
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(const DiscreteGrid& grid, geometry::STLCoords polygon);
+    double discrete_integration_over_polygon(const DiscreteGrid& grid, geometry::STLCoords polygon);
+
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(const DiscreteGrid& grid, geometry::EigenCoordsRef polygon);
+    double discrete_integration_over_polygon(const DiscreteGrid& grid, geometry::EigenCoordsRef polygon);
+
+    IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        const DiscreteGrid& grid,
+        double left,
+        double right,
+        double bottom,
+        double top);
+    double
+    discrete_integration_over_rectangle(const DiscreteGrid& grid, double left, double right, double bottom, double top);
+
+    template<typename COORDS>
+    IntegrationResult discrete_integration_over_path_with_diagnostics(const DiscreteGrid& grid, COORDS coords);
+    template<typename COORDS>
+    double discrete_integration_over_path(const DiscreteGrid& grid, COORDS coords);
+
+    template<typename COORDS>
+    IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(const DiscreteGrid& grid, std::vector<COORDS> coords_vec);
+    template<typename COORDS>
+    double discrete_integration_over_paths(const DiscreteGrid& grid, std::vector<COORDS> coords_vec);
+
+    // One rectangle per row as (left, right, bottom, top)
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 4> Rectangles;
+
+    /**
+     * Summed-area table of a DiscreteGrid, so that the sum over the grid points inside any axis-aligned rectangle is
+     * four lookups. A second table over the points with both indices even gives the half resolution sum of the error
+     * estimate. Both are accumulated in double, also for single precision grids. Like the values of a grid, the tables
+     * are shared by copies and can be held elsewhere.
+     */
+    class SummedAreaTable
+    {
+     protected:
+      const DiscreteArgs _args;
+      const Eigen::VectorXd _xs, _ys;
+      // (N + 1) by (M + 1), entry (i, j) is the sum over the grid points (i', j') with i' < i and j' < j
+      std::shared_ptr<const double> _sums;
+      // The same over the grid points with both indices even, indexed by half the grid index
+      std::shared_ptr<const double> _coarse_sums;
+
+     public:
+      explicit SummedAreaTable(const DiscreteGrid& grid);
+
+      /**
+       * A table over sums computed before, of size_of_sums() and size_of_coarse_sums() values. They are not copied, and
+       * are kept alive for as long as the table or any of its copies.
+       */
+      SummedAreaTable(
+          const DiscreteArgs& args,
+          std::shared_ptr<const double> sums,
+          std::shared_ptr<const double> coarse_sums);
+
+      [[nodiscard]] static std::size_t size_of_sums(const DiscreteArgs& args)
+      {
+        return static_cast<std::size_t>(args.get_N() + 1) * (args.get_M() + 1);
+      }
+      [[nodiscard]] static std::size_t size_of_coarse_sums(const DiscreteArgs& args)
+      {
+        return static_cast<std::size_t>((args.get_N() + 1) / 2 + 1) * ((args.get_M() + 1) / 2 + 1);
+      }
+      [[nodiscard]] const double* sums() const
+      {
+        return _sums.get();
+      }
+      [[nodiscard]] const double* coarse_sums() const
+      {
+        return _coarse_sums.get();
+      }
+
+      [[nodiscard]] const DiscreteArgs& get_args() const
+      {
+        return _args;
+      }
+      [[nodiscard]] const Eigen::VectorXd& get_xs() const
+      {
+        return _xs;
+      }
+      [[nodiscard]] const Eigen::VectorXd& get_ys() const
+      {
+        return _ys;
+      }
+
+      /**
+       * Sum over the grid points (i, j) with i_begin <= i < i_end and j_begin <= j < j_end.
+       */
+      [[nodiscard]] double sum(int i_begin, int i_end, int j_begin, int j_end) const;
+
+      /**
+       * Sum over the grid points (i, j) with both indices even, i_begin <= i < i_end and j_begin <= j < j_end.
+       */
+      [[nodiscard]] double coarse_sum(int i_begin, int i_end, int j_begin, int j_end) const;
+    };
+
+    /**
+     * Discrete integration over a rectangle in constant time. The grid points counted are those the polygon form
+     * counts, i.e. left < x < right and bottom < y < top, so the value, error and n_evals equal those of
+     * discrete_integration_over_rectangle on the grid up to round-off. The deadline of the DiscreteArgs is ignored.
+     * With fractional coverage the partially covered rows and columns of cells along the edges are weighted by the
+     * fraction covered, still in constant time.
+     */
+    IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        const SummedAreaTable& table,
+        double left,
+        double right,
+        double bottom,
+        double top);
+    double
+    discrete_integration_over_rectangle(const SummedAreaTable& table, double left, double right, double bottom, double top);
+
+    /**
+     * Discrete integration over every row of `rectangles`, e.g. all positions of a sliding window.
+     */
+    Eigen::VectorXd discrete_integration_over_rectangles(const SummedAreaTable& table, const Rectangles& rectangles);
+
+    /**
+     * The grid points of a DiscreteArgs covered so far by a growing path, e.g. for rewards of the newly covered mass.
+     * Each step buffers and rasterises only the new segment, as discrete_integration_over_paths does for whole paths,
+     * and evaluates the integrand only on the grid points it covers for the first time, so that its cost grows with the
+     * length of the segment rather than that of the path so far. The grid points covered after any number of steps are
+     * those of discrete_integration_over_paths over the segments, and so the steps add up to its value.
+     *
+     * Steps are taken on the calling thread and the deadline of the DiscreteArgs is ignored. Fractional coverage is not
+     * supported.
+     */
+    class CoverageTracker
+    {
+     protected:
+      const DiscreteArgs _args;
+      const Eigen::VectorXd _xs, _ys;
+      std::function<void(const double*, const double*, double*, std::size_t)> _f;
+      raster::Bitmask _visited;
+      double _value = 0;
+      unsigned long _n_evals = 0;
+      std::vector<double> _x, _y, _out;
+
+      void check_args() const;
+
+     public:
+      template<typename FUNC>
+      explicit CoverageTracker(FUNC f, const DiscreteArgs& args)
+          : _args(args),
+            _xs(Eigen::VectorXd::LinSpaced(args.get_N(), args.get_minx(), args.get_maxx())),
+            _ys(Eigen::VectorXd::LinSpaced(args.get_M(), args.get_miny(), args.get_maxy())),
+            _f([f](const double* xs, const double* ys, double* out, std::size_t n) mutable
+               { cubature::evaluate(f, xs, ys, out, n); }),
+            _visited(args.get_N(), args.get_M())
+      {
+        check_args();
+      }
+
+      [[nodiscard]] const DiscreteArgs& get_args() const
+      {
+        return _args;
+      }
+      // The integral over the grid points covered so far, i.e. the sum of the steps
+      [[nodiscard]] double get_value() const
+      {
+        return _value;
+      }
+      // Every grid point covered so far was evaluated once
+      [[nodiscard]] unsigned long get_n_evals() const
+      {
+        return _n_evals;
+      }
+      [[nodiscard]] const raster::Bitmask& get_visited() const
+      {
+        return _visited;
+      }
+
+      /**
+       * Cover the buffered segment, usually the last two waypoints of the path, and return the integral over the grid
+       * points it covers for the first time.
+       */
+      template<typename COORDS>
+      double step(COORDS segment);
+
+      /**
+       * Forget every grid point covered so far.
+       */
+      void reset();
+    };
+  }  // namespace integration
+}  // namespace jpathgen
+#endif  // JPATHGEN_DISCRETE_GRID_H
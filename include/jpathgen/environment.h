@@ -5,6 +5,8 @@
 #ifndef JPATHGEN_ENVIRONMENT_H
 #define JPATHGEN_ENVIRONMENT_H
 
+#include <cmath>
+#include <cstddef>
 #include <eigen3/Eigen/Core>
 #include <functional>
 
@@ -30,7 +32,19 @@ namespace jpathgen
       double a, b, c;
 
      public:
-      double operator()(double x, double y);
+      // Defined inline so that templated integrations can inline the whole evaluation into their rule loop
+      double operator()(double x, double y) const
+      {
+        double d, e, f;
+
+        d = (x - mu_x) / sigma_x;
+        e = (y - mu_y) / sigma_y;
+        f = (d * d) - 2 * rho * d * e + (e * e);
+
+        return b * exp(c * f);
+      }
+      // Add the density at each of the n points to out
+      void accumulate(const double* xs, const double* ys, double* out, std::size_t n) const;
       BivariateGaussian(MU mu, COV cov);
     };
 
@@ -48,7 +62,17 @@ namespace jpathgen
       const MUS& getMus() const;
       const COVS& getCovs() const;
 
-      double operator()(double x, double y);
+      double operator()(double x, double y) const
+      {
+        double total = 0;
+        for (const BivariateGaussian& _bg : _bgs)
+        {
+          total += _bg(x, y);
+        }
+        return total / N;
+      }
+      // Batched evaluation, as used by jpathgen::cubature to evaluate all nodes of a rule in one vectorized call
+      void operator()(const double* xs, const double* ys, double* out, std::size_t n) const;
       int length() const;
 
       MultiModalBivariateGaussian(Eigen::Ref<MUS> mus, Eigen::Ref<COVS> covs);
@@ -5,6 +5,7 @@
 #ifndef JPATHGEN_FUNCTION_H
 #define JPATHGEN_FUNCTION_H
 
+#include <cstddef>
 #include <functional>
 
 namespace jpathgen
@@ -12,6 +13,13 @@ namespace jpathgen
   namespace function
   {
     typedef std::function<double(const double&, const double&)> Function;
+
+    /**
+     * An integrand called on batches of points, writing f(xs[i], ys[i]) to out[i] for i < n, e.g. to call a vectorized
+     * Python function once per batch rather than once per point. The continuous integrations integrate it with
+     * jpathgen::cubature::integrate rather than cubpackpp, which only calls integrands one point at a time.
+     */
+    typedef std::function<void(const double*, const double*, double*, std::size_t)> BatchFunction;
   }
 }  // namespace jpathgen
 #endif  // JPATHGEN_FUNCTION_H
@@ -7,6 +7,7 @@
 
 #include <cubpackpp/cubpackpp.h>
 
+#include "jpathgen/cubature.h"
 #include "jpathgen/geos_compat.h"
 
 
@@ -16,6 +17,7 @@
 #include <geos/geom/LineString.h>
 
 #include <eigen3/Eigen/Core>
+#include <functional>
 
 namespace jpathgen
 {
@@ -24,8 +26,11 @@ namespace jpathgen
     using CAS = geos::geom::CoordinateSequenceCompat;
 
     typedef Eigen::Matrix<double, Eigen::Dynamic, 2> EigenCoords;
+    // A view of row-major (n, 2) coordinates, e.g. a C-contiguous NumPy array, which is read without being copied
+    typedef Eigen::Ref<const Eigen::Matrix<double, Eigen::Dynamic, 2, Eigen::RowMajor>> EigenCoordsRef;
     typedef std::vector<std::pair<double,double>> STLCoords;
     typedef std::vector<geos::geom::Coordinate> GeosCoords;
+    typedef std::function<bool(const cubpackpp::Point&, const cubpackpp::Point&, const cubpackpp::Point&)> SplitPredicate;
 
     extern geos::geom::GeometryFactory* _global_factory;
 
@@ -34,12 +39,42 @@ namespace jpathgen
 
     std::unique_ptr<geos::geom::LineString> create_linestring(std::unique_ptr<CAS> cl);
 
+    /**
+     * The polygon without holes bounded by the closed ring `shell`.
+     */
+    std::unique_ptr<geos::geom::Geometry> create_polygon(std::unique_ptr<CAS> shell);
+
     std::unique_ptr<geos::geom::Geometry> buffer_linestring(std::unique_ptr<geos::geom::LineString> ls, double d = 2.5);
 
     template<typename GEOM>
     std::unique_ptr<geos::geom::Geometry> triangulate_polygon(std::unique_ptr<GEOM> poly);
 
-    void geos_to_cubpack(std::unique_ptr<geos::geom::Geometry> geoms, cubpackpp::REGION_COLLECTION& out_region);
+    /**
+     * Add every triangle of `geoms` to `out_region`, returning the number of regions added.
+     */
+    std::size_t geos_to_cubpack(std::unique_ptr<geos::geom::Geometry> geoms, cubpackpp::REGION_COLLECTION& out_region);
+
+    /**
+     * As above, but every triangle is recursively split into four (through its edge midpoints) for as long as `split`
+     * returns true, up to `max_depth` times. Used to hand the cubature an already refined starting subdivision.
+     */
+    std::size_t geos_to_cubpack(
+        std::unique_ptr<geos::geom::Geometry> geoms,
+        cubpackpp::REGION_COLLECTION& out_region,
+        const SplitPredicate& split,
+        int max_depth = 6);
+
+    /**
+     * Every triangle of `geoms` as a cubature::Triangle, for jpathgen::cubature. The triangles are validated as for
+     * geos_to_cubpack.
+     */
+    std::vector<cubature::Triangle> geos_to_triangles(std::unique_ptr<geos::geom::Geometry> geoms);
+
+    /**
+     * The closed rings bounding every polygon in `geometry`: each shell followed by its holes. If `oriented`, shells
+     * are counter-clockwise and holes clockwise, so that the signed areas of the rings add up to the area of `geometry`.
+     */
+    std::vector<STLCoords> polygon_rings(const geos::geom::Geometry* geometry, bool oriented = false);
   }  // namespace geometry
 }  // namespace jpathgen
 
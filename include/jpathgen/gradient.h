@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_GRADIENT_H
+#define JPATHGEN_GRADIENT_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <eigen3/Eigen/Core>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "jpathgen/cubature.h"
+#include "jpathgen/trace.h"
+
+namespace jpathgen
+{
+  namespace gradient
+  {
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 2> Waypoints;
+    typedef std::vector<std::pair<double, double>> Ring;
+
+    // Three point Gauss-Legendre on [0, 1]
+    inline constexpr std::array<double, 3> GAUSS_LEGENDRE_3_NODES = { 0.1127016653792583, 0.5, 0.8872983346207417 };
+    inline constexpr std::array<double, 3> GAUSS_LEGENDRE_3_WEIGHTS = { 5.0 / 18, 8.0 / 18, 5.0 / 18 };
+
+    struct NearestPoint
+    {
+      Eigen::Index segment;
+      double t;
+      double x, y;
+    };
+
+    /**
+     * The point on the polyline through `waypoints` that is nearest to (x, y), as the segment it lies on and the
+     * fraction t along it.
+     */
+    inline NearestPoint nearest_point(const Waypoints& waypoints, double x, double y)
+    {
+      NearestPoint nearest{ 0, 0, waypoints(0, 0), waypoints(0, 1) };
+      double best = std::numeric_limits<double>::infinity();
+      for (Eigen::Index i = 0; i + 1 < std::max<Eigen::Index>(waypoints.rows(), 2); i++)
+      {
+        Eigen::Index j = std::min<Eigen::Index>(i + 1, waypoints.rows() - 1);
+        double ax = waypoints(i, 0), ay = waypoints(i, 1);
+        double dx = waypoints(j, 0) - ax, dy = waypoints(j, 1) - ay;
+        double length2 = dx * dx + dy * dy;
+        double t = length2 > 0 ? std::clamp(((x - ax) * dx + (y - ay) * dy) / length2, 0.0, 1.0) : 0.0;
+        double cx = ax + t * dx, cy = ay + t * dy;
+        double distance2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+        if (distance2 < best)
+        {
+          best = distance2;
+          nearest = { i, t, cx, cy };
+        }
+      }
+      return nearest;
+    }
+
+    /**
+     * Derivative of the integral of f over the buffer of radius `radius` around the polyline through `waypoints`, with
+     * respect to every waypoint coordinate, given the rings bounding that buffer.
+     *
+     * By the Reynolds transport theorem dI/dp = ∮ f (v · n) ds, with v the velocity of the boundary as p moves. Every
+     * boundary point x lies at `radius` from its nearest point c = (1 - t) p_i + t p_{i+1} on the path and moves with
+     * it, so the boundary integral is split between p_i and p_{i+1} with weights (1 - t) and t, with n = (x - c) / |x -
+     * c|. This covers the straight offsets (0 < t < 1) as well as the round caps and joins (t = 0 or 1). The rings are
+     * only a polygonal approximation of the round parts, so every Gauss-Legendre node is projected radially onto the
+     * exact offset curve and its weight scaled by the corresponding change in arc length. Edges are split into pieces
+     * no longer than `max_step`.
+     */
+    template<typename FUNC>
+    Waypoints
+    boundary_gradient(FUNC& f, const std::vector<Ring>& rings, const Waypoints& waypoints, double radius, double max_step)
+    {
+      JPATHGEN_TRACE_SCOPE(GRADIENT);
+      std::vector<double> xs, ys, values, ts, weights;
+      std::vector<Eigen::Index> segments;
+      std::vector<std::pair<double, double>> normals;
+      for (const Ring& ring : rings)
+      {
+        for (std::size_t k = 0; k + 1 < ring.size(); k++)
+        {
+          double ax = ring[k].first, ay = ring[k].second;
+          double ex = ring[k + 1].first - ax, ey = ring[k + 1].second - ay;
+          double length = std::hypot(ex, ey);
+          if (length == 0)
+          {
+            continue;
+          }
+          int n_pieces = static_cast<int>(std::ceil(length / max_step));
+          for (int piece = 0; piece < n_pieces; piece++)
+          {
+            for (std::size_t q = 0; q < GAUSS_LEGENDRE_3_NODES.size(); q++)
+            {
+              double s = (piece + GAUSS_LEGENDRE_3_NODES[q]) / n_pieces;
+              double x = ax + s * ex, y = ay + s * ey;
+
+              NearestPoint c = nearest_point(waypoints, x, y);
+              double rho = std::hypot(x - c.x, y - c.y);
+              if (rho == 0)
+              {
+                continue;
+              }
+              double nx = (x - c.x) / rho, ny = (y - c.y) / rho;
+              double stretch = std::abs(-ny * ex + nx * ey) / length * radius / rho;
+
+              xs.push_back(c.x + radius * nx);
+              ys.push_back(c.y + radius * ny);
+              ts.push_back(c.t);
+              segments.push_back(c.segment);
+              normals.emplace_back(nx, ny);
+              weights.push_back(GAUSS_LEGENDRE_3_WEIGHTS[q] * length / n_pieces * stretch);
+            }
+          }
+        }
+      }
+
+      values.resize(xs.size());
+      cubature::evaluate(f, xs.data(), ys.data(), values.data(), xs.size());
+
+      Waypoints gradient = Waypoints::Zero(waypoints.rows(), 2);
+      for (std::size_t k = 0; k < xs.size(); k++)
+      {
+        double w = values[k] * weights[k];
+        Eigen::Index i = segments[k], j = std::min<Eigen::Index>(i + 1, waypoints.rows() - 1);
+        gradient(i, 0) += (1 - ts[k]) * w * normals[k].first;
+        gradient(i, 1) += (1 - ts[k]) * w * normals[k].second;
+        gradient(j, 0) += ts[k] * w * normals[k].first;
+        gradient(j, 1) += ts[k] * w * normals[k].second;
+      }
+      return gradient;
+    }
+  }  // namespace gradient
+}  // namespace jpathgen
+#endif  // JPATHGEN_GRADIENT_H
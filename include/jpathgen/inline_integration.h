@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_INLINE_INTEGRATION_H
+#define JPATHGEN_INLINE_INTEGRATION_H
+
+#include <geos/geom/GeometryFactory.h>
+
+#include <memory>
+#include <vector>
+
+#include "jpathgen/cubature.h"
+#include "jpathgen/geometry.h"
+#include "jpathgen/integration.h"
+#include "jpathgen/trace.h"
+
+namespace jpathgen
+{
+  namespace integration
+  {
+    /**
+     * Header-only counterparts of the continuous integrations. Rather than wrapping FUNC in a cubpackpp::Function, FUNC
+     * is passed through to jpathgen::cubature::integrate as its own type, so the integrand is called (and can be
+     * inlined) directly from the rule-evaluation loop. Any callable with a `double(double, double)` signature works,
+     * including lambdas. Calls within this namespace are qualified, as ADL on the Args pointer would otherwise also
+     * find the cubpackpp-backed overloads.
+     */
+    namespace inlined
+    {
+      template<typename FUNC>
+      double
+      continuous_integration_over_triangles(FUNC f, const std::vector<cubature::Triangle>& triangles, ContinuousArgs* args)
+      {
+        return cubature::integrate(
+                   f,
+                   triangles,
+                   args->get_abs_err_req(),
+                   args->get_rel_err_req(),
+                   args->get_max_eval(),
+                   deadline_after(args->get_deadline_s()))
+            .value;
+      }
+
+      template<typename FUNC>
+      double continuous_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, ContinuousArgs* args)
+      {
+        auto triangulated = geometry::triangulate_polygon(std::move(polygon));
+        return inlined::continuous_integration_over_triangles(
+            f, geometry::geos_to_triangles(std::move(triangulated)), args);
+      }
+
+      template<typename FUNC>
+      double continuous_integration_over_polygon(FUNC f, geometry::STLCoords polygon, ContinuousArgs* args)
+      {
+        const geos::geom::GeometryFactory* geometry_factory = geos::geom::GeometryFactory::getDefaultInstance();
+
+        std::unique_ptr<geos::geom::CoordinateSequence> coordinate_sequence = geometry::coord_sequence_from_array(polygon);
+        std::unique_ptr<geos::geom::LinearRing> linear_ring =
+            geometry_factory->createLinearRing(std::move(coordinate_sequence));
+        std::unique_ptr<geos::geom::Geometry> geom = geometry_factory->createPolygon(std::move(linear_ring));
+        return inlined::continuous_integration_over_polygon(f, std::move(geom), args);
+      }
+
+      template<typename FUNC, typename COORDS>
+      double continuous_integration_over_path(FUNC f, COORDS coords, ContinuousArgs* args)
+      {
+        std::unique_ptr<geometry::CAS> cs = geometry::coord_sequence_from_array(coords);
+        auto ls = geometry::create_linestring(std::move(cs));
+        auto buffered = geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+        return inlined::continuous_integration_over_polygon(f, std::move(buffered), args);
+      }
+
+      template<typename FUNC, typename COORDS>
+      double continuous_integration_over_paths(FUNC f, std::vector<COORDS> coords_vec, ContinuousArgs* args)
+      {
+        std::unique_ptr<geos::geom::Geometry> union_buffered_paths =
+            geos::geom::GeometryFactory::getDefaultInstance()->createEmptyGeometry();
+        for (auto coords : coords_vec)
+        {
+          std::unique_ptr<geometry::CAS> cs = geometry::coord_sequence_from_array(coords);
+          auto ls = geometry::create_linestring(std::move(cs));
+          std::unique_ptr<geos::geom::Geometry> buffered =
+              geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+          {
+            JPATHGEN_TRACE_SCOPE(UNION);
+            union_buffered_paths = union_buffered_paths->Union(buffered.get());
+          }
+        }
+        return inlined::continuous_integration_over_polygon(f, std::move(union_buffered_paths), args);
+      }
+
+      template<typename FUNC>
+      double continuous_integration_over_rectangle(
+          FUNC f,
+          double left,
+          double right,
+          double bottom,
+          double top,
+          ContinuousArgs* args)
+      {
+        std::vector<cubature::Triangle> triangles{ cubature::Triangle{ left, bottom, right, bottom, right, top },
+                                                   cubature::Triangle{ left, bottom, right, top, left, top } };
+        return inlined::continuous_integration_over_triangles(f, triangles, args);
+      }
+    }  // namespace inlined
+  }  // namespace integration
+}  // namespace jpathgen
+#endif  // JPATHGEN_INLINE_INTEGRATION_H
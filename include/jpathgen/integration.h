@@ -6,16 +6,35 @@
 #define JDRONES_INTEGRATION_H
 
 #include <cubpackpp/cubpackpp.h>
+#include <geos/geom/Envelope.h>
 #include <geos/geom/Polygon.h>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
+#include "jpathgen/cubature.h"
+#include "jpathgen/error.h"
 #include "jpathgen/geometry.h"
 
 namespace jpathgen
 {
   namespace integration
   {
+    /**
+     * The point in time `seconds` from now, or never for a non-positive number of seconds.
+     */
+    inline std::chrono::steady_clock::time_point deadline_after(double seconds)
+    {
+      if (seconds <= 0)
+      {
+        return std::chrono::steady_clock::time_point::max();
+      }
+      auto budget = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+      return std::chrono::steady_clock::now() + budget;
+    }
+
     class Args
     {
      protected:
@@ -29,12 +48,18 @@ namespace jpathgen
       explicit Args(double buffer_radius_m = 2.5) : _buffer_radius_m(buffer_radius_m){};
     };
 
+    /**
+     * Arguments for the adaptive continuous integrations. With a positive `deadline_s` the refinement also stops once
+     * that many seconds have passed since the integration started, returning the estimate and error reached so far.
+     * The geometry (buffering, union and triangulation) cannot be interrupted and is not part of the budget.
+     */
     class ContinuousArgs : public Args
     {
      protected:
       const double _abs_err_req;
       const double _rel_err_req;
       const unsigned long _max_eval;
+      const double _deadline_s;
 
      public:
       [[nodiscard]] double get_abs_err_req() const
@@ -49,20 +74,45 @@ namespace jpathgen
       {
         return _max_eval;
       }
+      [[nodiscard]] double get_deadline_s() const
+      {
+        return _deadline_s;
+      }
 
-      explicit ContinuousArgs(double buffer_radius_m, double abs_err_req = 0, double rel_err_req = 0.05, unsigned long max_eval=100000)
+      explicit ContinuousArgs(
+          double buffer_radius_m,
+          double abs_err_req = 0,
+          double rel_err_req = 0.05,
+          unsigned long max_eval = 100000,
+          double deadline_s = 0)
           : Args(buffer_radius_m),
             _abs_err_req(abs_err_req),
             _rel_err_req(rel_err_req),
-            _max_eval(max_eval)
+            _max_eval(max_eval),
+            _deadline_s(deadline_s)
       {};
     };
 
+    /**
+     * Arguments for the discrete integrations over an N by M grid spanning [minx, maxx] x [miny, maxy]. With a positive
+     * `deadline_s` the grid is visited coarse to fine, and once that many seconds have passed the estimate of the finest
+     * sub-grid completed so far is returned. The grid columns are summed on `n_threads` threads, or one per hardware
+     * thread if it is 0, and the result does not depend on the number of threads.
+     *
+     * Every grid point stands for the cell of the grid spacing around it, (maxx - minx) / (N - 1) by
+     * (maxy - miny) / (M - 1). By default a grid point counts in full if it lies inside the region. With
+     * `fractional_coverage` it is instead weighted by the exact fraction of its cell inside the region, which removes
+     * the staircase error along the boundary. The error is then estimated as the difference to the
+     * unweighted sum, and a deadline is not supported.
+     */
     class DiscreteArgs : public Args
     {
      protected:
       const int _N, _M;
       const double _minx, _maxx, _miny, _maxy;
+      const double _deadline_s;
+      const int _n_threads;
+      const bool _fractional_coverage;
 
      public:
       [[nodiscard]] int get_N() const
@@ -89,28 +139,255 @@ namespace jpathgen
       {
         return _maxy;
       }
-      explicit DiscreteArgs(double buffer_radius_m, int N, int M, double minx, double maxx, double miny, double maxy)
+      [[nodiscard]] double get_deadline_s() const
+      {
+        return _deadline_s;
+      }
+      [[nodiscard]] int get_n_threads() const
+      {
+        return _n_threads;
+      }
+      [[nodiscard]] bool get_fractional_coverage() const
+      {
+        return _fractional_coverage;
+      }
+      explicit DiscreteArgs(
+          double buffer_radius_m,
+          int N,
+          int M,
+          double minx,
+          double maxx,
+          double miny,
+          double maxy,
+          double deadline_s = 0,
+          int n_threads = 1,
+          bool fractional_coverage = false)
           : Args(buffer_radius_m),
             _N(N),
             _M(M),
             _minx(minx),
             _maxx(maxx),
             _miny(miny),
-            _maxy(maxy){};
-      explicit DiscreteArgs(double buffer_radius_m, int N, int M,geos::geom::Envelope envelope, double rel_offset = 0.0, double abs_offset = 0.0)
+            _maxy(maxy),
+            _deadline_s(deadline_s),
+            _n_threads(n_threads),
+            _fractional_coverage(fractional_coverage){};
+      explicit DiscreteArgs(
+          double buffer_radius_m,
+          int N,
+          int M,
+          geos::geom::Envelope envelope,
+          double rel_offset = 0.0,
+          double abs_offset = 0.0,
+          double deadline_s = 0,
+          int n_threads = 1,
+          bool fractional_coverage = false)
           : Args(buffer_radius_m),
             _N(N),
             _M(M),
             _minx(envelope.getMinX()*(1-rel_offset)-abs_offset),
             _maxx(envelope.getMaxX()*(1+rel_offset)+abs_offset),
             _miny(envelope.getMinY()*(1-rel_offset)-abs_offset),
-            _maxy(envelope.getMaxY()*(1+rel_offset)+abs_offset){};
+            _maxy(envelope.getMaxY()*(1+rel_offset)+abs_offset),
+            _deadline_s(deadline_s),
+            _n_threads(n_threads),
+            _fractional_coverage(fractional_coverage){};
+    };
+
+    /**
+     * Arguments for the non-adaptive integrations, which apply a fixed degree 8 rule to every triangle of the
+     * triangulated polygon after `refinement` uniform subdivisions. The cost only depends on the number of triangles.
+     * Each subdivision multiplies it by four, so `refinement` is at most MAX_REFINEMENT.
+     */
+    class FixedArgs : public Args
+    {
+     protected:
+      const int _refinement;
+
+     public:
+      static constexpr int MAX_REFINEMENT = 6;
+      static_assert(MAX_REFINEMENT == 6, "The refinement error message below names MAX_REFINEMENT");
+
+      [[nodiscard]] int get_refinement() const
+      {
+        return _refinement;
+      }
+      explicit FixedArgs(double buffer_radius_m, int refinement = 0)
+          : Args(buffer_radius_m),
+            _refinement(refinement)
+      {
+        Error(refinement < 0 || refinement > MAX_REFINEMENT, "refinement must be between 0 and 6");
+      };
+    };
+
+    /**
+     * Arguments for the randomised quasi-Monte Carlo integrations. `n_replicates` independently scrambled Sobol
+     * sequences of `n_samples` points are mapped onto the polygon and the standard error between them is reported. If
+     * either error requirement is set the sequences are doubled in length until it is met or `max_samples` is reached.
+     */
+    class QmcArgs : public Args
+    {
+     protected:
+      const unsigned long _n_samples;
+      const int _n_replicates;
+      const double _abs_err_req;
+      const double _rel_err_req;
+      const unsigned long _max_samples;
+      const std::uint64_t _seed;
+
+     public:
+      [[nodiscard]] unsigned long get_n_samples() const
+      {
+        return _n_samples;
+      }
+      [[nodiscard]] int get_n_replicates() const
+      {
+        return _n_replicates;
+      }
+      [[nodiscard]] double get_abs_err_req() const
+      {
+        return _abs_err_req;
+      }
+      [[nodiscard]] double get_rel_err_req() const
+      {
+        return _rel_err_req;
+      }
+      [[nodiscard]] unsigned long get_max_samples() const
+      {
+        return _max_samples;
+      }
+      [[nodiscard]] std::uint64_t get_seed() const
+      {
+        return _seed;
+      }
+      explicit QmcArgs(
+          double buffer_radius_m,
+          unsigned long n_samples = 4096,
+          int n_replicates = 8,
+          double abs_err_req = 0,
+          double rel_err_req = 0,
+          unsigned long max_samples = 1 << 22,
+          std::uint64_t seed = 0)
+          : Args(buffer_radius_m),
+            _n_samples(n_samples),
+            _n_replicates(n_replicates),
+            _abs_err_req(abs_err_req),
+            _rel_err_req(rel_err_req),
+            _max_samples(max_samples),
+            _seed(seed){};
+    };
+
+    /**
+     * Arguments for the quadtree integrations, an adaptive form of the discrete integrations. The envelope of the
+     * polygon is split into four cells, and the cell with the largest error estimate again, until the estimates add up
+     * to `target_error`. Only cells the boundary passes through or over which f varies have an error estimate, and none
+     * is split more than `max_depth` times. Every cell is split at least `min_depth` times, so that no feature of f
+     * larger than such a cell is missed.
+     */
+    class QuadtreeArgs : public Args
+    {
+     protected:
+      const double _target_error;
+      const int _max_depth;
+      const int _min_depth;
+
+     public:
+      [[nodiscard]] double get_target_error() const
+      {
+        return _target_error;
+      }
+      [[nodiscard]] int get_max_depth() const
+      {
+        return _max_depth;
+      }
+      [[nodiscard]] int get_min_depth() const
+      {
+        return _min_depth;
+      }
+      explicit QuadtreeArgs(double buffer_radius_m, double target_error = 1e-6, int max_depth = 10, int min_depth = 3)
+          : Args(buffer_radius_m),
+            _target_error(target_error),
+            _max_depth(max_depth),
+            _min_depth(min_depth){};
+    };
+
+    /**
+     * Reusable handle that remembers where the cubature spent its evaluations during the previous call. cubpackpp does
+     * not expose its final subdivision, so the nodes it evaluates are binned into a density map over the integration
+     * envelope instead. The next call pre-splits every triangle whose previous node count exceeds `nodes_per_region`,
+     * so that refinement starts where the mass was last found rather than from the bare triangulation.
+     */
+    class WarmStart
+    {
+     protected:
+      struct DensityMap
+      {
+        double minx = 0, miny = 0, dx = 0, dy = 0;
+        std::vector<unsigned long> counts;
+      };
+
+      const int _resolution;
+      const double _nodes_per_region;
+      DensityMap _map, _next;
+      unsigned long _n_evals = 0;
+
+      [[nodiscard]] double density(double x, double y) const;
+
+     public:
+      [[nodiscard]] int get_resolution() const
+      {
+        return _resolution;
+      }
+      [[nodiscard]] double get_nodes_per_region() const
+      {
+        return _nodes_per_region;
+      }
+      [[nodiscard]] unsigned long get_n_evals() const
+      {
+        return _n_evals;
+      }
+      [[nodiscard]] bool empty() const
+      {
+        return _map.counts.empty();
+      }
+
+      void reset();
+      void begin(const geos::geom::Envelope& envelope);
+      void record(double x, double y);
+      void end();
+      [[nodiscard]] bool should_split(const cubpackpp::Point& a, const cubpackpp::Point& b, const cubpackpp::Point& c)
+          const;
+
+      /**
+       * cubpackpp integrates a triangle with its degree 13 rule of 37 nodes, so a triangle it split once into four costs
+       * 4 * 37 nodes. Triangles that cost more than that were refined again and are pre-split by default.
+       */
+      static constexpr double DEFAULT_NODES_PER_REGION = 4 * 37;
+
+      explicit WarmStart(int resolution = 64, double nodes_per_region = DEFAULT_NODES_PER_REGION);
+    };
+
+    /**
+     * The integral over a buffered path together with its derivative with respect to every waypoint coordinate, as a
+     * matrix of the same shape as the waypoints.
+     */
+    struct ValueAndGradient
+    {
+      double value;
+      geometry::EigenCoords gradient;
     };
 
     template<typename FUNC, typename COORDS>
     double continuous_integration_over_path(FUNC f, COORDS coords, ContinuousArgs* args);
     template<typename FUNC, typename COORDS>
+    double continuous_integration_over_path(FUNC f, COORDS coords, ContinuousArgs* args, WarmStart* warm_start);
+    template<typename FUNC, typename COORDS>
+    ValueAndGradient continuous_integration_over_path_with_gradient(FUNC f, COORDS coords, ContinuousArgs* args);
+    template<typename FUNC, typename COORDS>
     double continuous_integration_over_paths(FUNC f, std::vector<COORDS> coords, ContinuousArgs* args);
+    template<typename FUNC, typename COORDS>
+    double
+    continuous_integration_over_paths(FUNC f, std::vector<COORDS> coords, ContinuousArgs* args, WarmStart* warm_start);
     template<typename FUNC>
     double continuous_integration_over_rectangle(
         FUNC f,
@@ -122,8 +399,16 @@ namespace jpathgen
     template<typename FUNC>
     double continuous_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, ContinuousArgs* args);
     template<typename FUNC>
+    double continuous_integration_over_polygon(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        ContinuousArgs* args,
+        WarmStart* warm_start);
+    template<typename FUNC>
     double continuous_integration_over_polygon(FUNC f, geometry::STLCoords polygon, ContinuousArgs* args);
     template<typename FUNC>
+    double continuous_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, ContinuousArgs* args);
+    template<typename FUNC>
     double continuous_integration_over_region_collections(FUNC f, cubpackpp::REGION_COLLECTION rc, ContinuousArgs* args);
 
     template<typename FUNC, typename COORDS>
@@ -137,6 +422,132 @@ namespace jpathgen
     double discrete_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, DiscreteArgs* args);
     template<typename FUNC>
     double discrete_integration_over_polygon(FUNC f, geometry::STLCoords polygon, DiscreteArgs* args);
+    template<typename FUNC>
+    double discrete_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, DiscreteArgs* args);
+
+    /**
+     * The continuous and discrete integrations above also come in a `_with_diagnostics` variant. It returns the error
+     * estimate, the number of integrand evaluations, the number of starting regions and why the integration stopped
+     * alongside the value. The fixed and QMC integrations below always return an IntegrationResult.
+     */
+    template<typename FUNC, typename COORDS>
+    IntegrationResult continuous_integration_over_path_with_diagnostics(FUNC f, COORDS coords, ContinuousArgs* args);
+    template<typename FUNC, typename COORDS>
+    IntegrationResult
+    continuous_integration_over_path_with_diagnostics(FUNC f, COORDS coords, ContinuousArgs* args, WarmStart* warm_start);
+    template<typename FUNC, typename COORDS>
+    IntegrationResult
+    continuous_integration_over_paths_with_diagnostics(FUNC f, std::vector<COORDS> coords, ContinuousArgs* args);
+    template<typename FUNC, typename COORDS>
+    IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        FUNC f,
+        std::vector<COORDS> coords,
+        ContinuousArgs* args,
+        WarmStart* warm_start);
+    template<typename FUNC>
+    IntegrationResult continuous_integration_over_rectangle_with_diagnostics(
+        FUNC f,
+        double left,
+        double right,
+        double bottom,
+        double top,
+        ContinuousArgs* args);
+    template<typename FUNC>
+    IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        ContinuousArgs* args);
+    template<typename FUNC>
+    IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        ContinuousArgs* args,
+        WarmStart* warm_start);
+    template<typename FUNC>
+    IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(FUNC f, geometry::STLCoords polygon, ContinuousArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(FUNC f, geometry::EigenCoordsRef polygon, ContinuousArgs* args);
+    template<typename FUNC>
+    IntegrationResult continuous_integration_over_region_collections_with_diagnostics(
+        FUNC f,
+        cubpackpp::REGION_COLLECTION rc,
+        ContinuousArgs* args);
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult discrete_integration_over_path_with_diagnostics(FUNC f, COORDS coords, DiscreteArgs* args);
+    template<typename FUNC, typename COORDS>
+    IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(FUNC f, std::vector<COORDS> coords, DiscreteArgs* args);
+    template<typename FUNC>
+    IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        FUNC f,
+        double left,
+        double right,
+        double bottom,
+        double top,
+        DiscreteArgs* args);
+    template<typename FUNC>
+    IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        DiscreteArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(FUNC f, geometry::STLCoords polygon, DiscreteArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(FUNC f, geometry::EigenCoordsRef polygon, DiscreteArgs* args);
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult fixed_integration_over_path(FUNC f, COORDS coords, FixedArgs* args);
+    template<typename FUNC, typename COORDS>
+    IntegrationResult fixed_integration_over_paths(FUNC f, std::vector<COORDS> coords, FixedArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    fixed_integration_over_rectangle(FUNC f, double left, double right, double bottom, double top, FixedArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    fixed_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, FixedArgs* args);
+    template<typename FUNC>
+    IntegrationResult fixed_integration_over_polygon(FUNC f, geometry::STLCoords polygon, FixedArgs* args);
+    template<typename FUNC>
+    IntegrationResult fixed_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, FixedArgs* args);
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult qmc_integration_over_path(FUNC f, COORDS coords, QmcArgs* args);
+    template<typename FUNC, typename COORDS>
+    IntegrationResult qmc_integration_over_paths(FUNC f, std::vector<COORDS> coords, QmcArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    qmc_integration_over_rectangle(FUNC f, double left, double right, double bottom, double top, QmcArgs* args);
+    template<typename FUNC>
+    IntegrationResult qmc_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, QmcArgs* args);
+    template<typename FUNC>
+    IntegrationResult qmc_integration_over_polygon(FUNC f, geometry::STLCoords polygon, QmcArgs* args);
+    template<typename FUNC>
+    IntegrationResult qmc_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, QmcArgs* args);
+
+    /**
+     * The quadtree integrations return the sum over the leaf cells, and as n_regions the number of cells evaluated.
+     * They end CONVERGED if the error estimate is within the target error, and on MAX_EVAL if the maximum depth kept
+     * it from getting there.
+     */
+    template<typename FUNC, typename COORDS>
+    IntegrationResult quadtree_integration_over_path(FUNC f, COORDS coords, QuadtreeArgs* args);
+    template<typename FUNC, typename COORDS>
+    IntegrationResult quadtree_integration_over_paths(FUNC f, std::vector<COORDS> coords, QuadtreeArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    quadtree_integration_over_rectangle(FUNC f, double left, double right, double bottom, double top, QuadtreeArgs* args);
+    template<typename FUNC>
+    IntegrationResult
+    quadtree_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, QuadtreeArgs* args);
+    template<typename FUNC>
+    IntegrationResult quadtree_integration_over_polygon(FUNC f, geometry::STLCoords polygon, QuadtreeArgs* args);
+    template<typename FUNC>
+    IntegrationResult quadtree_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, QuadtreeArgs* args);
 
   }  // namespace integration
 }  // namespace jpathgen
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_QMC_H
+#define JPATHGEN_QMC_H
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "jpathgen/cubature.h"
+#include "jpathgen/error.h"
+#include "jpathgen/trace.h"
+
+namespace jpathgen
+{
+  namespace qmc
+  {
+    inline constexpr int SOBOL_BITS = 32;
+
+    /**
+     * The first two dimensions of the Sobol sequence, randomised with a linear matrix scramble and a digital shift
+     * (Matoušek, 1998). Each scramble is an independent, uniformly distributed, replicate of the point set, which keeps
+     * its low discrepancy.
+     */
+    class ScrambledSobol2D
+    {
+     protected:
+      std::array<std::array<std::uint32_t, SOBOL_BITS>, 2> _directions{};
+      std::array<std::uint32_t, 2> _point{};
+      std::uint64_t _index = 0;
+
+      // Multiply the generator matrix of one dimension by a random lower unit-triangular matrix, i.e. bit i of every
+      // direction number becomes itself xor a random combination of the more significant bits.
+      static void scramble(std::array<std::uint32_t, SOBOL_BITS>& directions, std::mt19937_64& rng)
+      {
+        std::array<std::uint32_t, SOBOL_BITS> rows{};
+        for (int i = 0; i < SOBOL_BITS; i++)
+        {
+          std::uint32_t above = i == 0 ? 0 : ~std::uint32_t{ 0 } << (SOBOL_BITS - i);
+          rows[i] = (static_cast<std::uint32_t>(rng()) & above) | (std::uint32_t{ 1 } << (SOBOL_BITS - 1 - i));
+        }
+        for (std::uint32_t& v : directions)
+        {
+          std::uint32_t scrambled = 0;
+          for (int i = 0; i < SOBOL_BITS; i++)
+          {
+            std::uint32_t parity = std::bitset<SOBOL_BITS>(rows[i] & v).count() & 1;
+            scrambled |= parity << (SOBOL_BITS - 1 - i);
+          }
+          v = scrambled;
+        }
+      }
+
+     public:
+      explicit ScrambledSobol2D(std::mt19937_64& rng)
+      {
+        // Dimension one is van der Corput, dimension two uses the primitive polynomial x + 1 with m_1 = 1.
+        for (int k = 0; k < SOBOL_BITS; k++)
+        {
+          _directions[0][k] = std::uint32_t{ 1 } << (SOBOL_BITS - 1 - k);
+          _directions[1][k] = k == 0 ? _directions[0][0] : _directions[1][k - 1] ^ (_directions[1][k - 1] >> 1);
+        }
+        for (auto& directions : _directions)
+        {
+          scramble(directions, rng);
+        }
+        _point = { static_cast<std::uint32_t>(rng()), static_cast<std::uint32_t>(rng()) };
+      }
+
+      /**
+       * Write the next point into (u, v), both in (0, 1). Points are generated in Gray code order.
+       */
+      void next(double& u, double& v)
+      {
+        constexpr double scale = 1.0 / 4294967296.0;
+        u = (_point[0] + 0.5) * scale;
+        v = (_point[1] + 0.5) * scale;
+
+        int c = 0;
+        for (std::uint64_t n = ++_index; (n & 1) == 0; n >>= 1)
+        {
+          c++;
+        }
+        _point[0] ^= _directions[0][c];
+        _point[1] ^= _directions[1][c];
+      }
+    };
+
+    /**
+     * A measure preserving map from the unit square onto a set of triangles. u first picks a triangle through the
+     * cumulative area and is then rescaled to [0, 1) within it, after which (u, v) is mapped onto that triangle with
+     * the square-root warp. Uniform points on the square therefore become uniform points on the polygon without any
+     * rejection.
+     */
+    class TriangleMap
+    {
+     protected:
+      std::vector<cubature::Triangle> _triangles;
+      std::vector<double> _cdf;
+      double _area = 0;
+
+     public:
+      [[nodiscard]] double area() const
+      {
+        return _area;
+      }
+
+      void operator()(double u, double v, double& x, double& y) const
+      {
+        auto it = std::upper_bound(_cdf.begin(), _cdf.end(), u);
+        std::size_t i = std::min<std::size_t>(it - _cdf.begin(), _triangles.size()) - 1;
+        double lo = _cdf[i], hi = i + 1 < _cdf.size() ? _cdf[i + 1] : 1.0;
+        u = std::clamp((u - lo) / (hi - lo), 0.0, 1.0);
+
+        const cubature::Triangle& t = _triangles[i];
+        double s = std::sqrt(u);
+        double a = 1 - s, b = s * (1 - v), c = s * v;
+        x = a * t.ax + b * t.bx + c * t.cx;
+        y = a * t.ay + b * t.by + c * t.cy;
+      }
+
+      explicit TriangleMap(const std::vector<cubature::Triangle>& triangles)
+      {
+        for (const cubature::Triangle& t : triangles)
+        {
+          if (t.area() > 0)
+          {
+            _triangles.push_back(t);
+            _cdf.push_back(_area);
+            _area += t.area();
+          }
+        }
+        for (double& c : _cdf)
+        {
+          c /= _area;
+        }
+      }
+    };
+
+    inline constexpr std::size_t BATCH_SIZE = 1024;
+
+    /**
+     * Randomised quasi-Monte Carlo integration over a set of triangles. `n_replicates` independently scrambled Sobol
+     * sequences of `n_samples` points each are mapped onto the triangles; the value is the mean of the replicates and
+     * the error its standard error. While the error exceeds max(abs_err_req, rel_err_req * |value|) the sequences are
+     * extended to twice their length, reusing the points already evaluated, until n_replicates * n_samples would exceed
+     * max_samples. With both requirements set to zero exactly n_samples points per replicate are used.
+     */
+    template<typename FUNC>
+    IntegrationResult integrate(
+        FUNC& f,
+        const std::vector<cubature::Triangle>& triangles,
+        unsigned long n_samples,
+        int n_replicates,
+        double abs_err_req,
+        double rel_err_req,
+        unsigned long max_samples,
+        std::uint64_t seed)
+    {
+      JPATHGEN_TRACE_SCOPE(CUBATURE);
+      Error(n_samples == 0, "n_samples must be positive");
+      Error(n_replicates < 2, "At least two replicates are needed to estimate the error");
+
+      IntegrationResult result;
+      result.n_regions = triangles.size();
+      TriangleMap map(triangles);
+      if (map.area() == 0)
+      {
+        return result;
+      }
+
+      std::mt19937_64 rng(seed);
+      std::vector<ScrambledSobol2D> sequences;
+      sequences.reserve(n_replicates);
+      for (int r = 0; r < n_replicates; r++)
+      {
+        sequences.emplace_back(rng);
+      }
+
+      std::vector<double> sums(n_replicates, 0.0);
+      std::array<double, BATCH_SIZE> xs, ys, values;
+      unsigned long n_evaluated = 0;
+      while (true)
+      {
+        for (int r = 0; r < n_replicates; r++)
+        {
+          for (unsigned long start = n_evaluated; start < n_samples; start += BATCH_SIZE)
+          {
+            std::size_t n = std::min<unsigned long>(BATCH_SIZE, n_samples - start);
+            for (std::size_t i = 0; i < n; i++)
+            {
+              double u, v;
+              sequences[r].next(u, v);
+              map(u, v, xs[i], ys[i]);
+            }
+            cubature::evaluate(f, xs.data(), ys.data(), values.data(), n);
+            for (std::size_t i = 0; i < n; i++)
+            {
+              sums[r] += values[i];
+            }
+          }
+        }
+        n_evaluated = n_samples;
+
+        double mean = 0;
+        for (double sum : sums)
+        {
+          mean += sum / n_samples;
+        }
+        mean /= n_replicates;
+        double variance = 0;
+        for (double sum : sums)
+        {
+          variance += (sum / n_samples - mean) * (sum / n_samples - mean);
+        }
+        variance /= n_replicates - 1;
+        result.value = mean * map.area();
+        result.error = std::sqrt(variance / n_replicates) * map.area();
+        result.n_evals = n_samples * n_replicates;
+
+        if (abs_err_req <= 0 && rel_err_req <= 0)
+        {
+          result.termination = Termination::FIXED_BUDGET;
+          return result;
+        }
+        if (result.error <= std::max(abs_err_req, rel_err_req * std::abs(result.value)))
+        {
+          result.termination = Termination::CONVERGED;
+          return result;
+        }
+        if (2 * n_samples * n_replicates > max_samples)
+        {
+          result.termination = Termination::MAX_EVAL;
+          return result;
+        }
+        n_samples *= 2;
+      }
+    }
+  }  // namespace qmc
+}  // namespace jpathgen
+#endif  // JPATHGEN_QMC_H
@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_RASTER_H
+#define JPATHGEN_RASTER_H
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace jpathgen
+{
+  namespace raster
+  {
+    typedef std::vector<std::pair<double, double>> Ring;
+
+    /**
+     * The grid points [begin, end) of a scanline that lie inside the polygon.
+     */
+    struct Span
+    {
+      int begin, end;
+    };
+
+    /**
+     * Even-odd scanline rasterisation of a set of closed rings, i.e. polygon shells, their holes and all parts of a
+     * multipolygon alike. Every vertical scanline crosses the boundary an even number of times and the points between
+     * the first and second, third and fourth, ... crossing are inside. Edges are half-open in x, so a scanline through
+     * a vertex counts it exactly once. Points exactly on the boundary, including those on a vertical edge, are never
+     * inside, as for Geometry::contains.
+     *
+     * The edges are kept sorted by their smallest x and scanlines visited in increasing order of x only look at the
+     * edges that span them. Going back to a smaller x starts the sweep over.
+     */
+    class Scanline
+    {
+     protected:
+      // Oriented so that x0 < x1
+      struct Edge
+      {
+        double x0, y0, x1, y1;
+      };
+      // Vertical edges never cross a scanline, they only remove the points on them from the scanline at their x
+      struct VerticalEdge
+      {
+        double x, y_lo, y_hi;
+      };
+      std::vector<Edge> _edges;
+      std::vector<VerticalEdge> _vertical_edges;
+      std::vector<std::size_t> _active;
+      std::size_t _next = 0;
+      double _last_x = -std::numeric_limits<double>::infinity();
+      std::vector<double> _crossings;
+      std::vector<Span> _spans, _cut;
+
+      // Remove the points [begin, end) from the spans
+      void cut(int begin, int end)
+      {
+        _cut.clear();
+        for (const Span& span : _spans)
+        {
+          if (span.begin < begin)
+          {
+            _cut.push_back(Span{ span.begin, std::min(span.end, begin) });
+          }
+          if (end < span.end)
+          {
+            _cut.push_back(Span{ std::max(span.begin, end), span.end });
+          }
+        }
+        std::swap(_spans, _cut);
+      }
+
+     public:
+      explicit Scanline(const std::vector<Ring>& rings)
+      {
+        for (const Ring& ring : rings)
+        {
+          for (std::size_t k = 0; k + 1 < ring.size(); k++)
+          {
+            auto [ax, ay] = ring[k];
+            auto [bx, by] = ring[k + 1];
+            if (ax < bx)
+            {
+              _edges.push_back(Edge{ ax, ay, bx, by });
+            }
+            else if (bx < ax)
+            {
+              _edges.push_back(Edge{ bx, by, ax, ay });
+            }
+            else if (ay != by)
+            {
+              _vertical_edges.push_back(VerticalEdge{ ax, std::min(ay, by), std::max(ay, by) });
+            }
+          }
+        }
+        std::sort(_edges.begin(), _edges.end(), [](const Edge& a, const Edge& b) { return a.x0 < b.x0; });
+        std::sort(
+            _vertical_edges.begin(),
+            _vertical_edges.end(),
+            [](const VerticalEdge& a, const VerticalEdge& b) { return a.x < b.x; });
+      }
+
+      /**
+       * Crossings of the scanline at x with the boundary, in increasing y.
+       */
+      const std::vector<double>& crossings(double x)
+      {
+        if (x < _last_x)
+        {
+          _next = 0;
+          _active.clear();
+        }
+        _last_x = x;
+
+        while (_next < _edges.size() && _edges[_next].x0 <= x)
+        {
+          _active.push_back(_next++);
+        }
+        _active.erase(
+            std::remove_if(_active.begin(), _active.end(), [this, x](std::size_t e) { return _edges[e].x1 <= x; }),
+            _active.end());
+
+        _crossings.clear();
+        for (std::size_t e : _active)
+        {
+          const Edge& edge = _edges[e];
+          _crossings.push_back(edge.y0 + (x - edge.x0) * (edge.y1 - edge.y0) / (edge.x1 - edge.x0));
+        }
+        std::sort(_crossings.begin(), _crossings.end());
+        return _crossings;
+      }
+
+      /**
+       * The runs of the M increasing grid points `ys` on the scanline at x that lie strictly between a pair of
+       * crossings and not on a vertical edge.
+       */
+      const std::vector<Span>& spans(double x, const double* ys, int M)
+      {
+        const std::vector<double>& ts = crossings(x);
+        _spans.clear();
+        for (std::size_t k = 0; k + 1 < ts.size(); k += 2)
+        {
+          int begin = static_cast<int>(std::upper_bound(ys, ys + M, ts[k]) - ys);
+          int end = static_cast<int>(std::lower_bound(ys, ys + M, ts[k + 1]) - ys);
+          if (begin < end)
+          {
+            _spans.push_back(Span{ begin, end });
+          }
+        }
+
+        auto vertical = std::lower_bound(
+            _vertical_edges.begin(),
+            _vertical_edges.end(),
+            x,
+            [](const VerticalEdge& edge, double value) { return edge.x < value; });
+        for (; vertical != _vertical_edges.end() && vertical->x == x; ++vertical)
+        {
+          cut(static_cast<int>(std::lower_bound(ys, ys + M, vertical->y_lo) - ys),
+              static_cast<int>(std::upper_bound(ys, ys + M, vertical->y_hi) - ys));
+        }
+        return _spans;
+      }
+    };
+
+    /**
+     * A set of points of an N by M grid, one bit per point packed column by column into 64-bit words. Runs of points
+     * are set a word at a time and sets are united by OR-ing their words, a loop the compiler vectorises, over only the
+     * columns that have points set.
+     */
+    class Bitmask
+    {
+     protected:
+      typedef std::uint64_t Word;
+      static constexpr int WORD_BITS = 64;
+      int _N, _M, _words;
+      std::vector<Word> _bits;
+      // Every point set lies in a column in [_column_begin, _column_end)
+      int _column_begin, _column_end;
+
+      Word* column(int i)
+      {
+        return _bits.data() + static_cast<std::size_t>(i) * _words;
+      }
+      [[nodiscard]] const Word* column(int i) const
+      {
+        return _bits.data() + static_cast<std::size_t>(i) * _words;
+      }
+
+     public:
+      Bitmask(int N, int M)
+          : _N(N),
+            _M(M),
+            _words((M + WORD_BITS - 1) / WORD_BITS),
+            _bits(static_cast<std::size_t>(N) * _words, 0),
+            _column_begin(N),
+            _column_end(0)
+      {
+      }
+
+      [[nodiscard]] int get_N() const
+      {
+        return _N;
+      }
+      [[nodiscard]] int get_M() const
+      {
+        return _M;
+      }
+      [[nodiscard]] int column_begin() const
+      {
+        return _column_begin;
+      }
+      [[nodiscard]] int column_end() const
+      {
+        return _column_end;
+      }
+
+      [[nodiscard]] bool test(int i, int j) const
+      {
+        return (column(i)[j / WORD_BITS] >> (j % WORD_BITS)) & 1;
+      }
+
+      /**
+       * Set the points [begin, end) of column i.
+       */
+      void set(int i, int begin, int end)
+      {
+        if (begin >= end)
+        {
+          return;
+        }
+        _column_begin = std::min(_column_begin, i);
+        _column_end = std::max(_column_end, i + 1);
+        Word* words = column(i);
+        const int first = begin / WORD_BITS, last = (end - 1) / WORD_BITS;
+        const Word first_bits = ~Word(0) << (begin % WORD_BITS);
+        const Word last_bits = ~Word(0) >> (WORD_BITS - 1 - (end - 1) % WORD_BITS);
+        if (first == last)
+        {
+          words[first] |= first_bits & last_bits;
+          return;
+        }
+        words[first] |= first_bits;
+        std::fill(words + first + 1, words + last, ~Word(0));
+        words[last] |= last_bits;
+      }
+
+      /**
+       * Set the points of the columns [i_begin, i_end) inside the rings of `scanline`, the grid points being
+       * (xs[i], ys[j]).
+       */
+      void fill(Scanline& scanline, const double* xs, const double* ys, int i_begin, int i_end)
+      {
+        for (int i = i_begin; i < i_end; i++)
+        {
+          for (const Span& span : scanline.spans(xs[i], ys, _M))
+          {
+            set(i, span.begin, span.end);
+          }
+        }
+      }
+
+      void clear()
+      {
+        if (_column_begin < _column_end)
+        {
+          std::fill(column(_column_begin), column(_column_end), Word(0));
+        }
+        _column_begin = _N;
+        _column_end = 0;
+      }
+
+      /**
+       * Add the points of another bitmask of the same grid.
+       */
+      Bitmask& operator|=(const Bitmask& other)
+      {
+        if (other._column_begin >= other._column_end)
+        {
+          return *this;
+        }
+        const std::size_t begin = static_cast<std::size_t>(other._column_begin) * _words;
+        const std::size_t end = static_cast<std::size_t>(other._column_end) * _words;
+        Word* bits = _bits.data();
+        const Word* other_bits = other._bits.data();
+        for (std::size_t k = begin; k < end; k++)
+        {
+          bits[k] |= other_bits[k];
+        }
+        _column_begin = std::min(_column_begin, other._column_begin);
+        _column_end = std::max(_column_end, other._column_end);
+        return *this;
+      }
+
+      [[nodiscard]] std::size_t count() const
+      {
+        std::size_t n = 0;
+        for (Word word : _bits)
+        {
+          n += std::bitset<WORD_BITS>(word).count();
+        }
+        return n;
+      }
+
+      /**
+       * The runs of points set in column i, written to `spans`.
+       */
+      const std::vector<Span>& spans(int i, std::vector<Span>& spans) const
+      {
+        spans.clear();
+        auto add = [&spans](int begin, int end)
+        {
+          if (!spans.empty() && spans.back().end == begin)
+          {
+            spans.back().end = end;
+          }
+          else
+          {
+            spans.push_back(Span{ begin, end });
+          }
+        };
+        const Word* words = column(i);
+        for (int w = 0; w < _words; w++)
+        {
+          const Word word = words[w];
+          const int offset = w * WORD_BITS;
+          if (word == 0)
+          {
+            continue;
+          }
+          if (word == ~Word(0))
+          {
+            add(offset, offset + WORD_BITS);
+            continue;
+          }
+          for (int b = 0; b < WORD_BITS; b++)
+          {
+            if ((word >> b) & 1)
+            {
+              add(offset + b, offset + b + 1);
+            }
+          }
+        }
+        return spans;
+      }
+    };
+
+    /**
+     * A grid cell crossed by the boundary and the fraction of its area inside the polygon.
+     */
+    struct PartialCell
+    {
+      int j;
+      double coverage;
+    };
+
+    /**
+     * Exact coverage of the cells of a vertical strip [x0, x1] by a set of closed rings, the shells oriented counter-
+     * clockwise and the holes clockwise. Cell j of the strip spans [y_min + j dy, y_min + (j + 1) dy] in y. By Green's
+     * theorem the area of the polygon inside a cell is the sum over the edges of the integral of
+     * -(clamp(y, bottom, top) - bottom) dx, which is only evaluated for the cells an edge passes through. Every other
+     * cell is either entirely inside or entirely outside the polygon.
+     *
+     * As for Scanline, strips visited in increasing order of x only look at the edges that span them.
+     */
+    class Coverage
+    {
+     protected:
+      // (ax, ay) -> (bx, by) in the direction of the ring, and the x range of the edge
+      struct Edge
+      {
+        double ax, ay, bx, by, x_lo, x_hi;
+      };
+      struct VerticalEdge
+      {
+        double x, y_lo, y_hi;
+      };
+      // An edge clipped to the strip, still in the direction of the ring
+      struct Piece
+      {
+        double x0, y0, x1, y1;
+      };
+      std::vector<Edge> _edges;
+      std::vector<VerticalEdge> _vertical_edges;
+      std::vector<std::size_t> _active;
+      std::size_t _next = 0;
+      double _last_x0 = -std::numeric_limits<double>::infinity();
+      std::vector<Piece> _pieces;
+      std::vector<int> _rows;
+      std::vector<PartialCell> _cells;
+
+      /**
+       * The integral of -(clamp(y, bottom, top) - bottom) dx along the piece. As y is linear in x, that is the mean of
+       * the clamped height over the y range of the piece, i.e. its antiderivative differenced over the range, times dx.
+       */
+      static double area_below(const Piece& piece, double bottom, double top)
+      {
+        const double height = top - bottom;
+        auto antiderivative = [bottom, top, height](double y)
+        {
+          if (y <= bottom)
+          {
+            return 0.0;
+          }
+          if (y < top)
+          {
+            return (y - bottom) * (y - bottom) / 2;
+          }
+          return height * height / 2 + height * (y - top);
+        };
+        double mean;
+        if (std::abs(piece.y1 - piece.y0) <= 1e-9 * height)
+        {
+          mean = std::clamp((piece.y0 + piece.y1) / 2, bottom, top) - bottom;
+        }
+        else
+        {
+          mean = (antiderivative(piece.y1) - antiderivative(piece.y0)) / (piece.y1 - piece.y0);
+        }
+        return -(piece.x1 - piece.x0) * mean;
+      }
+
+     public:
+      explicit Coverage(const std::vector<Ring>& rings)
+      {
+        for (const Ring& ring : rings)
+        {
+          for (std::size_t k = 0; k + 1 < ring.size(); k++)
+          {
+            auto [ax, ay] = ring[k];
+            auto [bx, by] = ring[k + 1];
+            if (ax != bx)
+            {
+              _edges.push_back(Edge{ ax, ay, bx, by, std::min(ax, bx), std::max(ax, bx) });
+            }
+            else if (ay != by)
+            {
+              _vertical_edges.push_back(VerticalEdge{ ax, std::min(ay, by), std::max(ay, by) });
+            }
+          }
+        }
+        std::sort(_edges.begin(), _edges.end(), [](const Edge& a, const Edge& b) { return a.x_lo < b.x_lo; });
+        std::sort(
+            _vertical_edges.begin(),
+            _vertical_edges.end(),
+            [](const VerticalEdge& a, const VerticalEdge& b) { return a.x < b.x; });
+      }
+
+      /**
+       * The cells 0 <= j < M of the strip [x0, x1] that the boundary passes through, in increasing j.
+       */
+      const std::vector<PartialCell>& partial_cells(double x0, double x1, double y_min, double dy, int M)
+      {
+        if (x0 < _last_x0)
+        {
+          _next = 0;
+          _active.clear();
+        }
+        _last_x0 = x0;
+
+        while (_next < _edges.size() && _edges[_next].x_lo < x1)
+        {
+          _active.push_back(_next++);
+        }
+        _active.erase(
+            std::remove_if(_active.begin(), _active.end(), [this, x0](std::size_t e) { return _edges[e].x_hi <= x0; }),
+            _active.end());
+
+        const double y_max = y_min + M * dy;
+        auto add_rows = [this, y_min, y_max, dy, M](double y_lo, double y_hi)
+        {
+          if (y_hi < y_min || y_lo > y_max)
+          {
+            return;
+          }
+          int j_lo = std::clamp(static_cast<int>(std::floor((y_lo - y_min) / dy)), 0, M - 1);
+          int j_hi = std::clamp(static_cast<int>(std::floor((y_hi - y_min) / dy)), 0, M - 1);
+          for (int j = j_lo; j <= j_hi; j++)
+          {
+            _rows.push_back(j);
+          }
+        };
+
+        _pieces.clear();
+        _rows.clear();
+        for (std::size_t e : _active)
+        {
+          const Edge& edge = _edges[e];
+          const double p = std::max(x0, edge.x_lo), q = std::min(x1, edge.x_hi);
+          if (q <= p)
+          {
+            continue;
+          }
+          const double slope = (edge.by - edge.ay) / (edge.bx - edge.ax);
+          const double y_p = edge.ay + (p - edge.ax) * slope, y_q = edge.ay + (q - edge.ax) * slope;
+          _pieces.push_back(edge.ax < edge.bx ? Piece{ p, y_p, q, y_q } : Piece{ q, y_q, p, y_p });
+          add_rows(std::min(y_p, y_q), std::max(y_p, y_q));
+        }
+        auto vertical = std::upper_bound(
+            _vertical_edges.begin(),
+            _vertical_edges.end(),
+            x0,
+            [](double x, const VerticalEdge& edge) { return x < edge.x; });
+        for (; vertical != _vertical_edges.end() && vertical->x < x1; ++vertical)
+        {
+          add_rows(vertical->y_lo, vertical->y_hi);
+        }
+        std::sort(_rows.begin(), _rows.end());
+        _rows.erase(std::unique(_rows.begin(), _rows.end()), _rows.end());
+
+        _cells.clear();
+        const double cell_area = (x1 - x0) * dy;
+        for (int j : _rows)
+        {
+          const double bottom = y_min + j * dy, top = bottom + dy;
+          double area = 0;
+          for (const Piece& piece : _pieces)
+          {
+            area += area_below(piece, bottom, top);
+          }
+          _cells.push_back(PartialCell{ j, std::clamp(area / cell_area, 0.0, 1.0) });
+        }
+        return _cells;
+      }
+    };
+  }  // namespace raster
+}  // namespace jpathgen
+#endif  // JPATHGEN_RASTER_H
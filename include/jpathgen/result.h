@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_RESULT_H
+#define JPATHGEN_RESULT_H
+
+namespace jpathgen
+{
+  /**
+   * Why an integration stopped. Adaptive integrations end either CONVERGED, once the error estimate satisfies the
+   * requested tolerances, or on MAX_EVAL when the evaluation budget ran out first. Non-adaptive integrations (a
+   * discrete grid, a fixed rule, a fixed number of QMC samples) always spend their whole budget and end on
+   * FIXED_BUDGET. Integrations given a deadline end on DEADLINE if it passed first, with the best estimate so far.
+   */
+  enum class Termination
+  {
+    CONVERGED,
+    MAX_EVAL,
+    FIXED_BUDGET,
+    DEADLINE
+  };
+
+  inline const char* to_string(Termination termination)
+  {
+    switch (termination)
+    {
+      case Termination::CONVERGED: return "converged";
+      case Termination::MAX_EVAL: return "max_eval";
+      case Termination::FIXED_BUDGET: return "fixed_budget";
+      case Termination::DEADLINE: return "deadline";
+    }
+    return "unknown";
+  }
+
+  /**
+   * Everything an integration knows about how it arrived at its value. `n_regions` is the number of regions the
+   * integration was seeded with (triangles, rectangles or grid cells) and is 0 when that is not known, i.e. for a
+   * region collection passed in directly.
+   */
+  struct IntegrationResult
+  {
+    double value = 0;
+    double error = 0;
+    unsigned long n_evals = 0;
+    unsigned long n_regions = 0;
+    Termination termination = Termination::FIXED_BUDGET;
+  };
+}  // namespace jpathgen
+#endif  // JPATHGEN_RESULT_H
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_SWEEP_H
+#define JPATHGEN_SWEEP_H
+
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "jpathgen/geometry.h"
+
+namespace jpathgen
+{
+  namespace sweep
+  {
+    enum class Mode
+    {
+      CONTINUOUS,
+      DISCRETE
+    };
+
+    inline const char* to_string(Mode mode)
+    {
+      switch (mode)
+      {
+        case Mode::CONTINUOUS: return "continuous";
+        case Mode::DISCRETE: return "discrete";
+      }
+      return "unknown";
+    }
+
+    /**
+     * The settings to try: every pair of `rel_err_reqs` and `max_evals` for the continuous integration, and every N in
+     * `grid_sizes` for the discrete one. The grid spans the buffered paths and M is chosen for square cells. Every
+     * setting is timed `n_repeats` times over the whole path set and the fastest is kept. The reference is the
+     * continuous integration with `reference_rel_err_req` and `reference_max_eval`.
+     */
+    class SweepArgs
+    {
+     protected:
+      const double _buffer_radius_m;
+      const std::vector<double> _rel_err_reqs;
+      const std::vector<unsigned long> _max_evals;
+      const std::vector<int> _grid_sizes;
+      const int _n_repeats;
+      const double _reference_rel_err_req;
+      const unsigned long _reference_max_eval;
+
+     public:
+      [[nodiscard]] double get_buffer_radius_m() const
+      {
+        return _buffer_radius_m;
+      }
+      [[nodiscard]] const std::vector<double>& get_rel_err_reqs() const
+      {
+        return _rel_err_reqs;
+      }
+      [[nodiscard]] const std::vector<unsigned long>& get_max_evals() const
+      {
+        return _max_evals;
+      }
+      [[nodiscard]] const std::vector<int>& get_grid_sizes() const
+      {
+        return _grid_sizes;
+      }
+      [[nodiscard]] int get_n_repeats() const
+      {
+        return _n_repeats;
+      }
+      [[nodiscard]] double get_reference_rel_err_req() const
+      {
+        return _reference_rel_err_req;
+      }
+      [[nodiscard]] unsigned long get_reference_max_eval() const
+      {
+        return _reference_max_eval;
+      }
+
+      explicit SweepArgs(
+          double buffer_radius_m,
+          std::vector<double> rel_err_reqs = { 1e-1, 3e-2, 1e-2, 3e-3, 1e-3, 1e-4, 1e-5 },
+          std::vector<unsigned long> max_evals = { 1000, 10000, 100000 },
+          std::vector<int> grid_sizes = { 25, 50, 100, 200, 400, 800, 1600 },
+          int n_repeats = 3,
+          double reference_rel_err_req = 1e-10,
+          unsigned long reference_max_eval = 10000000)
+          : _buffer_radius_m(buffer_radius_m),
+            _rel_err_reqs(std::move(rel_err_reqs)),
+            _max_evals(std::move(max_evals)),
+            _grid_sizes(std::move(grid_sizes)),
+            _n_repeats(n_repeats),
+            _reference_rel_err_req(reference_rel_err_req),
+            _reference_max_eval(reference_max_eval)
+      {};
+    };
+
+    /**
+     * One setting and how it did: the wall time in seconds to integrate over every path, and the largest error relative
+     * to the reference over the paths. `rel_err_req` and `max_eval` are set for the continuous mode, N and M for the
+     * discrete one.
+     */
+    struct Measurement
+    {
+      Mode mode = Mode::CONTINUOUS;
+      double rel_err_req = 0;
+      unsigned long max_eval = 0;
+      int N = 0;
+      int M = 0;
+      double seconds = 0;
+      double error = 0;
+      bool pareto = false;
+    };
+
+    /**
+     * The reference value of every path, the largest error estimate of the reference relative to its value, and every
+     * setting tried in the order they were run.
+     */
+    struct SweepResult
+    {
+      std::vector<double> reference;
+      double reference_error = 0;
+      std::vector<Measurement> measurements;
+    };
+
+    /**
+     * Time every setting of `args` over `paths` and flag those on the Pareto frontier of wall time against error: the
+     * settings no other setting beats on both. The cheapest setting meeting an accuracy requirement is always on it.
+     */
+    template<typename FUNC>
+    SweepResult accuracy_sweep(FUNC f, const std::vector<geometry::EigenCoords>& paths, const SweepArgs& args);
+
+    /**
+     * Set `pareto` on the measurements that are faster than every measurement with a smaller or equal error.
+     */
+    void mark_pareto_frontier(std::vector<Measurement>& measurements);
+
+    /**
+     * Write `result` as a JSON object with the keys "reference", "reference_error" and "measurements". Numbers that are
+     * not finite, such as the error of a setting that failed, are written as null.
+     */
+    void write_json(std::ostream& out, const SweepResult& result);
+  }  // namespace sweep
+}  // namespace jpathgen
+
+#endif  // JPATHGEN_SWEEP_H
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_TRACE_H
+#define JPATHGEN_TRACE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace jpathgen
+{
+  namespace trace
+  {
+    /**
+     * The stages an integration passes through. Each is timed separately when the library is built with
+     * JPATHGEN_ENABLE_TRACING, otherwise the instrumentation compiles out completely.
+     */
+    enum class Stage
+    {
+      COORD_CONVERSION,
+      LINESTRING,
+      BUFFER,
+      UNION,
+      TRIANGULATION,
+      REGION_CONVERSION,
+      CUBATURE,
+      GRID,
+      GRADIENT,
+    };
+    inline constexpr std::size_t N_STAGES = static_cast<std::size_t>(Stage::GRADIENT) + 1;
+
+    inline const char* to_string(Stage stage)
+    {
+      switch (stage)
+      {
+        case Stage::COORD_CONVERSION: return "coord_conversion";
+        case Stage::LINESTRING: return "linestring";
+        case Stage::BUFFER: return "buffer";
+        case Stage::UNION: return "union";
+        case Stage::TRIANGULATION: return "triangulation";
+        case Stage::REGION_CONVERSION: return "region_conversion";
+        case Stage::CUBATURE: return "cubature";
+        case Stage::GRID: return "grid";
+        case Stage::GRADIENT: return "gradient";
+      }
+      return "unknown";
+    }
+
+    struct StageStats
+    {
+      std::uint64_t calls = 0;
+      std::uint64_t total_ns = 0;
+      std::uint64_t max_ns = 0;
+    };
+    typedef std::array<StageStats, N_STAGES> Stats;
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Receives every timed stage as it finishes. `record` is called on the thread that ran the stage and so may be
+     * called from several threads at once.
+     */
+    class Sink
+    {
+     public:
+      virtual ~Sink() = default;
+      virtual void record(Stage stage, Clock::time_point start, Clock::time_point end) = 0;
+    };
+
+    /**
+     * Writes every stage as a complete ("X") event in the Chrome trace event format, viewable in chrome://tracing or
+     * Perfetto. The closing bracket is written when the sink is destroyed.
+     */
+    class ChromeTraceSink : public Sink
+    {
+     protected:
+      std::mutex _mutex;
+      std::unique_ptr<std::ofstream> _file;
+      std::ostream* _out;
+      Clock::time_point _origin = Clock::now();
+      bool _first = true;
+
+     public:
+      explicit ChromeTraceSink(std::ostream& out);
+      explicit ChromeTraceSink(const std::string& path);
+      ~ChromeTraceSink() override;
+
+      void record(Stage stage, Clock::time_point start, Clock::time_point end) override;
+    };
+
+    [[nodiscard]] constexpr bool enabled()
+    {
+#ifdef JPATHGEN_ENABLE_TRACING
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    /**
+     * Replace the sink every stage is forwarded to. Pass nullptr to only keep the counters.
+     */
+    void set_sink(std::shared_ptr<Sink> sink);
+
+    /**
+     * Counters summed over every thread, including those that have already exited.
+     */
+    Stats stats();
+
+    /**
+     * Counters of the calling thread only.
+     */
+    Stats thread_stats();
+
+    /**
+     * Zero the counters of every thread. Stages that finish while this runs may be lost.
+     */
+    void reset();
+
+    void record(Stage stage, Clock::time_point start, Clock::time_point end);
+
+    /**
+     * Times the enclosing scope as one call of `stage`. Use through JPATHGEN_TRACE_SCOPE so that it disappears when
+     * tracing is disabled.
+     */
+    class Scope
+    {
+     protected:
+      Stage _stage;
+      Clock::time_point _start;
+
+     public:
+      explicit Scope(Stage stage) : _stage(stage), _start(Clock::now())
+      {
+      }
+      ~Scope()
+      {
+        record(_stage, _start, Clock::now());
+      }
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+    };
+  }  // namespace trace
+}  // namespace jpathgen
+
+#ifdef JPATHGEN_ENABLE_TRACING
+#define JPATHGEN_TRACE_CONCAT_(a, b) a##b
+#define JPATHGEN_TRACE_CONCAT(a, b)  JPATHGEN_TRACE_CONCAT_(a, b)
+#define JPATHGEN_TRACE_SCOPE(stage) \
+  const jpathgen::trace::Scope JPATHGEN_TRACE_CONCAT(_jpathgen_trace_scope_, __LINE__)(jpathgen::trace::Stage::stage)
+#else
+#define JPATHGEN_TRACE_SCOPE(stage) static_cast<void>(0)
+#endif
+
+#endif  // JPATHGEN_TRACE_H
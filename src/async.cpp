@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include "jpathgen/async.h"
+
+#include <algorithm>
+
+namespace jpathgen
+{
+  namespace async
+  {
+    ThreadPool::ThreadPool(int n_threads)
+    {
+      if (n_threads <= 0)
+      {
+        n_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+      }
+      for (int t = 0; t < n_threads; t++)
+      {
+        _workers.emplace_back(&ThreadPool::work, this);
+      }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+      }
+      _has_task.notify_all();
+      for (std::thread& worker : _workers)
+      {
+        worker.join();
+      }
+    }
+
+    void ThreadPool::post(std::function<void()> task)
+    {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+      }
+      _has_task.notify_one();
+    }
+
+    void ThreadPool::wait()
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _is_idle.wait(lock, [this] { return _tasks.empty() && _n_running == 0; });
+    }
+
+    void ThreadPool::work()
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      while (true)
+      {
+        _has_task.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+        if (_tasks.empty())
+        {
+          return;
+        }
+        std::function<void()> task = std::move(_tasks.front());
+        _tasks.pop_front();
+        _n_running++;
+        lock.unlock();
+        task();
+        // Released before the count goes down, as the task may hold resources that wait() is used to release first
+        task = nullptr;
+        lock.lock();
+        _n_running--;
+        if (_tasks.empty() && _n_running == 0)
+        {
+          _is_idle.notify_all();
+        }
+      }
+    }
+
+    ThreadPool& default_pool()
+    {
+      static ThreadPool pool;
+      return pool;
+    }
+  }  // namespace async
+}  // namespace jpathgen
@@ -24,15 +24,27 @@ namespace jpathgen
       b = (1 / (2 * M_PI * sigma_x * sigma_y * sqrt(a)));
       c = (1 / (-2 * a));
     }
-    double BivariateGaussian::operator()(double x, double y)
-    {
-      double d, e, f;
 
-      d = (x - mu_x) / sigma_x;
-      e = (y - mu_y) / sigma_y;
-      f = (d * d) - 2 * rho * d * e + (e * e);
+    void BivariateGaussian::accumulate(const double* xs, const double* ys, double* out, std::size_t n) const
+    {
+      const auto size = static_cast<Eigen::Index>(n);
+      Eigen::Map<const Eigen::ArrayXd> x(xs, size), y(ys, size);
+      Eigen::Map<Eigen::ArrayXd> total(out, size);
 
-      return b * exp(c * f);
+#ifdef EIGEN_VECTORIZE_AVX
+      // Expressions over the maps rather than ArrayXd, so that no temporaries are allocated
+      auto d = (x - mu_x) / sigma_x;
+      auto e = (y - mu_y) / sigma_y;
+      total += b * (c * (d.square() - 2 * rho * d * e + e.square())).exp();
+#else
+      // Eigen's SSE2 packet exp is slower than the scalar libm exp, so only use it with AVX and above
+      for (Eigen::Index i = 0; i < size; i++)
+      {
+        double d = (x[i] - mu_x) / sigma_x;
+        double e = (y[i] - mu_y) / sigma_y;
+        total[i] += b * exp(c * ((d * d) - 2 * rho * d * e + (e * e)));
+      }
+#endif
     }
 
     MultiModalBivariateGaussian::MultiModalBivariateGaussian(Eigen::Ref<MUS> mus, Eigen::Ref<COVS> covs)
@@ -63,14 +75,15 @@ namespace jpathgen
       }
     }
 
-    double MultiModalBivariateGaussian::operator()(double x, double y)
+    void MultiModalBivariateGaussian::operator()(const double* xs, const double* ys, double* out, std::size_t n) const
     {
-      double total = 0;
-      for (BivariateGaussian _bg : _bgs)
+      Eigen::Map<Eigen::ArrayXd> total(out, static_cast<Eigen::Index>(n));
+      total.setZero();
+      for (const BivariateGaussian& _bg : _bgs)
       {
-        total += _bg(x, y);
+        _bg.accumulate(xs, ys, out, n);
       }
-      return total / N;
+      total /= N;
     }
 
     int MultiModalBivariateGaussian::length() const
@@ -5,8 +5,15 @@
 #include "jpathgen/geometry.h"
 
 #include <geos/geom/Coordinate.h>
+#include <geos/geom/LinearRing.h>
+#include <geos/geom/Polygon.h>
 #include <geos/triangulate/polygon/ConstrainedDelaunayTriangulator.h>
 
+#include <algorithm>
+#include <array>
+
+#include "jpathgen/trace.h"
+
 namespace jpathgen
 {
   namespace geometry
@@ -22,28 +29,41 @@ namespace jpathgen
 
     std::unique_ptr<LineString> create_linestring(std::unique_ptr<CAS> cl)
     {
+      JPATHGEN_TRACE_SCOPE(LINESTRING);
       return _global_factory->createLineString(std::move(cl));
     }
 
+    std::unique_ptr<Geometry> create_polygon(std::unique_ptr<CAS> shell)
+    {
+      const GeometryFactory* geometry_factory = GeometryFactory::getDefaultInstance();
+      return geometry_factory->createPolygon(geometry_factory->createLinearRing(std::move(shell)));
+    }
+
     std::unique_ptr<Geometry> buffer_linestring(std::unique_ptr<LineString> ls, double d)
     {
+      JPATHGEN_TRACE_SCOPE(BUFFER);
       return ls->buffer(d);
     }
 
     template<typename GEOM>
     std::unique_ptr<Geometry> triangulate_polygon(std::unique_ptr<GEOM> poly)
     {
+      JPATHGEN_TRACE_SCOPE(TRIANGULATION);
       return ConstrainedDelaunayTriangulator::triangulate(poly.get());
     }
     template std::unique_ptr<Geometry> triangulate_polygon(std::unique_ptr<Geometry>);
     template std::unique_ptr<Geometry> triangulate_polygon(std::unique_ptr<Polygon>);
     template std::unique_ptr<Geometry> triangulate_polygon(std::unique_ptr<geos::geom::MultiPolygon>);
 
-    void geos_to_cubpack(std::unique_ptr<Geometry> geoms, REGION_COLLECTION& out_region)
+    namespace
     {
-      for (int i = 0; i < geoms->getNumGeometries(); i++)
+      /**
+       * The vertices of a triangle of a triangulation, shared by the conversions for both cubature engines. Throws if it
+       * is not a closed ring of four coordinates.
+       */
+      std::array<Coordinate, 3> triangle_vertices(const Geometry* triangle)
       {
-        auto coords = geoms->getGeometryN(i)->getCoordinates();
+        auto coords = triangle->getCoordinates();
 
         if (coords->getSize() != 4 || !coords->isRing())
         {
@@ -53,17 +73,116 @@ namespace jpathgen
              << "\t isRing = " << coords->isRing() << std::endl;
           throw std::runtime_error(ss.str());
         }
+        return { coords->getAt(0), coords->getAt(1), coords->getAt(2) };
+      }
+
+      std::size_t add_triangle(
+          const Pt& a,
+          const Pt& b,
+          const Pt& c,
+          REGION_COLLECTION& out_region,
+          const SplitPredicate& split,
+          int depth)
+      {
+        if (depth <= 0 || !split(a, b, c))
+        {
+          TRIANGLE tr(a, b, c);
+          out_region += tr;
+          return 1;
+        }
+        Pt ab((a.X() + b.X()) / 2, (a.Y() + b.Y()) / 2);
+        Pt bc((b.X() + c.X()) / 2, (b.Y() + c.Y()) / 2);
+        Pt ca((c.X() + a.X()) / 2, (c.Y() + a.Y()) / 2);
 
-        auto a = coords->getAt(0), b = coords->getAt(1), c = coords->getAt(2);
+        return add_triangle(a, ab, ca, out_region, split, depth - 1) +
+               add_triangle(ab, b, bc, out_region, split, depth - 1) +
+               add_triangle(ca, bc, c, out_region, split, depth - 1) +
+               add_triangle(ab, bc, ca, out_region, split, depth - 1);
+      }
+    }  // namespace
+
+    std::size_t geos_to_cubpack(std::unique_ptr<Geometry> geoms, REGION_COLLECTION& out_region)
+    {
+      return geos_to_cubpack(
+          std::move(geoms), out_region, [](const Pt&, const Pt&, const Pt&) { return false; }, 0);
+    }
+
+    std::size_t geos_to_cubpack(
+        std::unique_ptr<Geometry> geoms,
+        REGION_COLLECTION& out_region,
+        const SplitPredicate& split,
+        int max_depth)
+    {
+      JPATHGEN_TRACE_SCOPE(REGION_CONVERSION);
+      std::size_t n_regions = 0;
+      for (int i = 0; i < geoms->getNumGeometries(); i++)
+      {
+        auto [a, b, c] = triangle_vertices(geoms->getGeometryN(i));
 
         Pt a_cp(a.x, a.y);
         Pt b_cp(b.x, b.y);
         Pt c_cp(c.x, c.y);
 
-        TRIANGLE tr(a_cp, b_cp, c_cp);
+        n_regions += add_triangle(a_cp, b_cp, c_cp, out_region, split, max_depth);
+      }
+      return n_regions;
+    }
 
-        out_region += tr;
+    std::vector<cubature::Triangle> geos_to_triangles(std::unique_ptr<Geometry> geoms)
+    {
+      JPATHGEN_TRACE_SCOPE(REGION_CONVERSION);
+      std::vector<cubature::Triangle> triangles;
+      triangles.reserve(geoms->getNumGeometries());
+      for (int i = 0; i < geoms->getNumGeometries(); i++)
+      {
+        auto [a, b, c] = triangle_vertices(geoms->getGeometryN(i));
+        triangles.push_back(cubature::Triangle{ a.x, a.y, b.x, b.y, c.x, c.y });
+      }
+      return triangles;
+    }
+
+    namespace
+    {
+      // Appends the ring, reversed if `counter_clockwise` is 1 and it is clockwise or -1 and it is counter-clockwise
+      void append_ring(const LineString* line_string, std::vector<STLCoords>& rings, int counter_clockwise = 0)
+      {
+        const geos::geom::CoordinateSequence* coordinates = line_string->getCoordinatesRO();
+        STLCoords ring;
+        ring.reserve(coordinates->size());
+        for (std::size_t i = 0; i < coordinates->size(); i++)
+        {
+          ring.emplace_back(coordinates->getAt(i).x, coordinates->getAt(i).y);
+        }
+        double twice_signed_area = 0;
+        for (std::size_t i = 0; i + 1 < ring.size(); i++)
+        {
+          twice_signed_area += ring[i].first * ring[i + 1].second - ring[i + 1].first * ring[i].second;
+        }
+        if (counter_clockwise * twice_signed_area < 0)
+        {
+          std::reverse(ring.begin(), ring.end());
+        }
+        rings.push_back(std::move(ring));
+      }
+    }  // namespace
+
+    std::vector<STLCoords> polygon_rings(const Geometry* geometry, bool oriented)
+    {
+      std::vector<STLCoords> rings;
+      for (std::size_t g = 0; g < geometry->getNumGeometries(); g++)
+      {
+        const auto* polygon = dynamic_cast<const Polygon*>(geometry->getGeometryN(g));
+        if (polygon == nullptr)
+        {
+          continue;
+        }
+        append_ring(polygon->getExteriorRing(), rings, oriented ? 1 : 0);
+        for (std::size_t i = 0; i < polygon->getNumInteriorRing(); i++)
+        {
+          append_ring(polygon->getInteriorRingN(i), rings, oriented ? -1 : 0);
+        }
       }
+      return rings;
     }
   }  // namespace geometry
 
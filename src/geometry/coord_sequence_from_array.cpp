@@ -8,6 +8,7 @@
 #include "jpathgen/environment.h"
 #include "jpathgen/error.h"
 #include "jpathgen/geometry.h"
+#include "jpathgen/trace.h"
 namespace jpathgen
 {
   namespace geometry
@@ -15,6 +16,7 @@ namespace jpathgen
     template<>
     std::unique_ptr<CAS> coord_sequence_from_array(EigenCoords coords)
     {
+      JPATHGEN_TRACE_SCOPE(COORD_CONVERSION);
       Error(coords.size() == 0, "Coordinate sequence is empty.");
       auto cas = std::make_unique<CAS>();
 
@@ -29,9 +31,25 @@ namespace jpathgen
       return cas;
     }
 
+    template<>
+    std::unique_ptr<CAS> coord_sequence_from_array(EigenCoordsRef coords)
+    {
+      JPATHGEN_TRACE_SCOPE(COORD_CONVERSION);
+      Error(coords.size() == 0, "Coordinate sequence is empty.");
+      auto cas = std::make_unique<CAS>(static_cast<std::size_t>(coords.rows()), 2);
+
+      // Straight from the rows of the view into the sequence, which GEOS needs to own
+      for (Eigen::Index i = 0; i < coords.rows(); i++)
+      {
+        cas->setAt(geos::geom::Coordinate(coords(i, 0), coords(i, 1)), static_cast<std::size_t>(i));
+      }
+      return cas;
+    }
+
     template<>
     std::unique_ptr<CAS> coord_sequence_from_array(STLCoords coords)
     {
+      JPATHGEN_TRACE_SCOPE(COORD_CONVERSION);
       Error(coords.size() == 0, "Coordinate sequence is empty.");
       auto cas = std::make_unique<CAS>();
 
@@ -49,6 +67,7 @@ namespace jpathgen
     template<>
     std::unique_ptr<CAS> coord_sequence_from_array(std::vector<geos::geom::Coordinate> coords)
     {
+      JPATHGEN_TRACE_SCOPE(COORD_CONVERSION);
       Error(coords.size() == 0, "Coordinate sequence is empty.");
 
       auto cas = std::make_unique<CAS>();
@@ -7,14 +7,22 @@
 #include <geos/operation/union/UnaryUnionOp.h>
 #include <geos/triangulate/tri/Tri.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <functional>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "jpathgen/cubature.h"
 #include "jpathgen/environment.h"
+#include "jpathgen/error.h"
 #include "jpathgen/function.h"
 #include "jpathgen/geometry.h"
 #include "jpathgen/geos_compat.h"
 #include "jpathgen/integration.h"
+#include "jpathgen/trace.h"
 
 using namespace geos::geom;
 using namespace geos::triangulate::tri;
@@ -23,27 +31,132 @@ namespace jpathgen
 {
   namespace integration
   {
+    namespace
+    {
+      // Evaluations handed to cubpackpp between two checks of the deadline
+      constexpr unsigned long DEADLINE_CHUNK_EVALS = 2000;
+
+      // cubpackpp calls the integrand one point at a time, so integrands that can only be called on batches of points
+      // are integrated with jpathgen::cubature::integrate instead, which hands them the nodes of a whole split at once
+      template<typename FUNC>
+      inline constexpr bool is_batch_only_v = !std::is_invocable_v<FUNC&, double, double>;
+
+      template<typename FUNC>
+      IntegrationResult
+      integrate_batched(FUNC& f, const std::vector<cubature::Triangle>& triangles, const ContinuousArgs* args)
+      {
+        return cubature::integrate(
+            f,
+            triangles,
+            args->get_abs_err_req(),
+            args->get_rel_err_req(),
+            args->get_max_eval(),
+            deadline_after(args->get_deadline_s()));
+      }
+
+      /**
+       * Integrate `fn` over `rc` with cubpackpp, see continuous_integration_over_region_collections_with_diagnostics.
+       * `fn` counts its own calls in `n_evals`, so that the integrand is not wrapped in yet another cubpackpp::Function
+       * only to count them.
+       */
+      IntegrationResult integrate_region_collection(
+          cubpackpp::Function& fn,
+          const unsigned long& n_evals,
+          cubpackpp::REGION_COLLECTION& rc,
+          const ContinuousArgs* args)
+      {
+        JPATHGEN_TRACE_SCOPE(CUBATURE);
+        double abs_err_req = args->get_abs_err_req(), rel_err_req = args->get_rel_err_req();
+        unsigned long max_eval = args->get_max_eval();
+        bool has_deadline = args->get_deadline_s() > 0;
+        std::chrono::steady_clock::time_point deadline = deadline_after(args->get_deadline_s());
+
+        // Without a deadline cubpackpp gets the whole evaluation budget at once. With one, the budget is handed out in
+        // chunks, each call refining the regions left by the previous one, and the clock is checked in between. The
+        // limit of a call counts every evaluation spent on the collection so far, so it grows by a chunk per call and
+        // never exceeds max_eval.
+        IntegrationResult result;
+        bool converged = false, timed_out = false;
+        unsigned long limit = has_deadline ? std::min(max_eval, DEADLINE_CHUNK_EVALS) : max_eval;
+        while (true)
+        {
+          const unsigned long n_evals_before = n_evals;
+          result.value = cubpackpp::Integrate(fn, rc, abs_err_req, rel_err_req, limit);
+          result.error = rc.AbsoluteError();
+          converged = result.error <= std::max(abs_err_req, rel_err_req * std::abs(result.value));
+          if (!has_deadline || converged || n_evals >= max_eval || n_evals == n_evals_before)
+          {
+            break;
+          }
+          if (std::chrono::steady_clock::now() >= deadline)
+          {
+            timed_out = true;
+            break;
+          }
+          limit = std::min(max_eval, limit + DEADLINE_CHUNK_EVALS);
+        }
+        result.n_evals = n_evals;
+        if (converged)
+        {
+          result.termination = Termination::CONVERGED;
+        }
+        else
+        {
+          result.termination = timed_out ? Termination::DEADLINE : Termination::MAX_EVAL;
+        }
+        return result;
+      }
+    }  // namespace
+
     /*************************************************
      * CONTINUOUS INTEGRATION OVER REGION COLLECTION *
      *************************************************/
     template<typename FUNC>
-    double continuous_integration_over_region_collections(FUNC f, cubpackpp::REGION_COLLECTION rc, ContinuousArgs* args)
+    IntegrationResult continuous_integration_over_region_collections_with_diagnostics(
+        FUNC f,
+        cubpackpp::REGION_COLLECTION rc,
+        ContinuousArgs* args)
     {
-      cubpackpp::Function fn_bound = [&f](const cubpackpp::Point& pt)
+      unsigned long n_evals = 0;
+      cubpackpp::Function fn_bound = [&f, &n_evals](const cubpackpp::Point& pt)
       {
+        n_evals++;
         double x = pt.X(), y = pt.Y();
         return f(x, y);
       };
-      return continuous_integration_over_region_collections(fn_bound, rc, args);
+      return integrate_region_collection(fn_bound, n_evals, rc, args);
     }
     template<>
-    double continuous_integration_over_region_collections(
+    IntegrationResult continuous_integration_over_region_collections_with_diagnostics(
         cubpackpp::Function fn,
         cubpackpp::REGION_COLLECTION rc,
         ContinuousArgs* args)
     {
-      return cubpackpp::Integrate(fn, rc, args->get_abs_err_req(), args->get_rel_err_req(), args->get_max_eval());
+      unsigned long n_evals = 0;
+      cubpackpp::Function fn_counted = [&fn, &n_evals](const cubpackpp::Point& pt)
+      {
+        n_evals++;
+        return fn(pt);
+      };
+      return integrate_region_collection(fn_counted, n_evals, rc, args);
     }
+    template<typename FUNC>
+    double continuous_integration_over_region_collections(FUNC f, cubpackpp::REGION_COLLECTION rc, ContinuousArgs* args)
+    {
+      return continuous_integration_over_region_collections_with_diagnostics(f, rc, args).value;
+    }
+    template IntegrationResult continuous_integration_over_region_collections_with_diagnostics(
+        function::Function,
+        cubpackpp::REGION_COLLECTION,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_region_collections_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        cubpackpp::REGION_COLLECTION,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_region_collections_with_diagnostics(
+        double (*)(double, double),
+        cubpackpp::REGION_COLLECTION,
+        ContinuousArgs*);
     template double
     continuous_integration_over_region_collections(function::Function, cubpackpp::REGION_COLLECTION, ContinuousArgs*);
     template double continuous_integration_over_region_collections(
@@ -60,13 +173,46 @@ namespace jpathgen
      ***************************************/
 
     template<typename FUNC>
-    double continuous_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, ContinuousArgs* args)
+    IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        ContinuousArgs* args)
     {
       auto triangulated = geometry::triangulate_polygon(std::move(polygon));
-      cubpackpp::REGION_COLLECTION rg;
-      geometry::geos_to_cubpack(std::move(triangulated), rg);
-      return continuous_integration_over_region_collections(f, rg, args);
+      if constexpr (is_batch_only_v<FUNC>)
+      {
+        return integrate_batched(f, geometry::geos_to_triangles(std::move(triangulated)), args);
+      }
+      else
+      {
+        cubpackpp::REGION_COLLECTION rg;
+        std::size_t n_regions = geometry::geos_to_cubpack(std::move(triangulated), rg);
+        IntegrationResult result = continuous_integration_over_region_collections_with_diagnostics(f, rg, args);
+        result.n_regions = n_regions;
+        return result;
+      }
+    };
+    template<typename FUNC>
+    double continuous_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, ContinuousArgs* args)
+    {
+      return continuous_integration_over_polygon_with_diagnostics(f, std::move(polygon), args).value;
     };
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        function::Function,
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        double (*)(double, double),
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        function::BatchFunction,
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*);
     template double
     continuous_integration_over_polygon(function::Function, std::unique_ptr<geos::geom::Geometry>, ContinuousArgs*);
     template double continuous_integration_over_polygon(
@@ -75,9 +221,83 @@ namespace jpathgen
         ContinuousArgs*);
     template double
     continuous_integration_over_polygon(double (*)(double, double), std::unique_ptr<geos::geom::Geometry>, ContinuousArgs*);
+    template double
+    continuous_integration_over_polygon(function::BatchFunction, std::unique_ptr<geos::geom::Geometry>, ContinuousArgs*);
 
     template<typename FUNC>
-    double continuous_integration_over_polygon(FUNC f, geometry::STLCoords polygon, ContinuousArgs* args)
+    IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        ContinuousArgs* args,
+        WarmStart* warm_start)
+    {
+      Error(warm_start == nullptr, "warm_start must not be null");
+      const geos::geom::Envelope envelope = *polygon->getEnvelopeInternal();
+      auto triangulated = geometry::triangulate_polygon(std::move(polygon));
+      cubpackpp::REGION_COLLECTION rg;
+      std::size_t n_regions = geometry::geos_to_cubpack(
+          std::move(triangulated),
+          rg,
+          [warm_start](const cubpackpp::Point& a, const cubpackpp::Point& b, const cubpackpp::Point& c)
+          { return warm_start->should_split(a, b, c); });
+
+      warm_start->begin(envelope);
+      unsigned long n_evals = 0;
+      cubpackpp::Function fn_bound = [&f, warm_start, &n_evals](const cubpackpp::Point& pt)
+      {
+        n_evals++;
+        double x = pt.X(), y = pt.Y();
+        warm_start->record(x, y);
+        return f(x, y);
+      };
+      IntegrationResult result = integrate_region_collection(fn_bound, n_evals, rg, args);
+      warm_start->end();
+      result.n_regions = n_regions;
+      return result;
+    };
+    template<typename FUNC>
+    double continuous_integration_over_polygon(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        ContinuousArgs* args,
+        WarmStart* warm_start)
+    {
+      return continuous_integration_over_polygon_with_diagnostics(f, std::move(polygon), args, warm_start).value;
+    };
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        function::Function,
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        double (*)(double, double),
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_polygon(
+        function::Function,
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_polygon(
+        environment::MultiModalBivariateGaussian,
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_polygon(
+        double (*)(double, double),
+        std::unique_ptr<geos::geom::Geometry>,
+        ContinuousArgs*,
+        WarmStart*);
+
+    template<typename FUNC>
+    IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(FUNC f, geometry::STLCoords polygon, ContinuousArgs* args)
     {
       const geos::geom::GeometryFactory* geometry_factory = geos::geom::GeometryFactory::getDefaultInstance();
 
@@ -85,64 +305,304 @@ namespace jpathgen
       std::unique_ptr<geos::geom::LinearRing> linear_ring =
           geometry_factory->createLinearRing(std::move(coordinate_sequence));
       std::unique_ptr<geos::geom::Polygon> geom = geometry_factory->createPolygon(std::move(linear_ring));
-      return continuous_integration_over_polygon(f, std::move(geom), args);
+      return continuous_integration_over_polygon_with_diagnostics(f, std::move(geom), args);
     };
-    template double continuous_integration_over_polygon(function::Function, geometry::STLCoords polygon, ContinuousArgs*);
-    template double continuous_integration_over_polygon(
+    template<typename FUNC>
+    double continuous_integration_over_polygon(FUNC f, geometry::STLCoords polygon, ContinuousArgs* args)
+    {
+      return continuous_integration_over_polygon_with_diagnostics(f, polygon, args).value;
+    };
+    template IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(function::Function, geometry::STLCoords, ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
         environment::MultiModalBivariateGaussian,
-        geometry::STLCoords polygon,
+        geometry::STLCoords,
+        ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(double (*)(double, double), geometry::STLCoords, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(function::BatchFunction, geometry::STLCoords, ContinuousArgs*);
+    template double continuous_integration_over_polygon(function::Function, geometry::STLCoords, ContinuousArgs*);
+    template double
+    continuous_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::STLCoords, ContinuousArgs*);
+    template double continuous_integration_over_polygon(double (*)(double, double), geometry::STLCoords, ContinuousArgs*);
+    template double continuous_integration_over_polygon(function::BatchFunction, geometry::STLCoords, ContinuousArgs*);
+
+    template<typename FUNC>
+    IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(FUNC f, geometry::EigenCoordsRef polygon, ContinuousArgs* args)
+    {
+      return continuous_integration_over_polygon_with_diagnostics(
+          f, geometry::create_polygon(geometry::coord_sequence_from_array(polygon)), args);
+    };
+    template<typename FUNC>
+    double continuous_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, ContinuousArgs* args)
+    {
+      return continuous_integration_over_polygon_with_diagnostics(f, polygon, args).value;
+    };
+    template IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(function::Function, geometry::EigenCoordsRef, ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoordsRef,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_polygon_with_diagnostics(
+        double (*)(double, double),
+        geometry::EigenCoordsRef,
         ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_polygon_with_diagnostics(function::BatchFunction, geometry::EigenCoordsRef, ContinuousArgs*);
+    template double continuous_integration_over_polygon(function::Function, geometry::EigenCoordsRef, ContinuousArgs*);
+    template double
+    continuous_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, ContinuousArgs*);
     template double
-    continuous_integration_over_polygon(double (*)(double, double), geometry::STLCoords polygon, ContinuousArgs*);
+    continuous_integration_over_polygon(double (*)(double, double), geometry::EigenCoordsRef, ContinuousArgs*);
+    template double continuous_integration_over_polygon(function::BatchFunction, geometry::EigenCoordsRef, ContinuousArgs*);
 
     /************************************
      * CONTINUOUS INTEGRATION OVER PATH *
      ************************************/
 
     template<typename FUNC, typename COORDS>
-    double continuous_integration_over_path(FUNC f, COORDS coords, ContinuousArgs* args)
+    IntegrationResult continuous_integration_over_path_with_diagnostics(FUNC f, COORDS coords, ContinuousArgs* args)
     {
       std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
       auto ls = geometry::create_linestring(std::move(cs));
       auto buffered = geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
-      return continuous_integration_over_polygon(f, std::move(buffered), args);
+      return continuous_integration_over_polygon_with_diagnostics(f, std::move(buffered), args);
+    }
+    template<typename FUNC, typename COORDS>
+    double continuous_integration_over_path(FUNC f, COORDS coords, ContinuousArgs* args)
+    {
+      return continuous_integration_over_path_with_diagnostics(f, coords, args).value;
     }
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(function::Function, geometry::EigenCoords, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(function::Function, geometry::EigenCoordsRef, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(function::Function, geometry::STLCoords, ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoords,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoordsRef,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::STLCoords,
+        ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(double (*)(double, double), geometry::EigenCoords, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(function::BatchFunction, geometry::EigenCoords, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(double (*)(double, double), geometry::EigenCoordsRef, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(function::BatchFunction, geometry::EigenCoordsRef, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(double (*)(double, double), geometry::STLCoords, ContinuousArgs*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(function::BatchFunction, geometry::STLCoords, ContinuousArgs*);
     template double continuous_integration_over_path(function::Function, geometry::EigenCoords, ContinuousArgs*);
+    template double continuous_integration_over_path(function::Function, geometry::EigenCoordsRef, ContinuousArgs*);
     template double continuous_integration_over_path(function::Function, geometry::STLCoords, ContinuousArgs*);
     template double
     continuous_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoords, ContinuousArgs*);
     template double
+    continuous_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, ContinuousArgs*);
+    template double
     continuous_integration_over_path(environment::MultiModalBivariateGaussian, geometry::STLCoords, ContinuousArgs*);
     template double continuous_integration_over_path(double (*)(double, double), geometry::EigenCoords, ContinuousArgs*);
+    template double continuous_integration_over_path(function::BatchFunction, geometry::EigenCoords, ContinuousArgs*);
+    template double continuous_integration_over_path(double (*)(double, double), geometry::EigenCoordsRef, ContinuousArgs*);
+    template double continuous_integration_over_path(function::BatchFunction, geometry::EigenCoordsRef, ContinuousArgs*);
     template double continuous_integration_over_path(double (*)(double, double), geometry::STLCoords, ContinuousArgs*);
+    template double continuous_integration_over_path(function::BatchFunction, geometry::STLCoords, ContinuousArgs*);
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult
+    continuous_integration_over_path_with_diagnostics(FUNC f, COORDS coords, ContinuousArgs* args, WarmStart* warm_start)
+    {
+      std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+      auto ls = geometry::create_linestring(std::move(cs));
+      auto buffered = geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+      return continuous_integration_over_polygon_with_diagnostics(f, std::move(buffered), args, warm_start);
+    }
+    template<typename FUNC, typename COORDS>
+    double continuous_integration_over_path(FUNC f, COORDS coords, ContinuousArgs* args, WarmStart* warm_start)
+    {
+      return continuous_integration_over_path_with_diagnostics(f, coords, args, warm_start).value;
+    }
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        function::Function,
+        geometry::EigenCoords,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        function::Function,
+        geometry::EigenCoordsRef,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult
+    continuous_integration_over_path_with_diagnostics(function::Function, geometry::STLCoords, ContinuousArgs*, WarmStart*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoords,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoordsRef,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::STLCoords,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        double (*)(double, double),
+        geometry::EigenCoords,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        double (*)(double, double),
+        geometry::EigenCoordsRef,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_path_with_diagnostics(
+        double (*)(double, double),
+        geometry::STLCoords,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_path(function::Function, geometry::EigenCoords, ContinuousArgs*, WarmStart*);
+    template double
+    continuous_integration_over_path(function::Function, geometry::EigenCoordsRef, ContinuousArgs*, WarmStart*);
+    template double continuous_integration_over_path(function::Function, geometry::STLCoords, ContinuousArgs*, WarmStart*);
+    template double continuous_integration_over_path(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoords,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_path(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoordsRef,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_path(
+        environment::MultiModalBivariateGaussian,
+        geometry::STLCoords,
+        ContinuousArgs*,
+        WarmStart*);
+    template double
+    continuous_integration_over_path(double (*)(double, double), geometry::EigenCoords, ContinuousArgs*, WarmStart*);
+    template double
+    continuous_integration_over_path(double (*)(double, double), geometry::EigenCoordsRef, ContinuousArgs*, WarmStart*);
+    template double
+    continuous_integration_over_path(double (*)(double, double), geometry::STLCoords, ContinuousArgs*, WarmStart*);
 
     /*************************************
      * CONTINUOUS INTEGRATION OVER PATHS *
      *************************************/
 
-    template<typename FUNC, typename COORDS>
-    double continuous_integration_over_paths(FUNC f, std::vector<COORDS> coords_vec, ContinuousArgs* args)
+    namespace
     {
-      std::unique_ptr<Geometry> union_buffered_paths =
-          geos::geom::GeometryFactory::getDefaultInstance()->createEmptyGeometry();
-      for (auto coords : coords_vec)
+      template<typename COORDS>
+      std::unique_ptr<Geometry> union_of_buffered_paths(const std::vector<COORDS>& coords_vec, double buffer_radius_m)
       {
-        std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
-        auto ls = geometry::create_linestring(std::move(cs));
-        std::unique_ptr<geos::geom::Geometry> buffered =
-            geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
-        union_buffered_paths = union_buffered_paths->Union(buffered.get());
+        std::unique_ptr<Geometry> union_buffered_paths =
+            geos::geom::GeometryFactory::getDefaultInstance()->createEmptyGeometry();
+        for (auto coords : coords_vec)
+        {
+          std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+          auto ls = geometry::create_linestring(std::move(cs));
+          std::unique_ptr<geos::geom::Geometry> buffered = geometry::buffer_linestring(std::move(ls), buffer_radius_m);
+          {
+            JPATHGEN_TRACE_SCOPE(UNION);
+            union_buffered_paths = union_buffered_paths->Union(buffered.get());
+          }
+        }
+        return union_buffered_paths;
       }
-      return continuous_integration_over_polygon(f, std::move(union_buffered_paths), args);
+    }  // namespace
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult
+    continuous_integration_over_paths_with_diagnostics(FUNC f, std::vector<COORDS> coords_vec, ContinuousArgs* args)
+    {
+      return continuous_integration_over_polygon_with_diagnostics(
+          f, union_of_buffered_paths(coords_vec, args->get_buffer_radius_m()), args);
+    }
+    template<typename FUNC, typename COORDS>
+    double continuous_integration_over_paths(FUNC f, std::vector<COORDS> coords_vec, ContinuousArgs* args)
+    {
+      return continuous_integration_over_paths_with_diagnostics(f, coords_vec, args).value;
     }
 
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::Function,
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::Function,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::Function,
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::BatchFunction,
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::BatchFunction,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::BatchFunction,
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*);
     template double
     continuous_integration_over_paths(function::Function, std::vector<geometry::EigenCoords>, ContinuousArgs*);
+    template double
+    continuous_integration_over_paths(function::Function, std::vector<geometry::EigenCoordsRef>, ContinuousArgs*);
     template double continuous_integration_over_paths(function::Function, std::vector<geometry::STLCoords>, ContinuousArgs*);
     template double continuous_integration_over_paths(
         environment::MultiModalBivariateGaussian,
         std::vector<geometry::EigenCoords>,
         ContinuousArgs*);
+    template double continuous_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*);
     template double continuous_integration_over_paths(
         environment::MultiModalBivariateGaussian,
         std::vector<geometry::STLCoords>,
@@ -150,34 +610,196 @@ namespace jpathgen
     template double
     continuous_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoords>, ContinuousArgs*);
     template double
+    continuous_integration_over_paths(function::BatchFunction, std::vector<geometry::EigenCoords>, ContinuousArgs*);
+    template double
+    continuous_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoordsRef>, ContinuousArgs*);
+    template double
+    continuous_integration_over_paths(function::BatchFunction, std::vector<geometry::EigenCoordsRef>, ContinuousArgs*);
+    template double
     continuous_integration_over_paths(double (*)(double, double), std::vector<geometry::STLCoords>, ContinuousArgs*);
+    template double
+    continuous_integration_over_paths(function::BatchFunction, std::vector<geometry::STLCoords>, ContinuousArgs*);
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        FUNC f,
+        std::vector<COORDS> coords_vec,
+        ContinuousArgs* args,
+        WarmStart* warm_start)
+    {
+      return continuous_integration_over_polygon_with_diagnostics(
+          f, union_of_buffered_paths(coords_vec, args->get_buffer_radius_m()), args, warm_start);
+    }
+    template<typename FUNC, typename COORDS>
+    double
+    continuous_integration_over_paths(FUNC f, std::vector<COORDS> coords_vec, ContinuousArgs* args, WarmStart* warm_start)
+    {
+      return continuous_integration_over_paths_with_diagnostics(f, coords_vec, args, warm_start).value;
+    }
+
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::Function,
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::Function,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        function::Function,
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*,
+        WarmStart*);
+    template IntegrationResult continuous_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double
+    continuous_integration_over_paths(function::Function, std::vector<geometry::EigenCoords>, ContinuousArgs*, WarmStart*);
+    template double continuous_integration_over_paths(
+        function::Function,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double
+    continuous_integration_over_paths(function::Function, std::vector<geometry::STLCoords>, ContinuousArgs*, WarmStart*);
+    template double continuous_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_paths(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoords>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_paths(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoordsRef>,
+        ContinuousArgs*,
+        WarmStart*);
+    template double continuous_integration_over_paths(
+        double (*)(double, double),
+        std::vector<geometry::STLCoords>,
+        ContinuousArgs*,
+        WarmStart*);
 
     /*****************************************
      * CONTINUOUS INTEGRATION OVER RECTANGLE *
      *****************************************/
 
+    template<typename FUNC>
+    IntegrationResult continuous_integration_over_rectangle_with_diagnostics(
+        FUNC f,
+        double left,
+        double right,
+        double bottom,
+        double top,
+        ContinuousArgs* args)
+    {
+      if constexpr (is_batch_only_v<FUNC>)
+      {
+        std::vector<cubature::Triangle> triangles{ cubature::Triangle{ left, bottom, right, bottom, right, top },
+                                                   cubature::Triangle{ left, bottom, right, top, left, top } };
+        return integrate_batched(f, triangles, args);
+      }
+      else
+      {
+        cubpackpp::REGION_COLLECTION rc;
+        cubpackpp::Point A(left, bottom), B(left, top), C(right, bottom);
+        cubpackpp::RECTANGLE rect(A, B, C);
+        rc += rect;
+
+        IntegrationResult result = continuous_integration_over_region_collections_with_diagnostics(f, rc, args);
+        result.n_regions = 1;
+        return result;
+      }
+    }
     template<typename FUNC>
     double
     continuous_integration_over_rectangle(FUNC f, double left, double right, double bottom, double top, ContinuousArgs* args)
     {
-      cubpackpp::REGION_COLLECTION rc;
-      cubpackpp::Point A(left, bottom), B(left, top), C(right, bottom);
-      cubpackpp::RECTANGLE rect(A, B, C);
-      rc += rect;
-
-      return continuous_integration_over_region_collections(f, rc, args);
+      return continuous_integration_over_rectangle_with_diagnostics(f, left, right, bottom, top, args).value;
     }
-    template double continuous_integration_over_rectangle(
+    template IntegrationResult continuous_integration_over_rectangle_with_diagnostics(
+        function::Function,
+        double,
+        double,
+        double,
+        double,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_rectangle_with_diagnostics(
         environment::MultiModalBivariateGaussian,
         double,
         double,
         double,
         double,
         ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_rectangle_with_diagnostics(
+        double (*)(double, double),
+        double,
+        double,
+        double,
+        double,
+        ContinuousArgs*);
+    template IntegrationResult continuous_integration_over_rectangle_with_diagnostics(
+        function::BatchFunction,
+        double,
+        double,
+        double,
+        double,
+        ContinuousArgs*);
     template double
     continuous_integration_over_rectangle(function::Function, double, double, double, double, ContinuousArgs*);
+    template double continuous_integration_over_rectangle(
+        environment::MultiModalBivariateGaussian,
+        double,
+        double,
+        double,
+        double,
+        ContinuousArgs*);
     template double
     continuous_integration_over_rectangle(double (*)(double, double), double, double, double, double, ContinuousArgs*);
+    template double
+    continuous_integration_over_rectangle(function::BatchFunction, double, double, double, double, ContinuousArgs*);
 
   }  // namespace integration
 }  // namespace jpathgen
\ No newline at end of file
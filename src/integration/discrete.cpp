@@ -6,13 +6,26 @@
 #include <geos/operation/union/UnaryUnionOp.h>
 #include <geos/triangulate/tri/Tri.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <utility>
 
+#include "jpathgen/cubature.h"
+#include "jpathgen/discrete_grid.h"
 #include "jpathgen/environment.h"
+#include "jpathgen/error.h"
 #include "jpathgen/function.h"
 #include "jpathgen/geometry.h"
 #include "jpathgen/geos_compat.h"
 #include "jpathgen/integration.h"
+#include "jpathgen/raster.h"
+#include "jpathgen/trace.h"
 
 using namespace geos::geom;
 using namespace geos::triangulate::tri;
@@ -24,30 +37,628 @@ namespace jpathgen
     /*************************************
      * DISCRETE INTEGRATION OVER POLYGON *
      *************************************/
-    template<typename FUNC>
-    double discrete_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, DiscreteArgs* args)
+
+    namespace
     {
-      double sum = 0;
-      for (auto xi : Eigen::VectorXd::LinSpaced(args->get_N(), args->get_minx(), args->get_maxx()))
-      {
-        for (auto yi : Eigen::VectorXd::LinSpaced(args->get_M(), args->get_miny(), args->get_maxy()))
-        {
-          const geos::geom::Coordinate coord(xi, yi);
-#ifdef GEOS_COMPATIBILITY_REQUIRED
-          geos::geom::Point* pt_ptr = geos::geom::GeometryFactory::getDefaultInstance()->createPoint(coord);
-          std::unique_ptr<geos::geom::Point> pt(pt_ptr);
-#else
-          std::unique_ptr<geos::geom::Point> pt = geos::geom::GeometryFactory::getDefaultInstance()->createPoint(coord);
-#endif
-          if (polygon->contains(pt.get()))
+      // Points along the shorter side of the coarsest sub-grid visited when a deadline is set
+      constexpr int DEADLINE_COARSEST_POINTS = 16;
+
+      // Grid columns per block. The blocks are summed separately and then in order, whatever the number of threads.
+      constexpr int BLOCK_COLUMNS = 8;
+
+      /**
+       * The area each point of the sub-grid on which both indices are multiples of `stride` stands for, i.e. that of a
+       * cell of `stride` times the grid spacing in either direction. Every rule weights its points by it, so that they
+       * agree on the same grid. A single grid point in a direction stands for the whole extent.
+       */
+      double cell_area(const DiscreteArgs& args, int stride)
+      {
+        const double dx = (args.get_maxx() - args.get_minx()) / std::max(1, args.get_N() - 1);
+        const double dy = (args.get_maxy() - args.get_miny()) / std::max(1, args.get_M() - 1);
+        return stride * dx * stride * dy;
+      }
+
+      // The smallest multiple of `stride` that is not less than i
+      int round_up(int i, int stride)
+      {
+        return (i + stride - 1) / stride * stride;
+      }
+
+      // Independent partial sums of strided_sum, enough for the compiler to keep them in one SIMD register
+      constexpr int SUM_LANES = 4;
+
+      /**
+       * Sum of every `step`th of the n values, starting at `offset`. Lane l sums the values l, l + SUM_LANES, ... and
+       * the lanes are added at the end, an order that only depends on n so that sums do not change with the alignment
+       * of `values` as those of Eigen do.
+       */
+      double strided_sum(const double* values, int n, int offset, int step)
+      {
+        const int count = offset < n ? (n - offset + step - 1) / step : 0;
+        values += offset;
+        double lanes[SUM_LANES] = {};
+        int k = 0;
+        for (; k + SUM_LANES <= count; k += SUM_LANES)
+        {
+          for (int l = 0; l < SUM_LANES; l++)
+          {
+            lanes[l] += values[(k + l) * step];
+          }
+        }
+        for (int l = 0; k < count; k++, l++)
+        {
+          lanes[l] += values[k * step];
+        }
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+      }
+
+      int thread_count(const DiscreteArgs* args)
+      {
+        if (args->get_n_threads() > 0)
+        {
+          return args->get_n_threads();
+        }
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+      }
+
+      /**
+       * Run task(k, state) for k = 0, ..., n_tasks - 1 on up to states.size() threads, the calling thread being one of
+       * them. Each thread works on its own state and takes the tasks in increasing order. The first exception thrown by
+       * a task stops the remaining ones and is rethrown once all threads are done.
+       */
+      template<typename STATE, typename TASK>
+      void parallel_for(int n_tasks, std::vector<STATE>& states, TASK task)
+      {
+        std::atomic<int> next{ 0 };
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        auto work = [&](STATE& state)
+        {
+          try
+          {
+            for (int k = next++; k < n_tasks; k = next++)
+            {
+              task(k, state);
+            }
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+            {
+              error = std::current_exception();
+            }
+            next = n_tasks;
+          }
+        };
+
+        std::vector<std::thread> threads;
+        const int n_threads = std::min(static_cast<int>(states.size()), n_tasks);
+        for (int t = 1; t < n_threads; t++)
+        {
+          threads.emplace_back(work, std::ref(states[t]));
+        }
+        work(states[0]);
+        for (std::thread& thread : threads)
+        {
+          thread.join();
+        }
+        if (error)
+        {
+          std::rethrow_exception(error);
+        }
+      }
+
+      /**
+       * The integrand on the grid, `values(i, j_begin, n, step)` being its n values at (xs[i], ys[j_begin]),
+       * (xs[i], ys[j_begin + step]), ... as a contiguous array. A batched FUNC is called once per run of points.
+       * Every thread works on its own copy and FUNC is shared between them, so it must be safe to call concurrently.
+       */
+      template<typename FUNC>
+      class EvaluatedColumn
+      {
+       protected:
+        FUNC* _f;
+        const Eigen::VectorXd* _xs;
+        const Eigen::VectorXd* _ys;
+        std::vector<double> _x, _y, _out;
+
+       public:
+        EvaluatedColumn(FUNC& f, const Eigen::VectorXd& xs, const Eigen::VectorXd& ys) : _f(&f), _xs(&xs), _ys(&ys)
+        {
+        }
+
+        const double* values(int i, int j_begin, int n, int step)
+        {
+          _x.assign(n, (*_xs)[i]);
+          _y.resize(n);
+          _out.resize(n);
+          for (int k = 0; k < n; k++)
+          {
+            _y[k] = (*_ys)[j_begin + k * step];
+          }
+          cubature::evaluate(*_f, _x.data(), _y.data(), _out.data(), n);
+          return _out.data();
+        }
+      };
+
+      /**
+       * The stored values of a DiscreteGrid, in the same form as EvaluatedColumn. Runs of double values are returned in
+       * place, float values are first converted to double.
+       */
+      template<typename T>
+      class StoredColumn
+      {
+       protected:
+        const DiscreteGrid* _grid;
+        const T* _values;
+        std::vector<double> _out;
+
+       public:
+        StoredColumn(const DiscreteGrid& grid, const T* values) : _grid(&grid), _values(values)
+        {
+        }
+
+        const double* values(int i, int j_begin, int n, int step)
+        {
+          const T* column = _values + _grid->index(i, j_begin);
+          if constexpr (std::is_same_v<T, double>)
+          {
+            if (step == 1)
+            {
+              return column;
+            }
+          }
+          _out.resize(n);
+          Eigen::Map<Eigen::VectorXd>(_out.data(), n) =
+              Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>, 0, Eigen::InnerStride<>>(
+                  column, n, Eigen::InnerStride<>(step))
+                  .template cast<double>();
+          return _out.data();
+        }
+      };
+
+      struct BlockSum
+      {
+        double sum = 0, coarse_sum = 0;
+        unsigned long n_evals = 0;
+      };
+
+      /**
+       * Sum over the cells of the grid spacing around the grid points, each weighted by the fraction of it inside the
+       * polygon. The cells the boundary passes through come from the exact coverage of raster::Coverage, the others
+       * are those of the points inside the polygon found by the scanline rasteriser and count in full. The sum of the
+       * same values unweighted, i.e. over the points inside the polygon, is kept in `coarse_sum` for the error
+       * estimate. The blocks and threads are as in sum_over_spans.
+       */
+      template<typename COLUMN>
+      IntegrationResult sum_over_polygon_with_coverage(
+          const COLUMN& column,
+          const Geometry* polygon,
+          const Eigen::VectorXd& xs,
+          const Eigen::VectorXd& ys,
+          const DiscreteArgs* args)
+      {
+        JPATHGEN_TRACE_SCOPE(GRID);
+        const int N = args->get_N(), M = args->get_M();
+        Error(args->get_deadline_s() > 0, "Fractional coverage does not support a deadline");
+        Error(N < 2 || M < 2, "Fractional coverage needs at least two grid points in each direction");
+        const double dx = (args->get_maxx() - args->get_minx()) / (N - 1);
+        const double dy = (args->get_maxy() - args->get_miny()) / (M - 1);
+        const double y_min = args->get_miny() - dy / 2;
+
+        const raster::Scanline scanline(geometry::polygon_rings(polygon));
+        const raster::Coverage coverage(geometry::polygon_rings(polygon, true));
+        const Envelope* envelope = polygon->getEnvelopeInternal();
+        const double* x_end = xs.data() + N;
+        const int i_begin = static_cast<int>(std::upper_bound(xs.data(), x_end, envelope->getMinX() - dx / 2) - xs.data());
+        const int i_end = static_cast<int>(std::lower_bound(xs.data(), x_end, envelope->getMaxX() + dx / 2) - xs.data());
+        const int n_blocks = std::max(0, (i_end - i_begin + BLOCK_COLUMNS - 1) / BLOCK_COLUMNS);
+
+        struct Worker
+        {
+          raster::Scanline scanline;
+          raster::Coverage coverage;
+          COLUMN column;
+        };
+        std::vector<Worker> workers(
+            std::max(1, std::min(thread_count(args), n_blocks)), Worker{ scanline, coverage, column });
+
+        std::vector<BlockSum> blocks(n_blocks);
+        parallel_for(
+            n_blocks,
+            workers,
+            [&](int b, Worker& worker)
+            {
+              BlockSum& block = blocks[b];
+              const int begin = i_begin + b * BLOCK_COLUMNS, end = std::min(i_end, begin + BLOCK_COLUMNS);
+              for (int i = begin; i < end; i++)
+              {
+                const std::vector<raster::PartialCell>& partial =
+                    worker.coverage.partial_cells(xs[i] - dx / 2, xs[i] + dx / 2, y_min, dy, M);
+                const std::vector<raster::Span>& spans = worker.scanline.spans(xs[i], ys.data(), M);
+
+                // The runs of points inside the polygon between the partial cells count in full
+                auto next_partial = partial.begin();
+                for (const raster::Span& span : spans)
+                {
+                  for (int j = span.begin; j < span.end;)
+                  {
+                    while (next_partial != partial.end() && next_partial->j < j)
+                    {
+                      ++next_partial;
+                    }
+                    const int run_end = next_partial == partial.end() ? span.end : std::min(span.end, next_partial->j);
+                    if (run_end > j)
+                    {
+                      const double run_sum = strided_sum(worker.column.values(i, j, run_end - j, 1), run_end - j, 0, 1);
+                      block.sum += run_sum;
+                      block.coarse_sum += run_sum;
+                      block.n_evals += run_end - j;
+                    }
+                    j = run_end + 1;
+                  }
+                }
+
+                // The partial cells, fetched in runs of consecutive cells
+                auto span = spans.begin();
+                for (std::size_t k = 0; k < partial.size();)
+                {
+                  std::size_t k_end = k + 1;
+                  while (k_end < partial.size() && partial[k_end].j == partial[k_end - 1].j + 1)
+                  {
+                    k_end++;
+                  }
+                  const int n = static_cast<int>(k_end - k);
+                  const double* values = worker.column.values(i, partial[k].j, n, 1);
+                  for (int l = 0; l < n; l++)
+                  {
+                    const int j = partial[k + l].j;
+                    block.sum += partial[k + l].coverage * values[l];
+                    while (span != spans.end() && span->end <= j)
+                    {
+                      ++span;
+                    }
+                    if (span != spans.end() && span->begin <= j)
+                    {
+                      block.coarse_sum += values[l];
+                    }
+                  }
+                  block.n_evals += n;
+                  k = k_end;
+                }
+              }
+            });
+
+        IntegrationResult result;
+        double sum = 0, centre_sum = 0;
+        for (const BlockSum& block : blocks)
+        {
+          sum += block.sum;
+          centre_sum += block.coarse_sum;
+          result.n_evals += block.n_evals;
+        }
+        result.value = sum * cell_area(*args, 1);
+        result.error = std::abs(result.value - centre_sum * cell_area(*args, 1));
+        result.n_regions = static_cast<unsigned long>(N) * M;
+        result.termination = Termination::FIXED_BUDGET;
+        return result;
+      }
+
+      /**
+       * The runs of grid points (xs[i], ys[j]) of grid column i inside a polygon, found by the scanline rasteriser.
+       */
+      class PolygonSpans
+      {
+       protected:
+        raster::Scanline _scanline;
+        const Eigen::VectorXd* _xs;
+        const Eigen::VectorXd* _ys;
+
+       public:
+        PolygonSpans(const Geometry* polygon, const Eigen::VectorXd& xs, const Eigen::VectorXd& ys)
+            : _scanline(geometry::polygon_rings(polygon)),
+              _xs(&xs),
+              _ys(&ys)
+        {
+        }
+
+        const std::vector<raster::Span>& spans(int i)
+        {
+          return _scanline.spans((*_xs)[i], _ys->data(), static_cast<int>(_ys->size()));
+        }
+      };
+
+      /**
+       * The runs of grid points of grid column i set in a bitmask.
+       */
+      class MaskSpans
+      {
+       protected:
+        const raster::Bitmask* _mask;
+        std::vector<raster::Span> _spans;
+
+       public:
+        explicit MaskSpans(const raster::Bitmask& mask) : _mask(&mask)
+        {
+        }
+
+        const std::vector<raster::Span>& spans(int i)
+        {
+          return _mask->spans(i, _spans);
+        }
+      };
+
+      /**
+       * Sum the values of `column` over the runs of grid points that `spans` gives on the grid columns [i_begin, i_end),
+       * scaled by the area of a grid cell. The error is estimated as the difference to the same sum over every other
+       * grid point in both directions, i.e. a grid of half the resolution, which costs no additional evaluations.
+       *
+       * No value outside the runs is ever asked for. Each run is fetched from `column` at once and summed by
+       * strided_sum.
+       *
+       * The grid columns are split into blocks of BLOCK_COLUMNS, which are shared out between the threads and summed
+       * separately. Their sums are then added in block order, so the result is the same for any number of threads.
+       *
+       * With a deadline the grid is visited in passes, each halving the stride of the previous one and skipping the
+       * points it already visited, so that after every pass the points so far form a uniform sub-grid. If the deadline
+       * passes during a pass, the value and error of the last complete one are returned. The first pass always
+       * completes.
+       */
+      template<typename COLUMN, typename SPANS>
+      IntegrationResult
+      sum_over_spans(const COLUMN& column, const SPANS& spans, int i_begin, int i_end, const DiscreteArgs* args)
+      {
+        JPATHGEN_TRACE_SCOPE(GRID);
+        const int N = args->get_N(), M = args->get_M();
+        const bool has_deadline = args->get_deadline_s() > 0;
+        const std::chrono::steady_clock::time_point deadline = deadline_after(args->get_deadline_s());
+        const int n_blocks = std::max(0, (i_end - i_begin + BLOCK_COLUMNS - 1) / BLOCK_COLUMNS);
+
+        struct Worker
+        {
+          SPANS spans;
+          COLUMN column;
+        };
+        std::vector<Worker> workers(std::max(1, std::min(thread_count(args), n_blocks)), Worker{ spans, column });
+
+        int stride = 1;
+        while (has_deadline && 2 * stride * DEADLINE_COARSEST_POINTS <= std::min(N, M))
+        {
+          stride *= 2;
+        }
+
+        IntegrationResult result;
+        result.n_regions = static_cast<unsigned long>(N) * M;
+        result.termination = Termination::FIXED_BUDGET;
+
+        double sum = 0;
+        bool first_pass = true;
+        for (; stride >= 1; stride /= 2)
+        {
+          std::vector<BlockSum> blocks(n_blocks);
+          std::atomic<bool> timed_out{ false };
+          const bool check_deadline = has_deadline && !first_pass;
+          parallel_for(
+              n_blocks,
+              workers,
+              [&](int b, Worker& worker)
+              {
+                BlockSum& block = blocks[b];
+                const int begin = i_begin + b * BLOCK_COLUMNS, end = std::min(i_end, begin + BLOCK_COLUMNS);
+                for (int i = round_up(begin, stride); i < end; i += stride)
+                {
+                  if (check_deadline &&
+                      (timed_out.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= deadline))
+                  {
+                    timed_out.store(true, std::memory_order_relaxed);
+                    return;
+                  }
+                  // Points on which both indices are multiples of twice the stride were visited by the previous pass
+                  const bool coarse_column = i % (2 * stride) == 0;
+                  for (const raster::Span& span : worker.spans.spans(i))
+                  {
+                    int j_begin = round_up(span.begin, stride), step = stride;
+                    if (coarse_column && !first_pass)
+                    {
+                      j_begin += j_begin % (2 * stride) == 0 ? stride : 0;
+                      step = 2 * stride;
+                    }
+                    if (j_begin >= span.end)
+                    {
+                      continue;
+                    }
+                    const int n = (span.end - j_begin + step - 1) / step;
+                    const double* values = worker.column.values(i, j_begin, n, step);
+                    block.sum += strided_sum(values, n, 0, 1);
+                    block.n_evals += n;
+                    if (coarse_column && first_pass)
+                    {
+                      block.coarse_sum += strided_sum(values, n, j_begin % (2 * stride) == 0 ? 0 : 1, 2);
+                    }
+                  }
+                }
+              });
+
+          // Sum over the sub-grid of twice the stride, which is everything visited before this pass
+          double coarse_sum = first_pass ? 0 : sum;
+          double pass_sum = sum;
+          for (const BlockSum& block : blocks)
+          {
+            pass_sum += block.sum;
+            coarse_sum += block.coarse_sum;
+            result.n_evals += block.n_evals;
+          }
+          if (timed_out)
           {
-            sum += f(xi, yi);
+            result.termination = Termination::DEADLINE;
+            break;
           }
+          sum = pass_sum;
+          result.value = sum * cell_area(*args, stride);
+          result.error = std::abs(result.value - coarse_sum * cell_area(*args, 2 * stride));
+          first_pass = false;
+        }
+        return result;
+      }
+
+      /**
+       * Sum over the grid points inside the polygon, as sum_over_spans. Only the grid columns within the envelope of the
+       * polygon are visited. With fractional coverage the sum is left to sum_over_polygon_with_coverage.
+       */
+      template<typename COLUMN>
+      IntegrationResult sum_over_polygon(
+          const COLUMN& column,
+          const Geometry* polygon,
+          const Eigen::VectorXd& xs,
+          const Eigen::VectorXd& ys,
+          const DiscreteArgs* args)
+      {
+        if (args->get_fractional_coverage())
+        {
+          return sum_over_polygon_with_coverage(column, polygon, xs, ys, args);
         }
+        const Envelope* envelope = polygon->getEnvelopeInternal();
+        const double* x_end = xs.data() + args->get_N();
+        const int i_begin = static_cast<int>(std::lower_bound(xs.data(), x_end, envelope->getMinX()) - xs.data());
+        const int i_end = static_cast<int>(std::upper_bound(xs.data(), x_end, envelope->getMaxX()) - xs.data());
+        return sum_over_spans(column, PolygonSpans(polygon, xs, ys), i_begin, i_end, args);
+      }
+
+      std::unique_ptr<Geometry> polygon_from_coords(const geometry::STLCoords& polygon)
+      {
+        const geos::geom::GeometryFactory* geometry_factory = geos::geom::GeometryFactory::getDefaultInstance();
+        std::unique_ptr<geos::geom::CoordinateSequence> coordinate_sequence = geometry::coord_sequence_from_array(polygon);
+        std::unique_ptr<geos::geom::LinearRing> linear_ring =
+            geometry_factory->createLinearRing(std::move(coordinate_sequence));
+        return geometry_factory->createPolygon(std::move(linear_ring));
       }
-      return sum * (args->get_maxx() - args->get_minx()) * (args->get_maxy() - args->get_miny()) /
-             (args->get_N() * args->get_M());
+
+      geometry::STLCoords rectangle_coords(double left, double right, double bottom, double top)
+      {
+        return { { left, bottom }, { left, top }, { right, top }, { right, bottom }, { left, bottom } };
+      }
+
+      template<typename COORDS>
+      std::unique_ptr<Geometry> buffered_path(const COORDS& coords, double buffer_radius_m)
+      {
+        std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+        auto ls = geometry::create_linestring(std::move(cs));
+        return geometry::buffer_linestring(std::move(ls), buffer_radius_m);
+      }
+
+      template<typename COORDS>
+      std::unique_ptr<Geometry> union_of_buffered_paths(const std::vector<COORDS>& coords_vec, double buffer_radius_m)
+      {
+        std::unique_ptr<Geometry> union_buffered_paths =
+            geos::geom::GeometryFactory::getDefaultInstance()->createEmptyGeometry();
+        for (auto coords : coords_vec)
+        {
+          std::unique_ptr<geos::geom::Geometry> buffered = buffered_path(coords, buffer_radius_m);
+          {
+            JPATHGEN_TRACE_SCOPE(UNION);
+            union_buffered_paths = union_buffered_paths->Union(buffered.get());
+          }
+        }
+        return union_buffered_paths;
+      }
+
+      /**
+       * The grid points inside any of the buffered paths, without a polygon union. Each path is buffered and rasterised
+       * into the bitmask of the thread it falls to, and the bitmasks of the threads are then OR-ed together. A point
+       * lies in the union exactly when it lies in one of the buffered paths, so these are the points the union would
+       * give, up to those exactly on a boundary.
+       */
+      template<typename COORDS>
+      raster::Bitmask buffered_paths_mask(
+          const std::vector<COORDS>& coords_vec,
+          const Eigen::VectorXd& xs,
+          const Eigen::VectorXd& ys,
+          const DiscreteArgs* args)
+      {
+        const int N = args->get_N(), M = args->get_M();
+        const int n_paths = static_cast<int>(coords_vec.size());
+        std::vector<raster::Bitmask> masks(std::max(1, std::min(thread_count(args), n_paths)), raster::Bitmask(N, M));
+        parallel_for(
+            n_paths,
+            masks,
+            [&](int k, raster::Bitmask& mask)
+            {
+              std::unique_ptr<Geometry> buffered = buffered_path(coords_vec[k], args->get_buffer_radius_m());
+              if (buffered->isEmpty())
+              {
+                return;
+              }
+              JPATHGEN_TRACE_SCOPE(UNION);
+              const Envelope* envelope = buffered->getEnvelopeInternal();
+              const double* x_end = xs.data() + N;
+              const int i_begin = static_cast<int>(std::lower_bound(xs.data(), x_end, envelope->getMinX()) - xs.data());
+              const int i_end = static_cast<int>(std::upper_bound(xs.data(), x_end, envelope->getMaxX()) - xs.data());
+              raster::Scanline scanline(geometry::polygon_rings(buffered.get()));
+              mask.fill(scanline, xs.data(), ys.data(), i_begin, i_end);
+            });
+
+        JPATHGEN_TRACE_SCOPE(UNION);
+        for (std::size_t t = 1; t < masks.size(); t++)
+        {
+          masks[0] |= masks[t];
+        }
+        return std::move(masks[0]);
+      }
+
+      /**
+       * Sum over the grid points inside any of the buffered paths, as sum_over_spans. The exact coverage of fractional
+       * coverage needs the boundary of the union, so then the union is computed and summed over as a polygon.
+       */
+      template<typename COLUMN, typename COORDS>
+      IntegrationResult sum_over_paths(
+          const COLUMN& column,
+          const std::vector<COORDS>& coords_vec,
+          const Eigen::VectorXd& xs,
+          const Eigen::VectorXd& ys,
+          const DiscreteArgs* args)
+      {
+        if (args->get_fractional_coverage())
+        {
+          std::unique_ptr<Geometry> polygon = union_of_buffered_paths(coords_vec, args->get_buffer_radius_m());
+          return sum_over_polygon(column, polygon.get(), xs, ys, args);
+        }
+        const raster::Bitmask mask = buffered_paths_mask(coords_vec, xs, ys, args);
+        return sum_over_spans(column, MaskSpans(mask), mask.column_begin(), mask.column_end(), args);
+      }
+    }  // namespace
+
+    template<typename FUNC>
+    IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        FUNC f,
+        std::unique_ptr<geos::geom::Geometry> polygon,
+        DiscreteArgs* args)
+    {
+      const Eigen::VectorXd xs = Eigen::VectorXd::LinSpaced(args->get_N(), args->get_minx(), args->get_maxx());
+      const Eigen::VectorXd ys = Eigen::VectorXd::LinSpaced(args->get_M(), args->get_miny(), args->get_maxy());
+      return sum_over_polygon(EvaluatedColumn<FUNC>(f, xs, ys), polygon.get(), xs, ys, args);
     }
+    template<typename FUNC>
+    double discrete_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, DiscreteArgs* args)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(f, std::move(polygon), args).value;
+    }
+    template IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        function::Function,
+        std::unique_ptr<geos::geom::Geometry>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::unique_ptr<geos::geom::Geometry>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        double (*)(double, double),
+        std::unique_ptr<geos::geom::Geometry>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        function::BatchFunction,
+        std::unique_ptr<geos::geom::Geometry>,
+        DiscreteArgs*);
     template double
     discrete_integration_over_polygon(function::Function, std::unique_ptr<geos::geom::Geometry>, DiscreteArgs*);
     template double discrete_integration_over_polygon(
@@ -56,89 +667,252 @@ namespace jpathgen
         DiscreteArgs*);
     template double
     discrete_integration_over_polygon(double (*)(double, double), std::unique_ptr<geos::geom::Geometry>, DiscreteArgs*);
+    template double
+    discrete_integration_over_polygon(function::BatchFunction, std::unique_ptr<geos::geom::Geometry>, DiscreteArgs*);
 
+    template<typename FUNC>
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(FUNC f, geometry::STLCoords polygon, DiscreteArgs* args)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(f, polygon_from_coords(polygon), args);
+    }
     template<typename FUNC>
     double discrete_integration_over_polygon(FUNC f, geometry::STLCoords polygon, DiscreteArgs* args)
     {
-      const geos::geom::GeometryFactory* geometry_factory = geos::geom::GeometryFactory::getDefaultInstance();
-      std::unique_ptr<geos::geom::CoordinateSequence> coordinate_sequence = geometry::coord_sequence_from_array(polygon);
-      std::unique_ptr<geos::geom::LinearRing> linear_ring =
-          geometry_factory->createLinearRing(std::move(coordinate_sequence));
-      std::unique_ptr<geos::geom::Polygon> geom = geometry_factory->createPolygon(std::move(linear_ring));
-      return discrete_integration_over_polygon(f, std::move(geom), args);
+      return discrete_integration_over_polygon_with_diagnostics(f, polygon, args).value;
     }
-    template double discrete_integration_over_polygon(function::Function, geometry::STLCoords polygon, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(function::Function, geometry::STLCoords, DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::STLCoords,
+        DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(double (*)(double, double), geometry::STLCoords, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(function::BatchFunction, geometry::STLCoords, DiscreteArgs*);
+    template double discrete_integration_over_polygon(function::Function, geometry::STLCoords, DiscreteArgs*);
     template double
-    discrete_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::STLCoords polygon, DiscreteArgs*);
+    discrete_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::STLCoords, DiscreteArgs*);
+    template double discrete_integration_over_polygon(double (*)(double, double), geometry::STLCoords, DiscreteArgs*);
+    template double discrete_integration_over_polygon(function::BatchFunction, geometry::STLCoords, DiscreteArgs*);
+
+    template<typename FUNC>
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(FUNC f, geometry::EigenCoordsRef polygon, DiscreteArgs* args)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(
+          f, geometry::create_polygon(geometry::coord_sequence_from_array(polygon)), args);
+    }
+    template<typename FUNC>
+    double discrete_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, DiscreteArgs* args)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(f, polygon, args).value;
+    }
+    template IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(function::Function, geometry::EigenCoordsRef, DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoordsRef,
+        DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(double (*)(double, double), geometry::EigenCoordsRef, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(function::BatchFunction, geometry::EigenCoordsRef, DiscreteArgs*);
+    template double discrete_integration_over_polygon(function::Function, geometry::EigenCoordsRef, DiscreteArgs*);
     template double
-    discrete_integration_over_polygon(double (*)(double, double), geometry::STLCoords polygon, DiscreteArgs*);
+    discrete_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, DiscreteArgs*);
+    template double discrete_integration_over_polygon(double (*)(double, double), geometry::EigenCoordsRef, DiscreteArgs*);
+    template double discrete_integration_over_polygon(function::BatchFunction, geometry::EigenCoordsRef, DiscreteArgs*);
     /***************************************
      * DISCRETE INTEGRATION OVER RECTANGLE *
      ***************************************/
     template<typename FUNC>
+    IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        FUNC f,
+        double left,
+        double right,
+        double bottom,
+        double top,
+        DiscreteArgs* args)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(f, rectangle_coords(left, right, bottom, top), args);
+    };
+    template<typename FUNC>
     double
     discrete_integration_over_rectangle(FUNC f, double left, double right, double bottom, double top, DiscreteArgs* args)
     {
-      geometry::STLCoords coords{ { left, bottom }, { left, top }, { right, top }, { right, bottom }, { left, bottom } };
-      return discrete_integration_over_polygon(f, coords, args);
+      return discrete_integration_over_rectangle_with_diagnostics(f, left, right, bottom, top, args).value;
     };
-    template double discrete_integration_over_rectangle(
+    template IntegrationResult
+    discrete_integration_over_rectangle_with_diagnostics(function::Function, double, double, double, double, DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
         environment::MultiModalBivariateGaussian,
         double,
         double,
         double,
         double,
         DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        double (*)(double, double),
+        double,
+        double,
+        double,
+        double,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        function::BatchFunction,
+        double,
+        double,
+        double,
+        double,
+        DiscreteArgs*);
     template double discrete_integration_over_rectangle(function::Function, double, double, double, double, DiscreteArgs*);
+    template double discrete_integration_over_rectangle(
+        environment::MultiModalBivariateGaussian,
+        double,
+        double,
+        double,
+        double,
+        DiscreteArgs*);
     template double
     discrete_integration_over_rectangle(double (*)(double, double), double, double, double, double, DiscreteArgs*);
+    template double
+    discrete_integration_over_rectangle(function::BatchFunction, double, double, double, double, DiscreteArgs*);
 
     /**********************************
      * DISCRETE INTEGRATION OVER PATH *
      **********************************/
     template<typename FUNC, typename COORDS>
+    IntegrationResult discrete_integration_over_path_with_diagnostics(FUNC f, COORDS coords, DiscreteArgs* args)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(f, buffered_path(coords, args->get_buffer_radius_m()), args);
+    }
+    template<typename FUNC, typename COORDS>
     double discrete_integration_over_path(FUNC f, COORDS coords, DiscreteArgs* args)
     {
-      std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
-      auto ls = geometry::create_linestring(std::move(cs));
-      auto buffered = geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
-      return discrete_integration_over_polygon(f, std::move(buffered), args);
+      return discrete_integration_over_path_with_diagnostics(f, coords, args).value;
     }
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(function::Function, geometry::EigenCoords, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(function::Function, geometry::EigenCoordsRef, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(function::Function, geometry::STLCoords, DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoords,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoordsRef,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_path_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        geometry::STLCoords,
+        DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(double (*)(double, double), geometry::EigenCoords, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(function::BatchFunction, geometry::EigenCoords, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(double (*)(double, double), geometry::EigenCoordsRef, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(function::BatchFunction, geometry::EigenCoordsRef, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(double (*)(double, double), geometry::STLCoords, DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(function::BatchFunction, geometry::STLCoords, DiscreteArgs*);
     template double discrete_integration_over_path(function::Function, geometry::EigenCoords, DiscreteArgs*);
+    template double discrete_integration_over_path(function::Function, geometry::EigenCoordsRef, DiscreteArgs*);
     template double discrete_integration_over_path(function::Function, geometry::STLCoords, DiscreteArgs*);
     template double
     discrete_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoords, DiscreteArgs*);
     template double
+    discrete_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, DiscreteArgs*);
+    template double
     discrete_integration_over_path(environment::MultiModalBivariateGaussian, geometry::STLCoords, DiscreteArgs*);
     template double discrete_integration_over_path(double (*)(double, double), geometry::EigenCoords, DiscreteArgs*);
+    template double discrete_integration_over_path(function::BatchFunction, geometry::EigenCoords, DiscreteArgs*);
+    template double discrete_integration_over_path(double (*)(double, double), geometry::EigenCoordsRef, DiscreteArgs*);
+    template double discrete_integration_over_path(function::BatchFunction, geometry::EigenCoordsRef, DiscreteArgs*);
     template double discrete_integration_over_path(double (*)(double, double), geometry::STLCoords, DiscreteArgs*);
+    template double discrete_integration_over_path(function::BatchFunction, geometry::STLCoords, DiscreteArgs*);
 
-    /*************************************
-     * CONTINUOUS INTEGRATION OVER PATHS *
-     *************************************/
+    /***********************************
+     * DISCRETE INTEGRATION OVER PATHS *
+     ***********************************/
 
+    template<typename FUNC, typename COORDS>
+    IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(FUNC f, std::vector<COORDS> coords_vec, DiscreteArgs* args)
+    {
+      const Eigen::VectorXd xs = Eigen::VectorXd::LinSpaced(args->get_N(), args->get_minx(), args->get_maxx());
+      const Eigen::VectorXd ys = Eigen::VectorXd::LinSpaced(args->get_M(), args->get_miny(), args->get_maxy());
+      return sum_over_paths(EvaluatedColumn<FUNC>(f, xs, ys), coords_vec, xs, ys, args);
+    }
     template<typename FUNC, typename COORDS>
     double discrete_integration_over_paths(FUNC f, std::vector<COORDS> coords_vec, DiscreteArgs* args)
     {
-      std::unique_ptr<Geometry> union_buffered_paths =
-          geos::geom::GeometryFactory::getDefaultInstance()->createEmptyGeometry();
-      for (auto coords : coords_vec)
-      {
-        std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
-        auto ls = geometry::create_linestring(std::move(cs));
-        std::unique_ptr<geos::geom::Geometry> buffered =
-            geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
-        union_buffered_paths = union_buffered_paths->Union(buffered.get());
-      }
-      return discrete_integration_over_polygon(f, std::move(union_buffered_paths), args);
+      return discrete_integration_over_paths_with_diagnostics(f, coords_vec, args).value;
     }
 
+    template IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(function::Function, std::vector<geometry::EigenCoords>, DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        function::Function,
+        std::vector<geometry::EigenCoordsRef>,
+        DiscreteArgs*);
+    template IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(function::Function, std::vector<geometry::STLCoords>, DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoords>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::STLCoords>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoords>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        function::BatchFunction,
+        std::vector<geometry::EigenCoords>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::EigenCoordsRef>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        function::BatchFunction,
+        std::vector<geometry::EigenCoordsRef>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        double (*)(double, double),
+        std::vector<geometry::STLCoords>,
+        DiscreteArgs*);
+    template IntegrationResult discrete_integration_over_paths_with_diagnostics(
+        function::BatchFunction,
+        std::vector<geometry::STLCoords>,
+        DiscreteArgs*);
     template double discrete_integration_over_paths(function::Function, std::vector<geometry::EigenCoords>, DiscreteArgs*);
+    template double
+    discrete_integration_over_paths(function::Function, std::vector<geometry::EigenCoordsRef>, DiscreteArgs*);
     template double discrete_integration_over_paths(function::Function, std::vector<geometry::STLCoords>, DiscreteArgs*);
     template double discrete_integration_over_paths(
         environment::MultiModalBivariateGaussian,
         std::vector<geometry::EigenCoords>,
         DiscreteArgs*);
+    template double discrete_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        DiscreteArgs*);
     template double discrete_integration_over_paths(
         environment::MultiModalBivariateGaussian,
         std::vector<geometry::STLCoords>,
@@ -146,6 +920,452 @@ namespace jpathgen
     template double
     discrete_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoords>, DiscreteArgs*);
     template double
+    discrete_integration_over_paths(function::BatchFunction, std::vector<geometry::EigenCoords>, DiscreteArgs*);
+    template double
+    discrete_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoordsRef>, DiscreteArgs*);
+    template double
+    discrete_integration_over_paths(function::BatchFunction, std::vector<geometry::EigenCoordsRef>, DiscreteArgs*);
+    template double
     discrete_integration_over_paths(double (*)(double, double), std::vector<geometry::STLCoords>, DiscreteArgs*);
+    template double
+    discrete_integration_over_paths(function::BatchFunction, std::vector<geometry::STLCoords>, DiscreteArgs*);
+
+    /************************************************
+     * DISCRETE INTEGRATION OVER A PRECOMPUTED GRID *
+     ************************************************/
+
+    DiscreteGrid::DiscreteGrid(const DiscreteArgs& args, std::shared_ptr<const double> values)
+        : _args(args),
+          _xs(Eigen::VectorXd::LinSpaced(args.get_N(), args.get_minx(), args.get_maxx())),
+          _ys(Eigen::VectorXd::LinSpaced(args.get_M(), args.get_miny(), args.get_maxy())),
+          _values(std::move(values)),
+          _single_precision(false)
+    {
+      Error(!_values, "A grid needs its values");
+    }
+
+    DiscreteGrid::DiscreteGrid(const DiscreteArgs& args, std::shared_ptr<const float> values)
+        : _args(args),
+          _xs(Eigen::VectorXd::LinSpaced(args.get_N(), args.get_minx(), args.get_maxx())),
+          _ys(Eigen::VectorXd::LinSpaced(args.get_M(), args.get_miny(), args.get_maxy())),
+          _single_values(std::move(values)),
+          _single_precision(true)
+    {
+      Error(!_single_values, "A grid needs its values");
+    }
+
+    template<typename T, typename FUNC>
+    std::shared_ptr<const T> DiscreteGrid::evaluate(FUNC& f) const
+    {
+      const int N = _args.get_N(), M = _args.get_M();
+      std::shared_ptr<T[]> values(new T[static_cast<std::size_t>(N) * M]);
+
+      // The points of a column share their x and are contiguous in the grid, so double values are written in place
+      struct Worker
+      {
+        std::vector<double> xs, out;
+      };
+      std::vector<Worker> workers(
+          std::max(1, std::min(thread_count(&_args), N)),
+          Worker{ std::vector<double>(M), std::vector<double>(std::is_same_v<T, double> ? 0 : M) });
+      parallel_for(
+          N,
+          workers,
+          [&](int i, Worker& worker)
+          {
+            std::fill(worker.xs.begin(), worker.xs.end(), _xs[i]);
+            T* column = values.get() + index(i, 0);
+            if constexpr (std::is_same_v<T, double>)
+            {
+              cubature::evaluate(f, worker.xs.data(), _ys.data(), column, M);
+            }
+            else
+            {
+              cubature::evaluate(f, worker.xs.data(), _ys.data(), worker.out.data(), M);
+              std::transform(
+                  worker.out.begin(), worker.out.end(), column, [](double value) { return static_cast<T>(value); });
+            }
+          });
+      return std::shared_ptr<const T>(values, values.get());
+    }
+
+    template<typename FUNC>
+    DiscreteGrid::DiscreteGrid(FUNC f, const DiscreteArgs& args, bool single_precision)
+        : _args(args),
+          _xs(Eigen::VectorXd::LinSpaced(args.get_N(), args.get_minx(), args.get_maxx())),
+          _ys(Eigen::VectorXd::LinSpaced(args.get_M(), args.get_miny(), args.get_maxy())),
+          _single_precision(single_precision)
+    {
+      if (_single_precision)
+      {
+        _single_values = evaluate<float>(f);
+      }
+      else
+      {
+        _values = evaluate<double>(f);
+      }
+    }
+    template DiscreteGrid::DiscreteGrid(environment::MultiModalBivariateGaussian, const DiscreteArgs&, bool);
+    template DiscreteGrid::DiscreteGrid(function::Function, const DiscreteArgs&, bool);
+    template DiscreteGrid::DiscreteGrid(function::BatchFunction, const DiscreteArgs&, bool);
+    template DiscreteGrid::DiscreteGrid(double (*)(double, double), const DiscreteArgs&, bool);
+
+    IntegrationResult discrete_integration_over_polygon_with_diagnostics(
+        const DiscreteGrid& grid,
+        std::unique_ptr<geos::geom::Geometry> polygon)
+    {
+      if (grid.is_single_precision())
+      {
+        StoredColumn<float> column(grid, grid.single_data());
+        return sum_over_polygon(column, polygon.get(), grid.get_xs(), grid.get_ys(), &grid.get_args());
+      }
+      StoredColumn<double> column(grid, grid.data());
+      return sum_over_polygon(column, polygon.get(), grid.get_xs(), grid.get_ys(), &grid.get_args());
+    }
+    double discrete_integration_over_polygon(const DiscreteGrid& grid, std::unique_ptr<geos::geom::Geometry> polygon)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(grid, std::move(polygon)).value;
+    }
+
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(const DiscreteGrid& grid, geometry::STLCoords polygon)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(grid, polygon_from_coords(polygon));
+    }
+    double discrete_integration_over_polygon(const DiscreteGrid& grid, geometry::STLCoords polygon)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(grid, std::move(polygon)).value;
+    }
+
+    IntegrationResult
+    discrete_integration_over_polygon_with_diagnostics(const DiscreteGrid& grid, geometry::EigenCoordsRef polygon)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(
+          grid, geometry::create_polygon(geometry::coord_sequence_from_array(polygon)));
+    }
+    double discrete_integration_over_polygon(const DiscreteGrid& grid, geometry::EigenCoordsRef polygon)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(grid, polygon).value;
+    }
+
+    IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        const DiscreteGrid& grid,
+        double left,
+        double right,
+        double bottom,
+        double top)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(grid, rectangle_coords(left, right, bottom, top));
+    }
+    double
+    discrete_integration_over_rectangle(const DiscreteGrid& grid, double left, double right, double bottom, double top)
+    {
+      return discrete_integration_over_rectangle_with_diagnostics(grid, left, right, bottom, top).value;
+    }
+
+    template<typename COORDS>
+    IntegrationResult discrete_integration_over_path_with_diagnostics(const DiscreteGrid& grid, COORDS coords)
+    {
+      return discrete_integration_over_polygon_with_diagnostics(
+          grid, buffered_path(coords, grid.get_args().get_buffer_radius_m()));
+    }
+    template<typename COORDS>
+    double discrete_integration_over_path(const DiscreteGrid& grid, COORDS coords)
+    {
+      return discrete_integration_over_path_with_diagnostics(grid, coords).value;
+    }
+    template IntegrationResult discrete_integration_over_path_with_diagnostics(const DiscreteGrid&, geometry::EigenCoords);
+    template IntegrationResult
+    discrete_integration_over_path_with_diagnostics(const DiscreteGrid&, geometry::EigenCoordsRef);
+    template IntegrationResult discrete_integration_over_path_with_diagnostics(const DiscreteGrid&, geometry::STLCoords);
+    template double discrete_integration_over_path(const DiscreteGrid&, geometry::EigenCoords);
+    template double discrete_integration_over_path(const DiscreteGrid&, geometry::EigenCoordsRef);
+    template double discrete_integration_over_path(const DiscreteGrid&, geometry::STLCoords);
+
+    template<typename COORDS>
+    IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(const DiscreteGrid& grid, std::vector<COORDS> coords_vec)
+    {
+      if (grid.is_single_precision())
+      {
+        StoredColumn<float> column(grid, grid.single_data());
+        return sum_over_paths(column, coords_vec, grid.get_xs(), grid.get_ys(), &grid.get_args());
+      }
+      StoredColumn<double> column(grid, grid.data());
+      return sum_over_paths(column, coords_vec, grid.get_xs(), grid.get_ys(), &grid.get_args());
+    }
+    template<typename COORDS>
+    double discrete_integration_over_paths(const DiscreteGrid& grid, std::vector<COORDS> coords_vec)
+    {
+      return discrete_integration_over_paths_with_diagnostics(grid, coords_vec).value;
+    }
+    template IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(const DiscreteGrid&, std::vector<geometry::EigenCoords>);
+    template IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(const DiscreteGrid&, std::vector<geometry::EigenCoordsRef>);
+    template IntegrationResult
+    discrete_integration_over_paths_with_diagnostics(const DiscreteGrid&, std::vector<geometry::STLCoords>);
+    template double discrete_integration_over_paths(const DiscreteGrid&, std::vector<geometry::EigenCoords>);
+    template double discrete_integration_over_paths(const DiscreteGrid&, std::vector<geometry::EigenCoordsRef>);
+    template double discrete_integration_over_paths(const DiscreteGrid&, std::vector<geometry::STLCoords>);
+
+    /*************************
+     * SUMMED-AREA RECTANGLE *
+     *************************/
+
+    namespace
+    {
+      // (N + 1) by (M + 1) table whose entry (i, j) is the sum of value_at(i', j') over i' < i and j' < j
+      template<typename VALUE>
+      std::vector<double> summed_area(VALUE value_at, int N, int M)
+      {
+        const std::size_t stride = M + 1;
+        std::vector<double> sums((N + 1) * stride, 0.0);
+        for (int i = 0; i < N; i++)
+        {
+          double column_sum = 0;
+          for (int j = 0; j < M; j++)
+          {
+            column_sum += value_at(i, j);
+            sums[(i + 1) * stride + j + 1] = sums[i * stride + j + 1] + column_sum;
+          }
+        }
+        return sums;
+      }
+
+      std::shared_ptr<const double> share(std::vector<double> values)
+      {
+        auto owner = std::make_shared<std::vector<double>>(std::move(values));
+        return std::shared_ptr<const double>(owner, owner->data());
+      }
+
+      double rectangle_sum(const double* sums, int M, int i_begin, int i_end, int j_begin, int j_end)
+      {
+        const std::size_t stride = M + 1;
+        return sums[i_end * stride + j_end] - sums[i_begin * stride + j_end] - sums[i_end * stride + j_begin] +
+               sums[i_begin * stride + j_begin];
+      }
+
+      struct CoveredCells
+      {
+        int begin, end;
+        double weight;
+      };
+
+      /**
+       * The cells [first + (k - 1/2) spacing, first + (k + 1/2) spacing] around the n grid points of an axis that
+       * overlap [lo, hi], in runs covered by the same fraction: the partially covered cell at either end and the fully
+       * covered cells between them.
+       */
+      std::vector<CoveredCells> covered_cells(double lo, double hi, double first, double spacing, int n)
+      {
+        // In units of cells, cell k spanning [k, k + 1]
+        const double u_lo = std::clamp((lo - first) / spacing + 0.5, 0.0, static_cast<double>(n));
+        const double u_hi = std::clamp((hi - first) / spacing + 0.5, 0.0, static_cast<double>(n));
+        std::vector<CoveredCells> cells;
+        if (u_hi <= u_lo)
+        {
+          return cells;
+        }
+        const int k_lo = std::min(static_cast<int>(u_lo), n - 1), k_hi = std::min(static_cast<int>(u_hi), n - 1);
+        if (k_lo == k_hi)
+        {
+          cells.push_back(CoveredCells{ k_lo, k_lo + 1, u_hi - u_lo });
+          return cells;
+        }
+        cells.push_back(CoveredCells{ k_lo, k_lo + 1, k_lo + 1 - u_lo });
+        if (k_hi > k_lo + 1)
+        {
+          cells.push_back(CoveredCells{ k_lo + 1, k_hi, 1 });
+        }
+        if (u_hi > k_hi)
+        {
+          cells.push_back(CoveredCells{ k_hi, k_hi + 1, u_hi - k_hi });
+        }
+        return cells;
+      }
+    }  // namespace
+
+    SummedAreaTable::SummedAreaTable(const DiscreteGrid& grid)
+        : _args(grid.get_args()),
+          _xs(grid.get_xs()),
+          _ys(grid.get_ys())
+    {
+      const int N = _args.get_N(), M = _args.get_M();
+      _sums = share(summed_area([&grid](int i, int j) { return grid.value(i, j); }, N, M));
+      _coarse_sums =
+          share(summed_area([&grid](int i, int j) { return grid.value(2 * i, 2 * j); }, (N + 1) / 2, (M + 1) / 2));
+    }
+
+    SummedAreaTable::SummedAreaTable(
+        const DiscreteArgs& args,
+        std::shared_ptr<const double> sums,
+        std::shared_ptr<const double> coarse_sums)
+        : _args(args),
+          _xs(Eigen::VectorXd::LinSpaced(args.get_N(), args.get_minx(), args.get_maxx())),
+          _ys(Eigen::VectorXd::LinSpaced(args.get_M(), args.get_miny(), args.get_maxy())),
+          _sums(std::move(sums)),
+          _coarse_sums(std::move(coarse_sums))
+    {
+      Error(!_sums || !_coarse_sums, "A summed-area table needs both tables");
+    }
+
+    double SummedAreaTable::sum(int i_begin, int i_end, int j_begin, int j_end) const
+    {
+      return rectangle_sum(_sums.get(), _args.get_M(), i_begin, i_end, j_begin, j_end);
+    }
+
+    double SummedAreaTable::coarse_sum(int i_begin, int i_end, int j_begin, int j_end) const
+    {
+      // Index k of the coarse table is grid index 2k, so the even indices in [begin, end) are [(begin + 1) / 2, ...)
+      return rectangle_sum(
+          _coarse_sums.get(),
+          (_args.get_M() + 1) / 2,
+          (i_begin + 1) / 2,
+          (i_end + 1) / 2,
+          (j_begin + 1) / 2,
+          (j_end + 1) / 2);
+    }
+
+    IntegrationResult discrete_integration_over_rectangle_with_diagnostics(
+        const SummedAreaTable& table,
+        double left,
+        double right,
+        double bottom,
+        double top)
+    {
+      const DiscreteArgs& args = table.get_args();
+      const int N = args.get_N(), M = args.get_M();
+      if (right < left)
+      {
+        std::swap(left, right);
+      }
+      if (top < bottom)
+      {
+        std::swap(bottom, top);
+      }
+
+      // As for the scanline rasteriser, grid points on any edge of the rectangle are out
+      const double* xs = table.get_xs().data();
+      const double* ys = table.get_ys().data();
+      const int i_begin = static_cast<int>(std::upper_bound(xs, xs + N, left) - xs);
+      const int i_end = std::max(i_begin, static_cast<int>(std::lower_bound(xs, xs + N, right) - xs));
+      const int j_begin = static_cast<int>(std::upper_bound(ys, ys + M, bottom) - ys);
+      const int j_end = std::max(j_begin, static_cast<int>(std::lower_bound(ys, ys + M, top) - ys));
+
+      IntegrationResult result;
+      result.n_regions = static_cast<unsigned long>(N) * M;
+      result.termination = Termination::FIXED_BUDGET;
+      if (args.get_fractional_coverage())
+      {
+        // The coverage of a cell by a rectangle is that of its column times that of its row
+        Error(N < 2 || M < 2, "Fractional coverage needs at least two grid points in each direction");
+        const double dx = (args.get_maxx() - args.get_minx()) / (N - 1);
+        const double dy = (args.get_maxy() - args.get_miny()) / (M - 1);
+        double sum = 0;
+        for (const CoveredCells& columns : covered_cells(left, right, xs[0], dx, N))
+        {
+          for (const CoveredCells& rows : covered_cells(bottom, top, ys[0], dy, M))
+          {
+            sum += columns.weight * rows.weight * table.sum(columns.begin, columns.end, rows.begin, rows.end);
+            result.n_evals += static_cast<unsigned long>(columns.end - columns.begin) * (rows.end - rows.begin);
+          }
+        }
+        result.value = sum * cell_area(args, 1);
+        result.error = std::abs(result.value - table.sum(i_begin, i_end, j_begin, j_end) * cell_area(args, 1));
+        return result;
+      }
+      result.value = table.sum(i_begin, i_end, j_begin, j_end) * cell_area(args, 1);
+      double coarse_value = table.coarse_sum(i_begin, i_end, j_begin, j_end) * cell_area(args, 2);
+      result.error = std::abs(result.value - coarse_value);
+      result.n_evals = static_cast<unsigned long>(i_end - i_begin) * (j_end - j_begin);
+      return result;
+    }
+    double
+    discrete_integration_over_rectangle(const SummedAreaTable& table, double left, double right, double bottom, double top)
+    {
+      return discrete_integration_over_rectangle_with_diagnostics(table, left, right, bottom, top).value;
+    }
+
+    Eigen::VectorXd discrete_integration_over_rectangles(const SummedAreaTable& table, const Rectangles& rectangles)
+    {
+      Eigen::VectorXd values(rectangles.rows());
+      for (Eigen::Index k = 0; k < rectangles.rows(); k++)
+      {
+        values[k] = discrete_integration_over_rectangle(
+            table, rectangles(k, 0), rectangles(k, 1), rectangles(k, 2), rectangles(k, 3));
+      }
+      return values;
+    }
+
+    /********************
+     * COVERAGE TRACKER *
+     ********************/
+
+    void CoverageTracker::check_args() const
+    {
+      Error(_args.get_fractional_coverage(), "The coverage tracker does not support fractional coverage");
+    }
+
+    template<typename COORDS>
+    double CoverageTracker::step(COORDS segment)
+    {
+      std::unique_ptr<Geometry> buffered = buffered_path(segment, _args.get_buffer_radius_m());
+      if (buffered->isEmpty())
+      {
+        return 0;
+      }
+      JPATHGEN_TRACE_SCOPE(GRID);
+      const int N = _args.get_N(), M = _args.get_M();
+      const Envelope* envelope = buffered->getEnvelopeInternal();
+      const double* x_end = _xs.data() + N;
+      const int i_begin = static_cast<int>(std::lower_bound(_xs.data(), x_end, envelope->getMinX()) - _xs.data());
+      const int i_end = static_cast<int>(std::upper_bound(_xs.data(), x_end, envelope->getMaxX()) - _xs.data());
+      raster::Scanline scanline(geometry::polygon_rings(buffered.get()));
+
+      double sum = 0;
+      for (int i = i_begin; i < i_end; i++)
+      {
+        for (const raster::Span& span : scanline.spans(_xs[i], _ys.data(), M))
+        {
+          // The runs of points in the span not covered before
+          for (int j = span.begin; j < span.end;)
+          {
+            if (_visited.test(i, j))
+            {
+              j++;
+              continue;
+            }
+            int run_end = j + 1;
+            while (run_end < span.end && !_visited.test(i, run_end))
+            {
+              run_end++;
+            }
+            const int n = run_end - j;
+            _x.assign(n, _xs[i]);
+            _y.assign(_ys.data() + j, _ys.data() + run_end);
+            _out.resize(n);
+            _f(_x.data(), _y.data(), _out.data(), n);
+            sum += strided_sum(_out.data(), n, 0, 1);
+            _visited.set(i, j, run_end);
+            _n_evals += n;
+            j = run_end;
+          }
+        }
+      }
+      const double value = sum * cell_area(_args, 1);
+      _value += value;
+      return value;
+    }
+    template double CoverageTracker::step(geometry::EigenCoords);
+    template double CoverageTracker::step(geometry::EigenCoordsRef);
+    template double CoverageTracker::step(geometry::STLCoords);
+
+    void CoverageTracker::reset()
+    {
+      _visited.clear();
+      _value = 0;
+      _n_evals = 0;
+    }
   }  // namespace integration
-}  // namespace jpathgen
\ No newline at end of file
+}  // namespace jpathgen
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <geos/geom/Coordinate.h>
+
+#include <utility>
+
+#include "jpathgen/cubature.h"
+#include "jpathgen/environment.h"
+#include "jpathgen/function.h"
+#include "jpathgen/geometry.h"
+#include "jpathgen/geos_compat.h"
+#include "jpathgen/integration.h"
+#include "jpathgen/trace.h"
+
+using namespace geos::geom;
+
+namespace jpathgen
+{
+  namespace integration
+  {
+    /**********************************
+     * FIXED INTEGRATION OVER POLYGON *
+     **********************************/
+
+    template<typename FUNC>
+    IntegrationResult fixed_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, FixedArgs* args)
+    {
+      auto triangulated = geometry::triangulate_polygon(std::move(polygon));
+      std::vector<cubature::Triangle> triangles = geometry::geos_to_triangles(std::move(triangulated));
+      return cubature::integrate_fixed(f, std::move(triangles), args->get_refinement());
+    }
+    template IntegrationResult
+    fixed_integration_over_polygon(function::Function, std::unique_ptr<geos::geom::Geometry>, FixedArgs*);
+    template IntegrationResult fixed_integration_over_polygon(
+        environment::MultiModalBivariateGaussian,
+        std::unique_ptr<geos::geom::Geometry>,
+        FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_polygon(double (*)(double, double), std::unique_ptr<geos::geom::Geometry>, FixedArgs*);
+
+    template<typename FUNC>
+    IntegrationResult fixed_integration_over_polygon(FUNC f, geometry::STLCoords polygon, FixedArgs* args)
+    {
+      const geos::geom::GeometryFactory* geometry_factory = geos::geom::GeometryFactory::getDefaultInstance();
+
+      std::unique_ptr<geos::geom::CoordinateSequence> coordinate_sequence = geometry::coord_sequence_from_array(polygon);
+      std::unique_ptr<geos::geom::LinearRing> linear_ring =
+          geometry_factory->createLinearRing(std::move(coordinate_sequence));
+      std::unique_ptr<geos::geom::Polygon> geom = geometry_factory->createPolygon(std::move(linear_ring));
+      return fixed_integration_over_polygon(f, std::move(geom), args);
+    }
+    template IntegrationResult fixed_integration_over_polygon(function::Function, geometry::STLCoords, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::STLCoords, FixedArgs*);
+    template IntegrationResult fixed_integration_over_polygon(double (*)(double, double), geometry::STLCoords, FixedArgs*);
+
+    template<typename FUNC>
+    IntegrationResult fixed_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, FixedArgs* args)
+    {
+      return fixed_integration_over_polygon(
+          f, geometry::create_polygon(geometry::coord_sequence_from_array(polygon)), args);
+    }
+    template IntegrationResult fixed_integration_over_polygon(function::Function, geometry::EigenCoordsRef, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_polygon(double (*)(double, double), geometry::EigenCoordsRef, FixedArgs*);
+
+    /*******************************
+     * FIXED INTEGRATION OVER PATH *
+     *******************************/
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult fixed_integration_over_path(FUNC f, COORDS coords, FixedArgs* args)
+    {
+      std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+      auto ls = geometry::create_linestring(std::move(cs));
+      auto buffered = geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+      return fixed_integration_over_polygon(f, std::move(buffered), args);
+    }
+    template IntegrationResult fixed_integration_over_path(function::Function, geometry::EigenCoords, FixedArgs*);
+    template IntegrationResult fixed_integration_over_path(function::Function, geometry::EigenCoordsRef, FixedArgs*);
+    template IntegrationResult fixed_integration_over_path(function::Function, geometry::STLCoords, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoords, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_path(environment::MultiModalBivariateGaussian, geometry::STLCoords, FixedArgs*);
+    template IntegrationResult fixed_integration_over_path(double (*)(double, double), geometry::EigenCoords, FixedArgs*);
+    template IntegrationResult fixed_integration_over_path(double (*)(double, double), geometry::EigenCoordsRef, FixedArgs*);
+    template IntegrationResult fixed_integration_over_path(double (*)(double, double), geometry::STLCoords, FixedArgs*);
+
+    /********************************
+     * FIXED INTEGRATION OVER PATHS *
+     ********************************/
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult fixed_integration_over_paths(FUNC f, std::vector<COORDS> coords_vec, FixedArgs* args)
+    {
+      std::unique_ptr<Geometry> union_buffered_paths =
+          geos::geom::GeometryFactory::getDefaultInstance()->createEmptyGeometry();
+      for (auto coords : coords_vec)
+      {
+        std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+        auto ls = geometry::create_linestring(std::move(cs));
+        std::unique_ptr<geos::geom::Geometry> buffered =
+            geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+        {
+          JPATHGEN_TRACE_SCOPE(UNION);
+          union_buffered_paths = union_buffered_paths->Union(buffered.get());
+        }
+      }
+      return fixed_integration_over_polygon(f, std::move(union_buffered_paths), args);
+    }
+    template IntegrationResult
+    fixed_integration_over_paths(function::Function, std::vector<geometry::EigenCoords>, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_paths(function::Function, std::vector<geometry::EigenCoordsRef>, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_paths(function::Function, std::vector<geometry::STLCoords>, FixedArgs*);
+    template IntegrationResult fixed_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoords>,
+        FixedArgs*);
+    template IntegrationResult fixed_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_paths(environment::MultiModalBivariateGaussian, std::vector<geometry::STLCoords>, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoords>, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoordsRef>, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_paths(double (*)(double, double), std::vector<geometry::STLCoords>, FixedArgs*);
+
+    /************************************
+     * FIXED INTEGRATION OVER RECTANGLE *
+     ************************************/
+
+    template<typename FUNC>
+    IntegrationResult
+    fixed_integration_over_rectangle(FUNC f, double left, double right, double bottom, double top, FixedArgs* args)
+    {
+      std::vector<cubature::Triangle> triangles{ cubature::Triangle{ left, bottom, right, bottom, right, top },
+                                                 cubature::Triangle{ left, bottom, right, top, left, top } };
+      return cubature::integrate_fixed(f, std::move(triangles), args->get_refinement());
+    }
+    template IntegrationResult fixed_integration_over_rectangle(
+        environment::MultiModalBivariateGaussian,
+        double,
+        double,
+        double,
+        double,
+        FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_rectangle(function::Function, double, double, double, double, FixedArgs*);
+    template IntegrationResult
+    fixed_integration_over_rectangle(double (*)(double, double), double, double, double, double, FixedArgs*);
+
+  }  // namespace integration
+}  // namespace jpathgen
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <geos/geom/Coordinate.h>
+
+#include <utility>
+
+#include "jpathgen/environment.h"
+#include "jpathgen/function.h"
+#include "jpathgen/geometry.h"
+#include "jpathgen/geos_compat.h"
+#include "jpathgen/gradient.h"
+#include "jpathgen/integration.h"
+
+using namespace geos::geom;
+
+namespace jpathgen
+{
+  namespace integration
+  {
+    namespace
+    {
+      gradient::Waypoints to_waypoints(const geometry::EigenCoords& coords)
+      {
+        return coords;
+      }
+
+      gradient::Waypoints to_waypoints(const geometry::STLCoords& coords)
+      {
+        gradient::Waypoints waypoints(coords.size(), 2);
+        for (std::size_t i = 0; i < coords.size(); i++)
+        {
+          waypoints(i, 0) = coords[i].first;
+          waypoints(i, 1) = coords[i].second;
+        }
+        return waypoints;
+      }
+    }  // namespace
+
+    /*************************************************
+     * CONTINUOUS INTEGRATION OVER PATH WITH GRADIENT *
+     *************************************************/
+
+    template<typename FUNC, typename COORDS>
+    ValueAndGradient continuous_integration_over_path_with_gradient(FUNC f, COORDS coords, ContinuousArgs* args)
+    {
+      std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+      auto ls = geometry::create_linestring(std::move(cs));
+      auto buffered = geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+
+      double radius = args->get_buffer_radius_m();
+      std::vector<gradient::Ring> rings = geometry::polygon_rings(buffered.get());
+      geometry::EigenCoords grad = gradient::boundary_gradient(f, rings, to_waypoints(coords), radius, radius / 8);
+
+      double value = continuous_integration_over_polygon(f, std::move(buffered), args);
+      return { value, grad };
+    }
+    template ValueAndGradient
+    continuous_integration_over_path_with_gradient(function::Function, geometry::EigenCoords, ContinuousArgs*);
+    template ValueAndGradient
+    continuous_integration_over_path_with_gradient(function::Function, geometry::EigenCoordsRef, ContinuousArgs*);
+    template ValueAndGradient
+    continuous_integration_over_path_with_gradient(function::Function, geometry::STLCoords, ContinuousArgs*);
+    template ValueAndGradient continuous_integration_over_path_with_gradient(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoords,
+        ContinuousArgs*);
+    template ValueAndGradient continuous_integration_over_path_with_gradient(
+        environment::MultiModalBivariateGaussian,
+        geometry::EigenCoordsRef,
+        ContinuousArgs*);
+    template ValueAndGradient continuous_integration_over_path_with_gradient(
+        environment::MultiModalBivariateGaussian,
+        geometry::STLCoords,
+        ContinuousArgs*);
+    template ValueAndGradient
+    continuous_integration_over_path_with_gradient(double (*)(double, double), geometry::EigenCoords, ContinuousArgs*);
+    template ValueAndGradient
+    continuous_integration_over_path_with_gradient(double (*)(double, double), geometry::EigenCoordsRef, ContinuousArgs*);
+    template ValueAndGradient
+    continuous_integration_over_path_with_gradient(double (*)(double, double), geometry::STLCoords, ContinuousArgs*);
+
+  }  // namespace integration
+}  // namespace jpathgen
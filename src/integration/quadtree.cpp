@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <geos/geom/Coordinate.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "jpathgen/cubature.h"
+#include "jpathgen/environment.h"
+#include "jpathgen/function.h"
+#include "jpathgen/geometry.h"
+#include "jpathgen/geos_compat.h"
+#include "jpathgen/integration.h"
+#include "jpathgen/trace.h"
+
+using namespace geos::geom;
+
+namespace jpathgen
+{
+  namespace integration
+  {
+    namespace
+    {
+      struct Edge
+      {
+        double ax, ay, bx, by;
+      };
+
+      // Twice the signed area of the triangle (a, b, c), positive if it turns counter-clockwise
+      double orientation(double ax, double ay, double bx, double by, double cx, double cy)
+      {
+        return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+      }
+
+      // Whether the segment from p to q crosses the edge. Points on a line count as being on its right.
+      bool crosses(const Edge& e, double px, double py, double qx, double qy)
+      {
+        return (orientation(e.ax, e.ay, e.bx, e.by, px, py) > 0) != (orientation(e.ax, e.ay, e.bx, e.by, qx, qy) > 0) &&
+               (orientation(px, py, qx, qy, e.ax, e.ay) > 0) != (orientation(px, py, qx, qy, e.bx, e.by) > 0);
+      }
+
+      // Whether the edge may pass through the interior of the rectangle [x0, x1] x [y0, y1]
+      bool touches(const Edge& e, double x0, double y0, double x1, double y1)
+      {
+        if (std::max(e.ax, e.bx) <= x0 || std::min(e.ax, e.bx) >= x1 || std::max(e.ay, e.by) <= y0 ||
+            std::min(e.ay, e.by) >= y1)
+        {
+          return false;
+        }
+        bool left = false, right = false;
+        for (auto [x, y] : { std::pair{ x0, y0 }, std::pair{ x1, y0 }, std::pair{ x1, y1 }, std::pair{ x0, y1 } })
+        {
+          const double side = orientation(e.ax, e.ay, e.bx, e.by, x, y);
+          left = left || side > 0;
+          right = right || side < 0;
+        }
+        return left && right;
+      }
+
+      // Crossing number test of a horizontal ray from (x, y)
+      bool inside(const std::vector<Edge>& edges, double x, double y)
+      {
+        bool in = false;
+        for (const Edge& e : edges)
+        {
+          if ((e.ay > y) != (e.by > y) && x < e.ax + (y - e.ay) * (e.bx - e.ax) / (e.by - e.ay))
+          {
+            in = !in;
+          }
+        }
+        return in;
+      }
+
+      struct Cell
+      {
+        double x0, y0, x1, y1;
+        int depth;
+        double centre_value;
+        bool centre_inside;
+        // The edges that may pass through the cell, which are all those a segment within it can cross
+        std::vector<std::size_t> edges;
+      };
+
+      // A cell of the quadtree that has not been split, with its children evaluated for when it is
+      struct Leaf
+      {
+        Cell cell;
+        double value, error;
+        std::vector<Cell> children;
+      };
+
+      // Cells shallower than the minimum depth are split first, and then the one with the largest error estimate
+      struct SplitFirst
+      {
+        int min_depth;
+
+        bool operator()(const Leaf& a, const Leaf& b) const
+        {
+          const bool a_shallow = a.cell.depth < min_depth, b_shallow = b.cell.depth < min_depth;
+          return a_shallow != b_shallow ? b_shallow : a.error < b.error;
+        }
+      };
+
+      /**
+       * The value of a cell is the centre rule on its four children, and its error estimate the difference to the
+       * centre rule on the cell itself. The boundary may put up to about a quarter of a cell it passes through on the
+       * wrong side, so the error estimate of such a cell is at least the largest value of a quarter. Children entirely
+       * outside the polygon are dropped without evaluating f. Whether the centre of a child is inside is found from the
+       * centre of the cell by the parity of the edges crossed in between.
+       */
+      template<typename FUNC>
+      Leaf evaluate(FUNC& f, const std::vector<Edge>& edges, Cell cell, unsigned long& n_evals)
+      {
+        const double xm = (cell.x0 + cell.x1) / 2, ym = (cell.y0 + cell.y1) / 2;
+        const double area = (cell.x1 - cell.x0) * (cell.y1 - cell.y0);
+        double xs[4], ys[4], values[4];
+        std::vector<Cell> children;
+        for (int k = 0; k < 4; k++)
+        {
+          Cell child;
+          child.x0 = k % 2 == 0 ? cell.x0 : xm;
+          child.x1 = k % 2 == 0 ? xm : cell.x1;
+          child.y0 = k < 2 ? cell.y0 : ym;
+          child.y1 = k < 2 ? ym : cell.y1;
+          child.depth = cell.depth + 1;
+          child.centre_value = 0;
+          child.centre_inside = cell.centre_inside;
+          const double cx = (child.x0 + child.x1) / 2, cy = (child.y0 + child.y1) / 2;
+          for (std::size_t e : cell.edges)
+          {
+            if (crosses(edges[e], xm, ym, cx, cy))
+            {
+              child.centre_inside = !child.centre_inside;
+            }
+            if (touches(edges[e], child.x0, child.y0, child.x1, child.y1))
+            {
+              child.edges.push_back(e);
+            }
+          }
+          if (child.centre_inside || !child.edges.empty())
+          {
+            xs[children.size()] = cx;
+            ys[children.size()] = cy;
+            children.push_back(std::move(child));
+          }
+        }
+        cubature::evaluate(f, xs, ys, values, children.size());
+        n_evals += children.size();
+
+        double fine = 0, largest = 0;
+        for (std::size_t k = 0; k < children.size(); k++)
+        {
+          children[k].centre_value = values[k];
+          largest = std::max(largest, std::abs(values[k]));
+          if (children[k].centre_inside)
+          {
+            fine += values[k];
+          }
+        }
+        const double value = fine * area / 4;
+        double error = std::abs(value - (cell.centre_inside ? cell.centre_value * area : 0));
+        if (!cell.edges.empty())
+        {
+          error = std::max(error, largest * area / 4);
+        }
+        return Leaf{ std::move(cell), value, error, std::move(children) };
+      }
+
+      /**
+       * Globally adaptive over the quadtree of the envelope of the polygon: the leaf with the largest error estimate is
+       * split until the estimates add up to the target error. A leaf at the maximum depth, or whose error estimate is
+       * within its share of the target error by area, is not split any further, so that a target out of reach does not
+       * split the whole envelope to the maximum depth. Only cells the boundary passes through or over which f varies
+       * are ever split, as the error estimate of the others is 0.
+       */
+      template<typename FUNC>
+      IntegrationResult quadtree_integration(FUNC& f, const Geometry* polygon, QuadtreeArgs* args)
+      {
+        JPATHGEN_TRACE_SCOPE(GRID);
+        IntegrationResult result;
+        result.termination = Termination::CONVERGED;
+        if (polygon->isEmpty())
+        {
+          return result;
+        }
+
+        std::vector<Edge> edges;
+        for (const geometry::STLCoords& ring : geometry::polygon_rings(polygon))
+        {
+          for (std::size_t k = 0; k + 1 < ring.size(); k++)
+          {
+            edges.push_back(Edge{ ring[k].first, ring[k].second, ring[k + 1].first, ring[k + 1].second });
+          }
+        }
+        const Envelope* envelope = polygon->getEnvelopeInternal();
+        const double error_per_area = args->get_target_error() / (envelope->getWidth() * envelope->getHeight());
+        Cell root{ envelope->getMinX(), envelope->getMinY(), envelope->getMaxX(), envelope->getMaxY(), 0, 0, false, {} };
+        double x = (root.x0 + root.x1) / 2, y = (root.y0 + root.y1) / 2;
+        cubature::evaluate(f, &x, &y, &root.centre_value, 1);
+        result.n_evals++;
+        root.centre_inside = inside(edges, x, y);
+        for (std::size_t e = 0; e < edges.size(); e++)
+        {
+          if (touches(edges[e], root.x0, root.y0, root.x1, root.y1))
+          {
+            root.edges.push_back(e);
+          }
+        }
+
+        const SplitFirst split_first{ args->get_min_depth() };
+        std::vector<Leaf> leaves{ evaluate(f, edges, std::move(root), result.n_evals) };
+        result.n_regions++;
+        double error = leaves.front().error;
+        // Leaves at the maximum depth or within their share of the target error, which are not split any further
+        double final_value = 0, final_error = 0;
+        while (!leaves.empty())
+        {
+          const Leaf& top = leaves.front();
+          if (top.cell.depth >= args->get_min_depth() && error + final_error <= args->get_target_error())
+          {
+            break;
+          }
+          std::pop_heap(leaves.begin(), leaves.end(), split_first);
+          Leaf leaf = std::move(leaves.back());
+          leaves.pop_back();
+          error -= leaf.error;
+          const double area = (leaf.cell.x1 - leaf.cell.x0) * (leaf.cell.y1 - leaf.cell.y0);
+          if (leaf.cell.depth >= args->get_max_depth() ||
+              (leaf.cell.depth >= args->get_min_depth() && leaf.error <= error_per_area * area))
+          {
+            final_value += leaf.value;
+            final_error += leaf.error;
+            continue;
+          }
+          for (Cell& child : leaf.children)
+          {
+            leaves.push_back(evaluate(f, edges, std::move(child), result.n_evals));
+            result.n_regions++;
+            error += leaves.back().error;
+            std::push_heap(leaves.begin(), leaves.end(), split_first);
+          }
+        }
+
+        // Add up again rather than keep the running sum, which loses precision as cells are split
+        result.value = final_value;
+        result.error = final_error;
+        for (const Leaf& leaf : leaves)
+        {
+          result.value += leaf.value;
+          result.error += leaf.error;
+        }
+        if (result.error > args->get_target_error())
+        {
+          result.termination = Termination::MAX_EVAL;
+        }
+        return result;
+      }
+    }  // namespace
+
+    /*************************************
+     * QUADTREE INTEGRATION OVER POLYGON *
+     *************************************/
+
+    template<typename FUNC>
+    IntegrationResult
+    quadtree_integration_over_polygon(FUNC f, std::unique_ptr<geos::geom::Geometry> polygon, QuadtreeArgs* args)
+    {
+      return quadtree_integration(f, polygon.get(), args);
+    }
+    template IntegrationResult
+    quadtree_integration_over_polygon(function::Function, std::unique_ptr<geos::geom::Geometry>, QuadtreeArgs*);
+    template IntegrationResult quadtree_integration_over_polygon(
+        environment::MultiModalBivariateGaussian,
+        std::unique_ptr<geos::geom::Geometry>,
+        QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_polygon(double (*)(double, double), std::unique_ptr<geos::geom::Geometry>, QuadtreeArgs*);
+
+    template<typename FUNC>
+    IntegrationResult quadtree_integration_over_polygon(FUNC f, geometry::STLCoords polygon, QuadtreeArgs* args)
+    {
+      const geos::geom::GeometryFactory* geometry_factory = geos::geom::GeometryFactory::getDefaultInstance();
+
+      std::unique_ptr<geos::geom::CoordinateSequence> coordinate_sequence = geometry::coord_sequence_from_array(polygon);
+      std::unique_ptr<geos::geom::LinearRing> linear_ring =
+          geometry_factory->createLinearRing(std::move(coordinate_sequence));
+      std::unique_ptr<geos::geom::Polygon> geom = geometry_factory->createPolygon(std::move(linear_ring));
+      return quadtree_integration_over_polygon(f, std::move(geom), args);
+    }
+    template IntegrationResult quadtree_integration_over_polygon(function::Function, geometry::STLCoords, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::STLCoords, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_polygon(double (*)(double, double), geometry::STLCoords, QuadtreeArgs*);
+
+    template<typename FUNC>
+    IntegrationResult quadtree_integration_over_polygon(FUNC f, geometry::EigenCoordsRef polygon, QuadtreeArgs* args)
+    {
+      return quadtree_integration_over_polygon(
+          f, geometry::create_polygon(geometry::coord_sequence_from_array(polygon)), args);
+    }
+    template IntegrationResult
+    quadtree_integration_over_polygon(function::Function, geometry::EigenCoordsRef, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_polygon(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_polygon(double (*)(double, double), geometry::EigenCoordsRef, QuadtreeArgs*);
+
+    /**********************************
+     * QUADTREE INTEGRATION OVER PATH *
+     **********************************/
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult quadtree_integration_over_path(FUNC f, COORDS coords, QuadtreeArgs* args)
+    {
+      std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+      auto ls = geometry::create_linestring(std::move(cs));
+      auto buffered = geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+      return quadtree_integration_over_polygon(f, std::move(buffered), args);
+    }
+    template IntegrationResult quadtree_integration_over_path(function::Function, geometry::EigenCoords, QuadtreeArgs*);
+    template IntegrationResult quadtree_integration_over_path(function::Function, geometry::EigenCoordsRef, QuadtreeArgs*);
+    template IntegrationResult quadtree_integration_over_path(function::Function, geometry::STLCoords, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoords, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_path(environment::MultiModalBivariateGaussian, geometry::EigenCoordsRef, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_path(environment::MultiModalBivariateGaussian, geometry::STLCoords, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_path(double (*)(double, double), geometry::EigenCoords, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_path(double (*)(double, double), geometry::EigenCoordsRef, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_path(double (*)(double, double), geometry::STLCoords, QuadtreeArgs*);
+
+    /***********************************
+     * QUADTREE INTEGRATION OVER PATHS *
+     ***********************************/
+
+    template<typename FUNC, typename COORDS>
+    IntegrationResult quadtree_integration_over_paths(FUNC f, std::vector<COORDS> coords_vec, QuadtreeArgs* args)
+    {
+      std::unique_ptr<Geometry> union_buffered_paths =
+          geos::geom::GeometryFactory::getDefaultInstance()->createEmptyGeometry();
+      for (auto coords : coords_vec)
+      {
+        std::unique_ptr<CoordinateSequenceCompat> cs = geometry::coord_sequence_from_array(coords);
+        auto ls = geometry::create_linestring(std::move(cs));
+        std::unique_ptr<geos::geom::Geometry> buffered =
+            geometry::buffer_linestring(std::move(ls), args->get_buffer_radius_m());
+        {
+          JPATHGEN_TRACE_SCOPE(UNION);
+          union_buffered_paths = union_buffered_paths->Union(buffered.get());
+        }
+      }
+      return quadtree_integration_over_polygon(f, std::move(union_buffered_paths), args);
+    }
+    template IntegrationResult
+    quadtree_integration_over_paths(function::Function, std::vector<geometry::EigenCoords>, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_paths(function::Function, std::vector<geometry::EigenCoordsRef>, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_paths(function::Function, std::vector<geometry::STLCoords>, QuadtreeArgs*);
+    template IntegrationResult quadtree_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoords>,
+        QuadtreeArgs*);
+    template IntegrationResult quadtree_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::EigenCoordsRef>,
+        QuadtreeArgs*);
+    template IntegrationResult quadtree_integration_over_paths(
+        environment::MultiModalBivariateGaussian,
+        std::vector<geometry::STLCoords>,
+        QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoords>, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_paths(double (*)(double, double), std::vector<geometry::EigenCoordsRef>, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_paths(double (*)(double, double), std::vector<geometry::STLCoords>, QuadtreeArgs*);
+
+    /***************************************
+     * QUADTREE INTEGRATION OVER RECTANGLE *
+     ***************************************/
+
+    template<typename FUNC>
+    IntegrationResult
+    quadtree_integration_over_rectangle(FUNC f, double left, double right, double bottom, double top, QuadtreeArgs* args)
+    {
+      geometry::STLCoords corners{ { left, bottom }, { left, top }, { right, top }, { right, bottom }, { left, bottom } };
+      return quadtree_integration_over_polygon(f, corners, args);
+    }
+    template IntegrationResult quadtree_integration_over_rectangle(
+        environment::MultiModalBivariateGaussian,
+        double,
+        double,
+        double,
+        double,
+        QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_rectangle(function::Function, double, double, double, double, QuadtreeArgs*);
+    template IntegrationResult
+    quadtree_integration_over_rectangle(double (*)(double, double), double, double, double, double, QuadtreeArgs*);
+
+  }  // namespace integration
+}  // namespace jpathgen
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "jpathgen/error.h"
+#include "jpathgen/integration.h"
+
+namespace jpathgen
+{
+  namespace integration
+  {
+    WarmStart::WarmStart(int resolution, double nodes_per_region)
+        : _resolution(resolution),
+          _nodes_per_region(nodes_per_region)
+    {
+      Error(resolution <= 0, "resolution must be positive");
+      Error(nodes_per_region <= 0, "nodes_per_region must be positive");
+    }
+
+    void WarmStart::reset()
+    {
+      _map = DensityMap();
+      _next = DensityMap();
+      _n_evals = 0;
+    }
+
+    void WarmStart::begin(const geos::geom::Envelope& envelope)
+    {
+      _next.minx = envelope.getMinX();
+      _next.miny = envelope.getMinY();
+      // Degenerate envelopes still need a non-zero bin size to be able to bin anything
+      _next.dx = std::max(envelope.getWidth(), 1e-12) / _resolution;
+      _next.dy = std::max(envelope.getHeight(), 1e-12) / _resolution;
+      _next.counts.assign(static_cast<size_t>(_resolution) * _resolution, 0);
+    }
+
+    void WarmStart::record(double x, double y)
+    {
+      int i = static_cast<int>((x - _next.minx) / _next.dx);
+      int j = static_cast<int>((y - _next.miny) / _next.dy);
+      i = std::clamp(i, 0, _resolution - 1);
+      j = std::clamp(j, 0, _resolution - 1);
+      _next.counts[j * _resolution + i]++;
+    }
+
+    void WarmStart::end()
+    {
+      _n_evals = 0;
+      for (unsigned long count : _next.counts)
+      {
+        _n_evals += count;
+      }
+      std::swap(_map, _next);
+      _next.counts.clear();
+    }
+
+    double WarmStart::density(double x, double y) const
+    {
+      double fi = (x - _map.minx) / _map.dx;
+      double fj = (y - _map.miny) / _map.dy;
+      if (fi < 0 || fj < 0 || fi >= _resolution || fj >= _resolution)
+      {
+        return 0;
+      }
+      int i = static_cast<int>(fi), j = static_cast<int>(fj);
+      return static_cast<double>(_map.counts[j * _resolution + i]) / (_map.dx * _map.dy);
+    }
+
+    bool WarmStart::should_split(const cubpackpp::Point& a, const cubpackpp::Point& b, const cubpackpp::Point& c) const
+    {
+      if (empty())
+      {
+        return false;
+      }
+      double area = std::abs((b.X() - a.X()) * (c.Y() - a.Y()) - (c.X() - a.X()) * (b.Y() - a.Y())) / 2;
+
+      // Long, thin triangles from the Delaunay triangulation can straddle several bins, so sample the densest
+      // of the centroid, vertices and edge midpoints rather than the centroid alone.
+      double max_density = density((a.X() + b.X() + c.X()) / 3, (a.Y() + b.Y() + c.Y()) / 3);
+      for (const cubpackpp::Point* p : { &a, &b, &c })
+      {
+        max_density = std::max(max_density, density(p->X(), p->Y()));
+      }
+      max_density = std::max(max_density, density((a.X() + b.X()) / 2, (a.Y() + b.Y()) / 2));
+      max_density = std::max(max_density, density((b.X() + c.X()) / 2, (b.Y() + c.Y()) / 2));
+      max_density = std::max(max_density, density((c.X() + a.X()) / 2, (c.Y() + a.Y()) / 2));
+
+      return max_density * area > _nodes_per_region;
+    }
+  }  // namespace integration
+}  // namespace jpathgen
@@ -2,29 +2,118 @@
 #  SPDX-License-Identifier: GPL-3.0-only
 
 from ._core import continuous_integration_over_path
+from ._core import continuous_integration_over_path_with_diagnostics
+from ._core import continuous_integration_over_path_with_gradient
 from ._core import continuous_integration_over_paths
+from ._core import continuous_integration_over_paths_with_diagnostics
 from ._core import continuous_integration_over_polygon
+from ._core import continuous_integration_over_polygon_with_diagnostics
 from ._core import continuous_integration_over_rectangle
+from ._core import continuous_integration_over_rectangle_with_diagnostics
 from ._core import ContinuousArgs
+from ._core import ValueAndGradient
+from ._core import WarmStart
 
 from ._core import discrete_integration_over_path
+from ._core import discrete_integration_over_path_with_diagnostics
 from ._core import discrete_integration_over_paths
+from ._core import discrete_integration_over_paths_with_diagnostics
 from ._core import discrete_integration_over_polygon
+from ._core import discrete_integration_over_polygon_with_diagnostics
 from ._core import discrete_integration_over_rectangle
+from ._core import discrete_integration_over_rectangle_with_diagnostics
+from ._core import discrete_integration_over_rectangles
 from ._core import DiscreteArgs
+from ._core import DiscreteGrid
+from ._core import SummedAreaTable
+from ._core import CoverageTracker
+
+from ._core import fixed_integration_over_path
+from ._core import fixed_integration_over_paths
+from ._core import fixed_integration_over_polygon
+from ._core import fixed_integration_over_rectangle
+from ._core import FixedArgs
+
+from ._core import qmc_integration_over_path
+from ._core import qmc_integration_over_paths
+from ._core import qmc_integration_over_polygon
+from ._core import qmc_integration_over_rectangle
+from ._core import QmcArgs
+
+from ._core import quadtree_integration_over_path
+from ._core import quadtree_integration_over_paths
+from ._core import quadtree_integration_over_polygon
+from ._core import quadtree_integration_over_rectangle
+from ._core import QuadtreeArgs
+
+from ._result import IntegrationResult
+from ._core import Termination
+
+from ._vectorized import VectorizedFunction
+
+from ._shared import to_shared_memory
 
 from ._core import MultiModalBivariateGaussian
 
+from ._core import trace
+
+from ._core import submit
+
+from ._core import accuracy_sweep
+from ._core import SweepArgs
+from ._sweep import cheapest_setting
+from ._sweep import pareto_frontier
+
 __all__ = [
     "continuous_integration_over_path",
+    "continuous_integration_over_path_with_diagnostics",
+    "continuous_integration_over_path_with_gradient",
     "continuous_integration_over_paths",
+    "continuous_integration_over_paths_with_diagnostics",
     "continuous_integration_over_polygon",
+    "continuous_integration_over_polygon_with_diagnostics",
     "continuous_integration_over_rectangle",
+    "continuous_integration_over_rectangle_with_diagnostics",
     "ContinuousArgs",
+    "ValueAndGradient",
+    "WarmStart",
     "discrete_integration_over_path",
+    "discrete_integration_over_path_with_diagnostics",
     "discrete_integration_over_paths",
+    "discrete_integration_over_paths_with_diagnostics",
     "discrete_integration_over_polygon",
+    "discrete_integration_over_polygon_with_diagnostics",
     "discrete_integration_over_rectangle",
+    "discrete_integration_over_rectangle_with_diagnostics",
+    "discrete_integration_over_rectangles",
     "DiscreteArgs",
+    "DiscreteGrid",
+    "SummedAreaTable",
+    "CoverageTracker",
+    "fixed_integration_over_path",
+    "fixed_integration_over_paths",
+    "fixed_integration_over_polygon",
+    "fixed_integration_over_rectangle",
+    "FixedArgs",
+    "qmc_integration_over_path",
+    "qmc_integration_over_paths",
+    "qmc_integration_over_polygon",
+    "qmc_integration_over_rectangle",
+    "QmcArgs",
+    "quadtree_integration_over_path",
+    "quadtree_integration_over_paths",
+    "quadtree_integration_over_polygon",
+    "quadtree_integration_over_rectangle",
+    "QuadtreeArgs",
+    "IntegrationResult",
+    "Termination",
+    "VectorizedFunction",
+    "to_shared_memory",
     "MultiModalBivariateGaussian",
+    "trace",
+    "submit",
+    "accuracy_sweep",
+    "SweepArgs",
+    "cheapest_setting",
+    "pareto_frontier",
 ]
@@ -0,0 +1,21 @@
+#  Copyright (c) 2024.  Jan-Hendrik Ewers
+#  SPDX-License-Identifier: GPL-3.0-only
+
+from dataclasses import dataclass
+
+from ._core import Termination
+
+
+@dataclass(frozen=True)
+class IntegrationResult:
+    """The value of an integration together with its error estimate, the number of integrand evaluations, the number of
+    regions it started from and why it stopped."""
+
+    value: float
+    error: float
+    n_evals: int
+    n_regions: int
+    termination: Termination
+
+    def __float__(self) -> float:
+        return self.value
@@ -0,0 +1,16 @@
+#  Copyright (c) 2024.  Jan-Hendrik Ewers
+#  SPDX-License-Identifier: GPL-3.0-only
+
+from multiprocessing.shared_memory import SharedMemory
+from typing import Optional
+
+
+def to_shared_memory(obj, name: Optional[str] = None) -> SharedMemory:
+    """Copy the pickled state of a MultiModalBivariateGaussian, DiscreteGrid or SummedAreaTable into a new shared
+    memory block, which other processes attach to with e.g. DiscreteGrid.from_buffer(SharedMemory(name).buf). The
+    grid values and tables are read in place rather than copied, so the block must stay open for as long as anything
+    attached to it is in use. The caller closes and unlinks the block once done with it."""
+    state = obj.__getstate__()
+    shm = SharedMemory(name=name, create=True, size=len(state))
+    shm.buf[: len(state)] = state
+    return shm
@@ -0,0 +1,106 @@
+#  Copyright (c) 2024.  Jan-Hendrik Ewers
+#  SPDX-License-Identifier: GPL-3.0-only
+"""
+Sweep the integration settings over a representative environment and path set, and print the wall time and error of
+every setting as JSON, with the Pareto frontier flagged. The input file has one mode or path per line:
+
+    # comment
+    mode mu_x mu_y sigma_xx sigma_xy sigma_yx sigma_yy
+    path x0 y0 x1 y1 ...
+
+With --max-error, the cheapest setting whose error is at most that is printed instead.
+"""
+import argparse
+import json
+import sys
+from typing import Optional
+
+import numpy as np
+
+from ._core import accuracy_sweep
+from ._core import MultiModalBivariateGaussian
+from ._core import SweepArgs
+
+
+def pareto_frontier(result: dict) -> list:
+    """The measurements of an accuracy_sweep result on the Pareto frontier, from the fastest to the most accurate."""
+    return sorted((m for m in result["measurements"] if m["pareto"]), key=lambda m: m["seconds"])
+
+
+def cheapest_setting(result: dict, max_error: float) -> Optional[dict]:
+    """The fastest measurement of an accuracy_sweep result with an error of at most max_error, or None if no setting
+    is accurate enough. It is always on the Pareto frontier."""
+    return next((m for m in pareto_frontier(result) if m["error"] <= max_error), None)
+
+
+def write_json(value, file) -> None:
+    """Write value as JSON with infinities and NaN as null, as jpathgen::sweep::write_json does, since JSON has no
+    literal for them."""
+    def finite(v):
+        if isinstance(v, dict):
+            return {k: finite(x) for k, x in v.items()}
+        if isinstance(v, list):
+            return [finite(x) for x in v]
+        return None if isinstance(v, float) and not np.isfinite(v) else v
+
+    json.dump(finite(value), file, indent=2, allow_nan=False)
+    print(file=file)
+
+
+def read_input(lines) -> tuple:
+    """Parse the mode and path lines of the input file into a MultiModalBivariateGaussian and a list of paths."""
+    modes, paths = [], []
+    for number, line in enumerate(lines, 1):
+        fields = line.split()
+        if not fields or fields[0].startswith("#"):
+            continue
+        kind, values = fields[0], [float(v) for v in fields[1:]]
+        if kind == "mode":
+            if len(values) != 6:
+                raise ValueError(f"line {number}: a mode needs mu_x mu_y sigma_xx sigma_xy sigma_yx sigma_yy")
+            modes.append(values)
+        elif kind == "path":
+            if len(values) < 4 or len(values) % 2:
+                raise ValueError(f"line {number}: a path needs at least two x y waypoints")
+            paths.append(np.reshape(values, (-1, 2)))
+        else:
+            raise ValueError(f"line {number}: lines must start with mode, path or #")
+    if not modes or not paths:
+        raise ValueError("the input needs at least one mode and one path")
+    modes = np.asarray(modes)
+    return MultiModalBivariateGaussian(modes[:, :2].copy(), modes[:, 2:].reshape(-1, 2)), paths
+
+
+def main(argv=None):
+    """Run the sweep on the command line, see the module docstring."""
+    defaults = SweepArgs(1.0)
+    parser = argparse.ArgumentParser(
+        prog="jpathgen-accuracy-sweep", description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("file", type=argparse.FileType("r"), help="the modes and paths, or - for stdin")
+    parser.add_argument("--buffer-radius", type=float, default=defaults.buffer_radius_m)
+    parser.add_argument("--repeats", type=int, default=defaults.n_repeats,
+                        help="timings per setting, the fastest is kept")
+    parser.add_argument("--rel-err-reqs", type=float, nargs="+", default=defaults.rel_err_reqs)
+    parser.add_argument("--max-evals", type=int, nargs="+", default=defaults.max_evals)
+    parser.add_argument("--grid-sizes", type=int, nargs="+", default=defaults.grid_sizes)
+    parser.add_argument("--max-error", type=float, help="print the cheapest setting with at most this relative error")
+    args = parser.parse_args(argv)
+
+    with args.file:
+        f, paths = read_input(args.file)
+    sweep_args = SweepArgs(args.buffer_radius, args.rel_err_reqs, args.max_evals, args.grid_sizes, args.repeats)
+    result = accuracy_sweep(f, paths, sweep_args)
+
+    if args.max_error is None:
+        write_json(result, sys.stdout)
+        return 0
+    setting = cheapest_setting(result, args.max_error)
+    if setting is None:
+        print(f"No setting has an error of at most {args.max_error}", file=sys.stderr)
+        return 1
+    write_json(setting, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
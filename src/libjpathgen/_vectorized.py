@@ -0,0 +1,13 @@
+#  Copyright (c) 2024.  Jan-Hendrik Ewers
+#  SPDX-License-Identifier: GPL-3.0-only
+
+from dataclasses import dataclass
+from typing import Callable
+
+
+@dataclass(frozen=True)
+class VectorizedFunction:
+    """A NumPy-vectorized integrand. The continuous and discrete integrations call f(xs, ys) once per batch of points,
+    with xs and ys 1d float64 arrays, rather than once per point, and f must return one value per point."""
+
+    f: Callable
@@ -3,20 +3,569 @@
  * SPDX-License-Identifier: GPL-3.0-only
  */
 
+#include <jpathgen/async.h>
+#include <jpathgen/discrete_grid.h>
 #include <jpathgen/environment.h>
 #include <jpathgen/function.h>
 #include <jpathgen/integration.h>
+#include <jpathgen/sweep.h>
+#include <jpathgen/trace.h>
 #include <pybind11/eigen.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace py = pybind11;
+
+namespace pybind11::detail
+{
+  /**
+   * IntegrationResult is returned to Python as the libjpathgen.IntegrationResult dataclass rather than as a bound
+   * class, so that it behaves like any other dataclass (equality, dataclasses.asdict, pickling, ...).
+   */
+  template<>
+  struct type_caster<jpathgen::IntegrationResult>
+  {
+    PYBIND11_TYPE_CASTER(jpathgen::IntegrationResult, const_name("IntegrationResult"));
+
+    bool load(handle, bool)
+    {
+      return false;
+    }
+
+    static handle cast(const jpathgen::IntegrationResult& result, return_value_policy, handle)
+    {
+      return module_::import("libjpathgen._result")
+          .attr("IntegrationResult")(
+              result.value, result.error, result.n_evals, result.n_regions, pybind11::cast(result.termination))
+          .release();
+    }
+  };
+
+  /**
+   * A libjpathgen.VectorizedFunction is passed as a BatchFunction calling its f once per batch of points, on 1d float64
+   * arrays of their x and y. Any other callable is left to the Function overloads.
+   */
+  template<>
+  struct type_caster<jpathgen::function::BatchFunction>
+  {
+    PYBIND11_TYPE_CASTER(jpathgen::function::BatchFunction, const_name("VectorizedFunction"));
+
+    // As in pybind11/functional.h, f is only copied and released with the GIL held, as the discrete integrations copy
+    // it after releasing the GIL
+    struct vectorized_call
+    {
+      object f;
+
+      explicit vectorized_call(object f_) : f(std::move(f_))
+      {
+      }
+      vectorized_call(const vectorized_call& other)
+      {
+        gil_scoped_acquire acquire;
+        f = other.f;
+      }
+      ~vectorized_call()
+      {
+        gil_scoped_acquire acquire;
+        object kill_f(std::move(f));
+      }
+
+      void operator()(const double* xs, const double* ys, double* out, std::size_t n) const
+      {
+        gil_scoped_acquire acquire;
+        array_t<double> x(static_cast<ssize_t>(n)), y(static_cast<ssize_t>(n));
+        std::copy_n(xs, n, x.mutable_data());
+        std::copy_n(ys, n, y.mutable_data());
+        auto values = array_t<double, array::c_style | array::forcecast>::ensure(f(x, y));
+        if (!values || static_cast<std::size_t>(values.size()) != n)
+        {
+          throw value_error("A VectorizedFunction must return one value per point");
+        }
+        std::copy_n(values.data(), n, out);
+      }
+    };
+
+    bool load(handle src, bool)
+    {
+      module_ vectorized = module_::import("libjpathgen._vectorized");
+      if (!isinstance(src, vectorized.attr("VectorizedFunction")))
+      {
+        return false;
+      }
+      value = vectorized_call(src.attr("f"));
+      return true;
+    }
+
+    static handle cast(const jpathgen::function::BatchFunction&, return_value_policy, handle)
+    {
+      return none().release();
+    }
+  };
+}  // namespace pybind11::detail
+
 using namespace jpathgen::integration;
 using namespace jpathgen::function;
 using namespace jpathgen::environment;
 using namespace jpathgen::geometry;
 using namespace py::literals;
+using jpathgen::IntegrationResult;
+using jpathgen::Termination;
+
+namespace
+{
+  // Points evaluated per batch, few enough for the inputs and values of a batch to stay in the L1 and L2 caches
+  constexpr py::ssize_t BATCH = 2048;
+
+  // `a` if it is aligned to and strided by whole doubles, else a C-contiguous copy of it, e.g. of a field of a packed
+  // structured array. broadcast_strides and evaluate_broadcast index it in elements rather than bytes.
+  py::array_t<double> element_strided(const py::array_t<double>& a)
+  {
+    bool strided = reinterpret_cast<std::uintptr_t>(a.data()) % alignof(double) == 0;
+    for (py::ssize_t k = 0; k < a.ndim(); k++)
+    {
+      strided = strided && (a.shape(k) == 1 || a.strides(k) % static_cast<py::ssize_t>(sizeof(double)) == 0);
+    }
+    return strided ? a : a.attr("copy")().cast<py::array_t<double>>();
+  }
+
+  // The strides in elements of `a` broadcast to `shape`, 0 along the axes it is repeated over
+  std::vector<py::ssize_t> broadcast_strides(const py::array_t<double>& a, const std::vector<py::ssize_t>& shape)
+  {
+    const py::ssize_t offset = static_cast<py::ssize_t>(shape.size()) - a.ndim();
+    std::vector<py::ssize_t> strides(shape.size(), 0);
+    for (py::ssize_t k = 0; k < a.ndim(); k++)
+    {
+      if (a.shape(k) != 1)
+      {
+        strides[offset + k] = a.strides(k) / static_cast<py::ssize_t>(sizeof(double));
+      }
+    }
+    return strides;
+  }
+
+  std::vector<py::ssize_t> broadcast_shape(const py::array_t<double>& x, const py::array_t<double>& y)
+  {
+    const py::ssize_t ndim = std::max(x.ndim(), y.ndim());
+    std::vector<py::ssize_t> shape(ndim, 1);
+    for (py::ssize_t k = 0; k < ndim; k++)
+    {
+      const py::ssize_t kx = k - (ndim - x.ndim()), ky = k - (ndim - y.ndim());
+      const py::ssize_t nx = kx >= 0 ? x.shape(kx) : 1, ny = ky >= 0 ? y.shape(ky) : 1;
+      if (nx != ny && nx != 1 && ny != 1)
+      {
+        throw py::value_error("x and y could not be broadcast together");
+      }
+      shape[k] = nx == 1 ? ny : nx;
+    }
+    return shape;
+  }
+
+  /**
+   * f at the points of x and y broadcast against each other as in NumPy, written to the C-contiguous `out`. The
+   * points are evaluated in batches along the last axis, each with a single batched call of f, on up to `n_threads`
+   * threads (one per hardware thread if 0) and without the GIL. Batches of x or y that are not contiguous, e.g. as they
+   * are broadcast along the last axis, are gathered first. The values go through a buffer so that out may be x or y.
+   */
+  void evaluate_broadcast(
+      const MultiModalBivariateGaussian& f,
+      const py::array_t<double>& x_in,
+      const py::array_t<double>& y_in,
+      py::array_t<double, py::array::c_style>& out,
+      int n_threads)
+  {
+    const py::array_t<double> x = element_strided(x_in), y = element_strided(y_in);
+    const std::vector<py::ssize_t> shape = broadcast_shape(x, y);
+    if (out.ndim() != static_cast<py::ssize_t>(shape.size()) || !std::equal(shape.begin(), shape.end(), out.shape()))
+    {
+      throw py::value_error("out does not have the broadcast shape of x and y");
+    }
+    const std::vector<py::ssize_t> x_strides = broadcast_strides(x, shape), y_strides = broadcast_strides(y, shape);
+    const py::ssize_t n_cols = shape.empty() ? 1 : shape.back();
+    const py::ssize_t n_rows = n_cols == 0 ? 0 : out.size() / n_cols;
+    const py::ssize_t batches_per_row = (n_cols + BATCH - 1) / BATCH;
+    const py::ssize_t n_batches = n_rows * batches_per_row;
+    const py::ssize_t x_col_stride = shape.empty() ? 0 : x_strides.back();
+    const py::ssize_t y_col_stride = shape.empty() ? 0 : y_strides.back();
+    const double* x_data = x.data();
+    const double* y_data = y.data();
+    double* out_data = out.mutable_data();
+
+    py::gil_scoped_release release;
+    std::atomic<py::ssize_t> next{ 0 };
+    auto work = [&]()
+    {
+      std::vector<double> xs(BATCH), ys(BATCH), values(BATCH);
+      for (py::ssize_t batch = next++; batch < n_batches; batch = next++)
+      {
+        const py::ssize_t row = batch / batches_per_row, col = (batch % batches_per_row) * BATCH;
+        const py::ssize_t n = std::min(BATCH, n_cols - col);
+        // Offsets of the first point of the batch, from the index of its row over all but the last axis
+        py::ssize_t x_offset = col * x_col_stride, y_offset = col * y_col_stride;
+        for (py::ssize_t k = static_cast<py::ssize_t>(shape.size()) - 2, rest = row; k >= 0; k--)
+        {
+          x_offset += (rest % shape[k]) * x_strides[k];
+          y_offset += (rest % shape[k]) * y_strides[k];
+          rest /= shape[k];
+        }
+        const double* batch_xs = x_data + x_offset;
+        if (x_col_stride != 1)
+        {
+          for (py::ssize_t i = 0; i < n; i++)
+          {
+            xs[i] = batch_xs[i * x_col_stride];
+          }
+          batch_xs = xs.data();
+        }
+        const double* batch_ys = y_data + y_offset;
+        if (y_col_stride != 1)
+        {
+          for (py::ssize_t i = 0; i < n; i++)
+          {
+            ys[i] = batch_ys[i * y_col_stride];
+          }
+          batch_ys = ys.data();
+        }
+        f(batch_xs, batch_ys, values.data(), static_cast<std::size_t>(n));
+        std::copy(values.begin(), values.begin() + n, out_data + row * n_cols + col);
+      }
+    };
+
+    if (n_threads <= 0)
+    {
+      n_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    std::vector<std::thread> threads;
+    for (int t = 1; t < std::min<py::ssize_t>(n_threads, n_batches); t++)
+    {
+      threads.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  /**
+   * The pickled state of an environment, grid or table: an 8 character tag naming its type, then its fields and arrays
+   * in native byte order, each padded to a multiple of 8 bytes. The arrays of a state in aligned memory, such as a
+   * multiprocessing.shared_memory block, are therefore read in place rather than copied.
+   */
+  constexpr std::size_t STATE_TAG_SIZE = 8;
+  constexpr const char* ARGS_TAG = "jpgARGS1";
+  constexpr const char* MMBG_TAG = "jpgMMBG1";
+  constexpr const char* GRID_TAG = "jpgGRID1";
+  constexpr const char* TABLE_TAG = "jpgSAT01";
+
+  class StateWriter
+  {
+   protected:
+    std::string _bytes;
+
+   public:
+    explicit StateWriter(const char* tag) : _bytes(tag, STATE_TAG_SIZE)
+    {
+    }
+
+    template<typename T>
+    void put(const T* values, std::size_t n)
+    {
+      _bytes.append(reinterpret_cast<const char*>(values), n * sizeof(T));
+      _bytes.append((8 - _bytes.size() % 8) % 8, '\0');
+    }
+    template<typename T>
+    void put(T value)
+    {
+      put(&value, 1);
+    }
+
+    [[nodiscard]] py::bytes bytes() const
+    {
+      return py::bytes(_bytes);
+    }
+  };
+
+  class StateReader
+  {
+   protected:
+    // Released with the GIL held, as the arrays read in place may outlive the call that read them
+    std::shared_ptr<py::buffer_info> _buffer;
+    const char* _data;
+    std::size_t _size, _offset = STATE_TAG_SIZE;
+
+    const char* take(std::size_t n_bytes)
+    {
+      if (_offset > _size || n_bytes > _size - _offset)
+      {
+        throw py::value_error("The state is truncated");
+      }
+      const char* begin = _data + _offset;
+      _offset += n_bytes + (8 - n_bytes % 8) % 8;
+      return begin;
+    }
+
+   public:
+    StateReader(const py::buffer& buffer, const char* tag, const std::string& type)
+        : _buffer(
+              new py::buffer_info(buffer.request()),
+              [](py::buffer_info* info)
+              {
+                py::gil_scoped_acquire acquire;
+                delete info;
+              })
+    {
+      if (_buffer->ndim > 1 || (_buffer->ndim == 1 && _buffer->strides[0] != _buffer->itemsize))
+      {
+        throw py::value_error("The state must be a contiguous buffer");
+      }
+      _data = static_cast<const char*>(_buffer->ptr);
+      _size = static_cast<std::size_t>(_buffer->size * _buffer->itemsize);
+      if (_size < STATE_TAG_SIZE || std::memcmp(_data, tag, STATE_TAG_SIZE) != 0)
+      {
+        throw py::value_error("The buffer does not hold the state of a " + type);
+      }
+    }
+
+    template<typename T>
+    T get()
+    {
+      T value;
+      std::memcpy(&value, take(sizeof(T)), sizeof(T));
+      return value;
+    }
+
+    // n values, read in place if they are aligned and copied otherwise, which keep the buffer alive while in use
+    template<typename T>
+    std::shared_ptr<const T> view(std::size_t n)
+    {
+      if (n > _size / sizeof(T))
+      {
+        throw py::value_error("The state is truncated");
+      }
+      const char* begin = take(n * sizeof(T));
+      if (reinterpret_cast<std::uintptr_t>(begin) % alignof(T) == 0)
+      {
+        return std::shared_ptr<const T>(_buffer, reinterpret_cast<const T*>(begin));
+      }
+      std::shared_ptr<T[]> copy(new T[n]);
+      std::memcpy(copy.get(), begin, n * sizeof(T));
+      return std::shared_ptr<const T>(copy, copy.get());
+    }
+  };
+
+  void put_args(StateWriter& state, const DiscreteArgs& args)
+  {
+    state.put(args.get_buffer_radius_m());
+    state.put<std::int64_t>(args.get_N());
+    state.put<std::int64_t>(args.get_M());
+    state.put(args.get_minx());
+    state.put(args.get_maxx());
+    state.put(args.get_miny());
+    state.put(args.get_maxy());
+    state.put(args.get_deadline_s());
+    state.put<std::int64_t>(args.get_n_threads());
+    state.put<std::int64_t>(args.get_fractional_coverage());
+  }
+
+  DiscreteArgs get_args(StateReader& state)
+  {
+    const auto buffer_radius_m = state.get<double>();
+    const auto N = static_cast<int>(state.get<std::int64_t>());
+    const auto M = static_cast<int>(state.get<std::int64_t>());
+    const auto minx = state.get<double>();
+    const auto maxx = state.get<double>();
+    const auto miny = state.get<double>();
+    const auto maxy = state.get<double>();
+    const auto deadline_s = state.get<double>();
+    const auto n_threads = static_cast<int>(state.get<std::int64_t>());
+    const bool fractional_coverage = state.get<std::int64_t>() != 0;
+    return DiscreteArgs(buffer_radius_m, N, M, minx, maxx, miny, maxy, deadline_s, n_threads, fractional_coverage);
+  }
+
+  std::size_t grid_size(const DiscreteArgs& args)
+  {
+    return static_cast<std::size_t>(std::max(args.get_N(), 0)) * std::max(args.get_M(), 0);
+  }
+
+  py::bytes args_state(const DiscreteArgs& args)
+  {
+    StateWriter state(ARGS_TAG);
+    put_args(state, args);
+    return state.bytes();
+  }
+
+  DiscreteArgs args_from_state(const py::buffer& buffer)
+  {
+    StateReader state(buffer, ARGS_TAG, "DiscreteArgs");
+    return get_args(state);
+  }
+
+  py::bytes mmbg_state(const MultiModalBivariateGaussian& mmbg)
+  {
+    StateWriter state(MMBG_TAG);
+    state.put<std::int64_t>(mmbg.length());
+    state.put(mmbg.getMus().data(), mmbg.getMus().size());
+    state.put(mmbg.getCovs().data(), mmbg.getCovs().size());
+    return state.bytes();
+  }
+
+  // The coefficients of the modes are recomputed from the means and covariances, which takes microseconds
+  MultiModalBivariateGaussian mmbg_from_state(const py::buffer& buffer)
+  {
+    StateReader state(buffer, MMBG_TAG, "MultiModalBivariateGaussian");
+    const auto n_modes = static_cast<Eigen::Index>(std::max<std::int64_t>(state.get<std::int64_t>(), 0));
+    MUS mus = Eigen::Map<const MUS>(state.view<double>(2 * n_modes).get(), n_modes, 2);
+    COVS covs = Eigen::Map<const COVS>(state.view<double>(4 * n_modes).get(), 2 * n_modes, 2);
+    return MultiModalBivariateGaussian(mus, covs);
+  }
+
+  py::bytes grid_state(const DiscreteGrid& grid)
+  {
+    StateWriter state(GRID_TAG);
+    put_args(state, grid.get_args());
+    state.put<std::int64_t>(grid.is_single_precision());
+    if (grid.is_single_precision())
+    {
+      state.put(grid.single_data(), grid_size(grid.get_args()));
+    }
+    else
+    {
+      state.put(grid.data(), grid_size(grid.get_args()));
+    }
+    return state.bytes();
+  }
+
+  DiscreteGrid grid_from_state(const py::buffer& buffer)
+  {
+    StateReader state(buffer, GRID_TAG, "DiscreteGrid");
+    const DiscreteArgs args = get_args(state);
+    if (state.get<std::int64_t>() != 0)
+    {
+      return DiscreteGrid(args, state.view<float>(grid_size(args)));
+    }
+    return DiscreteGrid(args, state.view<double>(grid_size(args)));
+  }
+
+  py::bytes table_state(const SummedAreaTable& table)
+  {
+    StateWriter state(TABLE_TAG);
+    put_args(state, table.get_args());
+    state.put(table.sums(), SummedAreaTable::size_of_sums(table.get_args()));
+    state.put(table.coarse_sums(), SummedAreaTable::size_of_coarse_sums(table.get_args()));
+    return state.bytes();
+  }
+
+  SummedAreaTable table_from_state(const py::buffer& buffer)
+  {
+    StateReader state(buffer, TABLE_TAG, "SummedAreaTable");
+    const DiscreteArgs args = get_args(state);
+    std::shared_ptr<const double> sums = state.view<double>(SummedAreaTable::size_of_sums(args));
+    std::shared_ptr<const double> coarse_sums = state.view<double>(SummedAreaTable::size_of_coarse_sums(args));
+    return SummedAreaTable(args, sums, coarse_sums);
+  }
+
+  /**
+   * A call of fn(*args, **kwargs) on the default pool, resolving future. The worker holds the GIL only to call fn, which
+   * for the integrations releases it again while they run. The call is released with the GIL held.
+   */
+  struct PendingCall
+  {
+    py::object future;
+    py::function fn;
+    py::args args;
+    py::kwargs kwargs;
+  };
+
+  py::object submit(const py::function& fn, const py::args& args, const py::kwargs& kwargs)
+  {
+    py::object future = py::module_::import("concurrent.futures").attr("Future")();
+    std::shared_ptr<PendingCall> call(
+        new PendingCall{ future, fn, args, kwargs },
+        [](PendingCall* pending)
+        {
+          py::gil_scoped_acquire acquire;
+          delete pending;
+        });
+    jpathgen::async::default_pool().post(
+        [call]()
+        {
+          py::gil_scoped_acquire acquire;
+          try
+          {
+            // False once the future has been cancelled, in which case fn is never called
+            if (!call->future.attr("set_running_or_notify_cancel")().cast<bool>())
+            {
+              return;
+            }
+            py::object result;
+            try
+            {
+              result = call->fn(*call->args, **call->kwargs);
+            }
+            catch (py::error_already_set& error)
+            {
+              call->future.attr("set_exception")(error.value());
+              return;
+            }
+            call->future.attr("set_result")(result);
+          }
+          catch (py::error_already_set& error)
+          {
+            error.discard_as_unraisable("libjpathgen.submit");
+          }
+        });
+    return future;
+  }
+
+  // The same keys as jpathgen::sweep::write_json, so that the tool and the bindings give the same JSON
+  py::dict sweep_result_to_dict(const jpathgen::sweep::SweepResult& result)
+  {
+    py::list measurements;
+    for (const jpathgen::sweep::Measurement& measurement : result.measurements)
+    {
+      py::dict found("mode"_a = jpathgen::sweep::to_string(measurement.mode));
+      if (measurement.mode == jpathgen::sweep::Mode::CONTINUOUS)
+      {
+        found["rel_err_req"] = measurement.rel_err_req;
+        found["max_eval"] = measurement.max_eval;
+      }
+      else
+      {
+        found["N"] = measurement.N;
+        found["M"] = measurement.M;
+      }
+      found["seconds"] = measurement.seconds;
+      found["error"] = measurement.error;
+      found["pareto"] = measurement.pareto;
+      measurements.append(found);
+    }
+    return py::dict(
+        "reference"_a = result.reference, "reference_error"_a = result.reference_error, "measurements"_a = measurements);
+  }
+
+  template<typename FUNC>
+  py::dict accuracy_sweep(FUNC f, const std::vector<EigenCoords>& paths, const jpathgen::sweep::SweepArgs& args)
+  {
+    jpathgen::sweep::SweepResult result;
+    {
+      py::gil_scoped_release release;
+      result = jpathgen::sweep::accuracy_sweep(f, paths, args);
+    }
+    return sweep_result_to_dict(result);
+  }
+}  // namespace
 
 PYBIND11_MODULE(_core, m)
 {
@@ -30,9 +579,24 @@ PYBIND11_MODULE(_core, m)
           "__call__", [](MultiModalBivariateGaussian& mmbg, double x, double y) { return mmbg(x, y); }, "x"_a, "y"_a)
       .def(
           "__call__",
-          py::vectorize([](MultiModalBivariateGaussian& mmbg, double x, double y) { return mmbg(x, y); }),
+          [](const MultiModalBivariateGaussian& mmbg,
+             const py::array_t<double>& x,
+             const py::array_t<double>& y,
+             std::optional<py::array_t<double, py::array::c_style>> out,
+             int n_threads)
+          {
+            if (!out)
+            {
+              out = py::array_t<double, py::array::c_style>(broadcast_shape(x, y));
+            }
+            evaluate_broadcast(mmbg, x, y, *out, n_threads);
+            return *out;
+          },
           "x"_a,
-          "y"_a)
+          "y"_a,
+          py::kw_only(),
+          "out"_a.noconvert() = py::none(),
+          "n_threads"_a = 1)
       .def(
           "__repr__",
           [](MultiModalBivariateGaussian& mmbg)
@@ -42,7 +606,15 @@ PYBIND11_MODULE(_core, m)
             return ss.str();
           })
       .def_property_readonly("_mus", &MultiModalBivariateGaussian::getMus)
-      .def_property_readonly("_covs", &MultiModalBivariateGaussian::getCovs);
+      .def_property_readonly("_covs", &MultiModalBivariateGaussian::getCovs)
+      .def(py::pickle(&mmbg_state, &mmbg_from_state))
+      .def_static("from_buffer", &mmbg_from_state, "buffer"_a);
+
+  py::enum_<Termination>(m, "Termination", "Why an integration stopped.")
+      .value("CONVERGED", Termination::CONVERGED, "The error estimate met the requested tolerance")
+      .value("MAX_EVAL", Termination::MAX_EVAL, "The evaluation budget ran out first")
+      .value("FIXED_BUDGET", Termination::FIXED_BUDGET, "A non-adaptive integration spent its whole budget")
+      .value("DEADLINE", Termination::DEADLINE, "The deadline passed first, the value is the best estimate so far");
 
   py::class_<Args>(m, "Args")
       .def(py::init<double>(), "buffer_radius_m"_a)
@@ -50,60 +622,420 @@ PYBIND11_MODULE(_core, m)
 
   py::class_<DiscreteArgs, Args>(m, "DiscreteArgs")
       .def(
-          py::init<double, int, int, double, double, double, double>(),
+          py::init<double, int, int, double, double, double, double, double, int, bool>(),
           "buffer_radius_m"_a,
           "N"_a,
           "M"_a,
           "minx"_a,
           "maxx"_a,
-          "minx"_a,
-          "maxx"_a)
+          "miny"_a,
+          "maxy"_a,
+          "deadline_s"_a = 0.0,
+          "n_threads"_a = 1,
+          "fractional_coverage"_a = false)
       .def_property_readonly("N", &DiscreteArgs::get_N)
       .def_property_readonly("M", &DiscreteArgs::get_M)
       .def_property_readonly("minx", &DiscreteArgs::get_minx)
       .def_property_readonly("maxx", &DiscreteArgs::get_maxx)
-      .def_property_readonly("minx", &DiscreteArgs::get_miny)
-      .def_property_readonly("maxx", &DiscreteArgs::get_maxy);
+      .def_property_readonly("miny", &DiscreteArgs::get_miny)
+      .def_property_readonly("maxy", &DiscreteArgs::get_maxy)
+      .def_property_readonly("deadline_s", &DiscreteArgs::get_deadline_s)
+      .def_property_readonly("n_threads", &DiscreteArgs::get_n_threads)
+      .def_property_readonly("fractional_coverage", &DiscreteArgs::get_fractional_coverage)
+      .def(py::pickle(&args_state, &args_from_state));
 
   py::class_<ContinuousArgs, Args>(m, "ContinuousArgs")
       .def(
-          py::init<double, double, double, unsigned long>(),
+          py::init<double, double, double, unsigned long, double>(),
           "buffer_radius_m"_a,
           "abs_err_req"_a = 0.0,
           "rel_err_req"_a = 0.05,
-          "max_eval"_a = 100000)
+          "max_eval"_a = 100000,
+          "deadline_s"_a = 0.0)
       .def_property_readonly("abs_err_req", &ContinuousArgs::get_abs_err_req)
       .def_property_readonly("rel_err_req", &ContinuousArgs::get_rel_err_req)
-      .def_property_readonly("max_eval", &ContinuousArgs::get_max_eval);
+      .def_property_readonly("max_eval", &ContinuousArgs::get_max_eval)
+      .def_property_readonly("deadline_s", &ContinuousArgs::get_deadline_s);
+
+  py::class_<FixedArgs, Args>(m, "FixedArgs")
+      .def(py::init<double, int>(), "buffer_radius_m"_a, "refinement"_a = 0)
+      .def_property_readonly("refinement", &FixedArgs::get_refinement);
+
+  py::class_<QmcArgs, Args>(m, "QmcArgs")
+      .def(
+          py::init<double, unsigned long, int, double, double, unsigned long, std::uint64_t>(),
+          "buffer_radius_m"_a,
+          "n_samples"_a = 4096,
+          "n_replicates"_a = 8,
+          "abs_err_req"_a = 0.0,
+          "rel_err_req"_a = 0.0,
+          "max_samples"_a = 1 << 22,
+          "seed"_a = 0)
+      .def_property_readonly("n_samples", &QmcArgs::get_n_samples)
+      .def_property_readonly("n_replicates", &QmcArgs::get_n_replicates)
+      .def_property_readonly("abs_err_req", &QmcArgs::get_abs_err_req)
+      .def_property_readonly("rel_err_req", &QmcArgs::get_rel_err_req)
+      .def_property_readonly("max_samples", &QmcArgs::get_max_samples)
+      .def_property_readonly("seed", &QmcArgs::get_seed);
+
+  py::class_<QuadtreeArgs, Args>(m, "QuadtreeArgs")
+      .def(
+          py::init<double, double, int, int>(),
+          "buffer_radius_m"_a,
+          "target_error"_a = 1e-6,
+          "max_depth"_a = 10,
+          "min_depth"_a = 3)
+      .def_property_readonly("target_error", &QuadtreeArgs::get_target_error)
+      .def_property_readonly("max_depth", &QuadtreeArgs::get_max_depth)
+      .def_property_readonly("min_depth", &QuadtreeArgs::get_min_depth);
+
+  py::class_<ValueAndGradient>(m, "ValueAndGradient")
+      .def_readonly("value", &ValueAndGradient::value)
+      .def_readonly("gradient", &ValueAndGradient::gradient)
+      .def(
+          "__iter__",
+          [](const ValueAndGradient& result) { return py::iter(py::make_tuple(result.value, result.gradient)); });
+
+  py::class_<WarmStart>(m, "WarmStart")
+      .def(py::init<int, double>(), "resolution"_a = 64, "nodes_per_region"_a = WarmStart::DEFAULT_NODES_PER_REGION)
+      .def("reset", &WarmStart::reset)
+      .def("__bool__", [](WarmStart& warm_start) { return !warm_start.empty(); })
+      .def_property_readonly("resolution", &WarmStart::get_resolution)
+      .def_property_readonly("nodes_per_region", &WarmStart::get_nodes_per_region)
+      .def_property_readonly("n_evals", &WarmStart::get_n_evals);
+
+  // The integrations and the grid evaluation run without the GIL, so that other Python threads and submit() run
+  // alongside them. Both may also call f from several threads, which would deadlock on a Python f if the GIL was held.
+  auto RELEASE_GIL = py::call_guard<py::gil_scoped_release>();
+
+  auto SINGLE_PRECISION = "single_precision"_a = false;
+  py::class_<DiscreteGrid>(m, "DiscreteGrid")
+      .def(py::init<Function, const DiscreteArgs&, bool>(), "f"_a, "args"_a, SINGLE_PRECISION, RELEASE_GIL)
+      .def(
+          py::init<MultiModalBivariateGaussian, const DiscreteArgs&, bool>(),
+          "f"_a,
+          "args"_a,
+          SINGLE_PRECISION,
+          RELEASE_GIL)
+      .def(py::init<BatchFunction, const DiscreteArgs&, bool>(), "f"_a, "args"_a, SINGLE_PRECISION, RELEASE_GIL)
+      .def_property_readonly("args", &DiscreteGrid::get_args)
+      .def_property_readonly("xs", &DiscreteGrid::get_xs)
+      .def_property_readonly("ys", &DiscreteGrid::get_ys)
+      .def_property_readonly("single_precision", &DiscreteGrid::is_single_precision)
+      .def_property_readonly("values", &DiscreteGrid::values)
+      .def(py::pickle(&grid_state, &grid_from_state))
+      .def_static("from_buffer", &grid_from_state, "buffer"_a);
+
+  py::class_<SummedAreaTable>(m, "SummedAreaTable")
+      .def(py::init<const DiscreteGrid&>(), "grid"_a)
+      .def_property_readonly("args", &SummedAreaTable::get_args)
+      .def_property_readonly("xs", &SummedAreaTable::get_xs)
+      .def_property_readonly("ys", &SummedAreaTable::get_ys)
+      .def(py::pickle(&table_state, &table_from_state))
+      .def_static("from_buffer", &table_from_state, "buffer"_a);
 
   auto F = "f"_a;
   auto ARGS = "args"_a;
 
+  // C-contiguous float64 (n, 2) arrays are read in place by the EigenCoordsRef overloads, which are registered first so
+  // that they are preferred. They do not convert, so that any other input falls through to the overloads copying it.
+  auto SEGMENT = "segment"_a;
+  auto SEGMENT_REF = "segment"_a.noconvert();
+  py::class_<CoverageTracker>(m, "CoverageTracker")
+      .def(py::init<Function, const DiscreteArgs&>(), F, ARGS)
+      .def(py::init<MultiModalBivariateGaussian, const DiscreteArgs&>(), F, ARGS)
+      .def(py::init<BatchFunction, const DiscreteArgs&>(), F, ARGS)
+      .def("step", &CoverageTracker::step<EigenCoordsRef>, SEGMENT_REF, RELEASE_GIL)
+      .def("step", &CoverageTracker::step<STLCoords>, SEGMENT, RELEASE_GIL)
+      .def("step", &CoverageTracker::step<EigenCoords>, SEGMENT, RELEASE_GIL)
+      .def("reset", &CoverageTracker::reset)
+      .def_property_readonly("args", &CoverageTracker::get_args)
+      .def_property_readonly("value", &CoverageTracker::get_value)
+      .def_property_readonly("n_evals", &CoverageTracker::get_n_evals);
+
+  // None would reach the integrations as a null WarmStart*, so it is rejected before the call
+  auto WARM_START = "warm_start"_a.none(false);
+
   auto POLYGON = "polygon"_a;
+  auto POLYGON_REF = "polygon"_a.noconvert();
+  m.def(
+      "continuous_integration_over_polygon",
+      static_cast<double (*)(Function, EigenCoordsRef, ContinuousArgs*)>(&continuous_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_polygon",
       static_cast<double (*)(Function, STLCoords, ContinuousArgs*)>(&continuous_integration_over_polygon),
       F,
       POLYGON,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon",
+      static_cast<double (*)(MultiModalBivariateGaussian, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_polygon",
       static_cast<double (*)(MultiModalBivariateGaussian, STLCoords, ContinuousArgs*)>(&continuous_integration_over_polygon),
       F,
       POLYGON,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon",
+      static_cast<double (*)(BatchFunction, EigenCoordsRef, ContinuousArgs*)>(&continuous_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon",
+      static_cast<double (*)(BatchFunction, STLCoords, ContinuousArgs*)>(&continuous_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon",
+      static_cast<double (*)(Function, EigenCoordsRef, DiscreteArgs*)>(&discrete_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_polygon",
       static_cast<double (*)(Function, STLCoords, DiscreteArgs*)>(&discrete_integration_over_polygon),
       F,
       POLYGON,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon",
+      static_cast<double (*)(MultiModalBivariateGaussian, EigenCoordsRef, DiscreteArgs*)>(
+          &discrete_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_polygon",
       static_cast<double (*)(MultiModalBivariateGaussian, STLCoords, DiscreteArgs*)>(&discrete_integration_over_polygon),
       F,
       POLYGON,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon",
+      static_cast<double (*)(BatchFunction, EigenCoordsRef, DiscreteArgs*)>(&discrete_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon",
+      static_cast<double (*)(BatchFunction, STLCoords, DiscreteArgs*)>(&discrete_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, DiscreteArgs*)>(
+          &discrete_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, STLCoords, DiscreteArgs*)>(
+          &discrete_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, DiscreteArgs*)>(
+          &discrete_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, DiscreteArgs*)>(
+          &discrete_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, EigenCoordsRef, DiscreteArgs*)>(
+          &discrete_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, STLCoords, DiscreteArgs*)>(
+          &discrete_integration_over_polygon_with_diagnostics),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_polygon",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, FixedArgs*)>(
+          &fixed_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_polygon",
+      static_cast<IntegrationResult (*)(Function, STLCoords, FixedArgs*)>(
+          &fixed_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_polygon",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, FixedArgs*)>(
+          &fixed_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_polygon",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, FixedArgs*)>(
+          &fixed_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_polygon",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, QmcArgs*)>(
+          &qmc_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_polygon",
+      static_cast<IntegrationResult (*)(Function, STLCoords, QmcArgs*)>(
+          &qmc_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_polygon",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, QmcArgs*)>(
+          &qmc_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_polygon",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, QmcArgs*)>(
+          &qmc_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_polygon",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, QuadtreeArgs*)>(
+          &quadtree_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_polygon",
+      static_cast<IntegrationResult (*)(Function, STLCoords, QuadtreeArgs*)>(
+          &quadtree_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_polygon",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, QuadtreeArgs*)>(
+          &quadtree_integration_over_polygon),
+      F,
+      POLYGON_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_polygon",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, QuadtreeArgs*)>(
+          &quadtree_integration_over_polygon),
+      F,
+      POLYGON,
+      ARGS,
+      RELEASE_GIL);
 
   auto LEFT = "left"_a;
   auto RIGHT = "right"_a;
@@ -118,7 +1050,8 @@ PYBIND11_MODULE(_core, m)
       RIGHT,
       BOTTOM,
       TOP,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_rectangle",
       static_cast<double (*)(MultiModalBivariateGaussian, double, double, double, double, ContinuousArgs*)>(
@@ -128,7 +1061,52 @@ PYBIND11_MODULE(_core, m)
       RIGHT,
       BOTTOM,
       TOP,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_rectangle",
+      static_cast<double (*)(BatchFunction, double, double, double, double, ContinuousArgs*)>(
+          &continuous_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, double, double, double, double, ContinuousArgs*)>(
+          &continuous_integration_over_rectangle_with_diagnostics),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, double, double, double, double, ContinuousArgs*)>(
+          &continuous_integration_over_rectangle_with_diagnostics),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, double, double, double, double, ContinuousArgs*)>(
+          &continuous_integration_over_rectangle_with_diagnostics),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_rectangle",
       static_cast<double (*)(Function, double, double, double, double, DiscreteArgs*)>(&discrete_integration_over_rectangle),
@@ -137,7 +1115,8 @@ PYBIND11_MODULE(_core, m)
       RIGHT,
       BOTTOM,
       TOP,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_rectangle",
       static_cast<double (*)(MultiModalBivariateGaussian, double, double, double, double, DiscreteArgs*)>(
@@ -147,109 +1126,1402 @@ PYBIND11_MODULE(_core, m)
       RIGHT,
       BOTTOM,
       TOP,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangle",
+      static_cast<double (*)(BatchFunction, double, double, double, double, DiscreteArgs*)>(
+          &discrete_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, double, double, double, double, DiscreteArgs*)>(
+          &discrete_integration_over_rectangle_with_diagnostics),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, double, double, double, double, DiscreteArgs*)>(
+          &discrete_integration_over_rectangle_with_diagnostics),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, double, double, double, double, DiscreteArgs*)>(
+          &discrete_integration_over_rectangle_with_diagnostics),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_rectangle",
+      static_cast<IntegrationResult (*)(Function, double, double, double, double, FixedArgs*)>(
+          &fixed_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_rectangle",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, double, double, double, double, FixedArgs*)>(
+          &fixed_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_rectangle",
+      static_cast<IntegrationResult (*)(Function, double, double, double, double, QmcArgs*)>(
+          &qmc_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_rectangle",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, double, double, double, double, QmcArgs*)>(
+          &qmc_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_rectangle",
+      static_cast<IntegrationResult (*)(Function, double, double, double, double, QuadtreeArgs*)>(
+          &quadtree_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_rectangle",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, double, double, double, double, QuadtreeArgs*)>(
+          &quadtree_integration_over_rectangle),
+      F,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      ARGS,
+      RELEASE_GIL);
 
   auto COORDS = "coords"_a;
+  auto COORDS_REF = "coords"_a.noconvert();
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(Function, EigenCoordsRef, ContinuousArgs*)>(&continuous_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_path",
       static_cast<double (*)(Function, STLCoords, ContinuousArgs*)>(&continuous_integration_over_path),
       F,
       COORDS,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_path",
       static_cast<double (*)(Function, EigenCoords, ContinuousArgs*)>(&continuous_integration_over_path),
       F,
       COORDS,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(MultiModalBivariateGaussian, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_path",
       static_cast<double (*)(MultiModalBivariateGaussian, STLCoords, ContinuousArgs*)>(&continuous_integration_over_path),
       F,
       COORDS,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_path",
       static_cast<double (*)(MultiModalBivariateGaussian, EigenCoords, ContinuousArgs*)>(&continuous_integration_over_path),
       F,
       COORDS,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
-      "discrete_integration_over_path",
-      static_cast<double (*)(Function, STLCoords, DiscreteArgs*)>(&discrete_integration_over_path),
+      "continuous_integration_over_path",
+      static_cast<double (*)(BatchFunction, EigenCoordsRef, ContinuousArgs*)>(&continuous_integration_over_path),
       F,
-      COORDS,
-      ARGS);
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
-      "discrete_integration_over_path",
-      static_cast<double (*)(Function, EigenCoords, DiscreteArgs*)>(&discrete_integration_over_path),
+      "continuous_integration_over_path",
+      static_cast<double (*)(BatchFunction, STLCoords, ContinuousArgs*)>(&continuous_integration_over_path),
       F,
       COORDS,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(BatchFunction, EigenCoords, ContinuousArgs*)>(&continuous_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(Function, EigenCoordsRef, ContinuousArgs*, WarmStart*)>(&continuous_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(Function, STLCoords, ContinuousArgs*, WarmStart*)>(&continuous_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(Function, EigenCoords, ContinuousArgs*, WarmStart*)>(&continuous_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(MultiModalBivariateGaussian, EigenCoordsRef, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(MultiModalBivariateGaussian, STLCoords, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path",
+      static_cast<double (*)(MultiModalBivariateGaussian, EigenCoords, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, EigenCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, STLCoords, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoords, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoords, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_gradient",
+      static_cast<ValueAndGradient (*)(Function, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_gradient),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_gradient",
+      static_cast<ValueAndGradient (*)(Function, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_gradient),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_gradient",
+      static_cast<ValueAndGradient (*)(Function, EigenCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_gradient),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_gradient",
+      static_cast<ValueAndGradient (*)(MultiModalBivariateGaussian, EigenCoordsRef, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_gradient),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_gradient",
+      static_cast<ValueAndGradient (*)(MultiModalBivariateGaussian, STLCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_gradient),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_path_with_gradient",
+      static_cast<ValueAndGradient (*)(MultiModalBivariateGaussian, EigenCoords, ContinuousArgs*)>(
+          &continuous_integration_over_path_with_gradient),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(Function, EigenCoordsRef, DiscreteArgs*)>(&discrete_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(Function, STLCoords, DiscreteArgs*)>(&discrete_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(Function, EigenCoords, DiscreteArgs*)>(&discrete_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(MultiModalBivariateGaussian, EigenCoordsRef, DiscreteArgs*)>(&discrete_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_path",
       static_cast<double (*)(MultiModalBivariateGaussian, STLCoords, DiscreteArgs*)>(&discrete_integration_over_path),
       F,
       COORDS,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_path",
       static_cast<double (*)(MultiModalBivariateGaussian, EigenCoords, DiscreteArgs*)>(&discrete_integration_over_path),
       F,
       COORDS,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(BatchFunction, EigenCoordsRef, DiscreteArgs*)>(&discrete_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(BatchFunction, STLCoords, DiscreteArgs*)>(&discrete_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(BatchFunction, EigenCoords, DiscreteArgs*)>(&discrete_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, STLCoords, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, EigenCoords, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoords, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, EigenCoordsRef, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, STLCoords, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, EigenCoords, DiscreteArgs*)>(
+          &discrete_integration_over_path_with_diagnostics),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, FixedArgs*)>(
+          &fixed_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, STLCoords, FixedArgs*)>(
+          &fixed_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, EigenCoords, FixedArgs*)>(
+          &fixed_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, FixedArgs*)>(
+          &fixed_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, FixedArgs*)>(
+          &fixed_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoords, FixedArgs*)>(
+          &fixed_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, QmcArgs*)>(
+          &qmc_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, STLCoords, QmcArgs*)>(
+          &qmc_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, EigenCoords, QmcArgs*)>(
+          &qmc_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, QmcArgs*)>(
+          &qmc_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, QmcArgs*)>(
+          &qmc_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoords, QmcArgs*)>(
+          &qmc_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, EigenCoordsRef, QuadtreeArgs*)>(
+          &quadtree_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, STLCoords, QuadtreeArgs*)>(
+          &quadtree_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_path",
+      static_cast<IntegrationResult (*)(Function, EigenCoords, QuadtreeArgs*)>(
+          &quadtree_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoordsRef, QuadtreeArgs*)>(
+          &quadtree_integration_over_path),
+      F,
+      COORDS_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, STLCoords, QuadtreeArgs*)>(
+          &quadtree_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_path",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, EigenCoords, QuadtreeArgs*)>(
+          &quadtree_integration_over_path),
+      F,
+      COORDS,
+      ARGS,
+      RELEASE_GIL);
 
+  // Every element is a view of its array, kept alive by the list for the duration of the call
   auto COORDS_VEC = "coords_vec"_a;
+  auto COORDS_VEC_REF = "coords_vec"_a.noconvert();
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(Function, std::vector<EigenCoordsRef>, ContinuousArgs*)>(&continuous_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_paths",
       static_cast<double (*)(Function, std::vector<STLCoords>, ContinuousArgs*)>(&continuous_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_paths",
       static_cast<double (*)(Function, std::vector<EigenCoords>, ContinuousArgs*)>(&continuous_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, ContinuousArgs*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_paths",
       static_cast<double (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, ContinuousArgs*)>(
           &continuous_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "continuous_integration_over_paths",
       static_cast<double (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, ContinuousArgs*)>(
           &continuous_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(BatchFunction, std::vector<EigenCoordsRef>, ContinuousArgs*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(BatchFunction, std::vector<STLCoords>, ContinuousArgs*)>(&continuous_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(BatchFunction, std::vector<EigenCoords>, ContinuousArgs*)>(&continuous_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(Function, std::vector<EigenCoordsRef>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(Function, std::vector<STLCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(Function, std::vector<EigenCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths",
+      static_cast<double (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoordsRef>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<STLCoords>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoords>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, std::vector<EigenCoordsRef>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, std::vector<STLCoords>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, std::vector<EigenCoords>, ContinuousArgs*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoordsRef>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<STLCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<
+          IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "continuous_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, ContinuousArgs*, WarmStart*)>(
+          &continuous_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      WARM_START,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths",
+      static_cast<double (*)(Function, std::vector<EigenCoordsRef>, DiscreteArgs*)>(&discrete_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_paths",
       static_cast<double (*)(Function, std::vector<STLCoords>, DiscreteArgs*)>(&discrete_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_paths",
       static_cast<double (*)(Function, std::vector<EigenCoords>, DiscreteArgs*)>(&discrete_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths",
+      static_cast<double (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, DiscreteArgs*)>(
+          &discrete_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_paths",
       static_cast<double (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, DiscreteArgs*)>(
           &discrete_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
+      ARGS,
+      RELEASE_GIL);
   m.def(
       "discrete_integration_over_paths",
       static_cast<double (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, DiscreteArgs*)>(
           &discrete_integration_over_paths),
       F,
       COORDS_VEC,
-      ARGS);
-}
\ No newline at end of file
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths",
+      static_cast<double (*)(BatchFunction, std::vector<EigenCoordsRef>, DiscreteArgs*)>(&discrete_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths",
+      static_cast<double (*)(BatchFunction, std::vector<STLCoords>, DiscreteArgs*)>(&discrete_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths",
+      static_cast<double (*)(BatchFunction, std::vector<EigenCoords>, DiscreteArgs*)>(&discrete_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoordsRef>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<STLCoords>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoords>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, std::vector<EigenCoordsRef>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, std::vector<STLCoords>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(BatchFunction, std::vector<EigenCoords>, DiscreteArgs*)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoordsRef>, FixedArgs*)>(
+          &fixed_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<STLCoords>, FixedArgs*)>(
+          &fixed_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoords>, FixedArgs*)>(
+          &fixed_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, FixedArgs*)>(
+          &fixed_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, FixedArgs*)>(
+          &fixed_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "fixed_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, FixedArgs*)>(
+          &fixed_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoordsRef>, QmcArgs*)>(
+          &qmc_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<STLCoords>, QmcArgs*)>(
+          &qmc_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoords>, QmcArgs*)>(
+          &qmc_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, QmcArgs*)>(
+          &qmc_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, QmcArgs*)>(
+          &qmc_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "qmc_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, QmcArgs*)>(
+          &qmc_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoordsRef>, QuadtreeArgs*)>(
+          &quadtree_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<STLCoords>, QuadtreeArgs*)>(
+          &quadtree_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_paths",
+      static_cast<IntegrationResult (*)(Function, std::vector<EigenCoords>, QuadtreeArgs*)>(
+          &quadtree_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoordsRef>, QuadtreeArgs*)>(
+          &quadtree_integration_over_paths),
+      F,
+      COORDS_VEC_REF,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<STLCoords>, QuadtreeArgs*)>(
+          &quadtree_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+  m.def(
+      "quadtree_integration_over_paths",
+      static_cast<IntegrationResult (*)(MultiModalBivariateGaussian, std::vector<EigenCoords>, QuadtreeArgs*)>(
+          &quadtree_integration_over_paths),
+      F,
+      COORDS_VEC,
+      ARGS,
+      RELEASE_GIL);
+
+  auto GRID = "grid"_a;
+  m.def(
+      "discrete_integration_over_polygon",
+      static_cast<double (*)(const DiscreteGrid&, STLCoords)>(&discrete_integration_over_polygon),
+      GRID,
+      POLYGON,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_polygon_with_diagnostics",
+      static_cast<IntegrationResult (*)(const DiscreteGrid&, STLCoords)>(
+          &discrete_integration_over_polygon_with_diagnostics),
+      GRID,
+      POLYGON,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangle",
+      static_cast<double (*)(const DiscreteGrid&, double, double, double, double)>(&discrete_integration_over_rectangle),
+      GRID,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(const DiscreteGrid&, double, double, double, double)>(
+          &discrete_integration_over_rectangle_with_diagnostics),
+      GRID,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(const DiscreteGrid&, STLCoords)>(&discrete_integration_over_path),
+      GRID,
+      COORDS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path",
+      static_cast<double (*)(const DiscreteGrid&, EigenCoords)>(&discrete_integration_over_path),
+      GRID,
+      COORDS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(const DiscreteGrid&, STLCoords)>(&discrete_integration_over_path_with_diagnostics),
+      GRID,
+      COORDS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_path_with_diagnostics",
+      static_cast<IntegrationResult (*)(const DiscreteGrid&, EigenCoords)>(
+          &discrete_integration_over_path_with_diagnostics),
+      GRID,
+      COORDS,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths",
+      static_cast<double (*)(const DiscreteGrid&, std::vector<STLCoords>)>(&discrete_integration_over_paths),
+      GRID,
+      COORDS_VEC,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths",
+      static_cast<double (*)(const DiscreteGrid&, std::vector<EigenCoords>)>(&discrete_integration_over_paths),
+      GRID,
+      COORDS_VEC,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(const DiscreteGrid&, std::vector<STLCoords>)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      GRID,
+      COORDS_VEC,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_paths_with_diagnostics",
+      static_cast<IntegrationResult (*)(const DiscreteGrid&, std::vector<EigenCoords>)>(
+          &discrete_integration_over_paths_with_diagnostics),
+      GRID,
+      COORDS_VEC,
+      RELEASE_GIL);
+
+  auto TABLE = "table"_a;
+  m.def(
+      "discrete_integration_over_rectangle",
+      static_cast<double (*)(const SummedAreaTable&, double, double, double, double)>(
+          &discrete_integration_over_rectangle),
+      TABLE,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangle_with_diagnostics",
+      static_cast<IntegrationResult (*)(const SummedAreaTable&, double, double, double, double)>(
+          &discrete_integration_over_rectangle_with_diagnostics),
+      TABLE,
+      LEFT,
+      RIGHT,
+      BOTTOM,
+      TOP,
+      RELEASE_GIL);
+  m.def(
+      "discrete_integration_over_rectangles",
+      &discrete_integration_over_rectangles,
+      TABLE,
+      "rectangles"_a,
+      RELEASE_GIL);
+
+  using jpathgen::sweep::SweepArgs;
+  py::class_<SweepArgs>(m, "SweepArgs")
+      .def(
+          py::init<double, std::vector<double>, std::vector<unsigned long>, std::vector<int>, int, double, unsigned long>(),
+          "buffer_radius_m"_a,
+          "rel_err_reqs"_a = std::vector<double>{ 1e-1, 3e-2, 1e-2, 3e-3, 1e-3, 1e-4, 1e-5 },
+          "max_evals"_a = std::vector<unsigned long>{ 1000, 10000, 100000 },
+          "grid_sizes"_a = std::vector<int>{ 25, 50, 100, 200, 400, 800, 1600 },
+          "n_repeats"_a = 3,
+          "reference_rel_err_req"_a = 1e-10,
+          "reference_max_eval"_a = 10000000)
+      .def_property_readonly("buffer_radius_m", &SweepArgs::get_buffer_radius_m)
+      .def_property_readonly("rel_err_reqs", &SweepArgs::get_rel_err_reqs)
+      .def_property_readonly("max_evals", &SweepArgs::get_max_evals)
+      .def_property_readonly("grid_sizes", &SweepArgs::get_grid_sizes)
+      .def_property_readonly("n_repeats", &SweepArgs::get_n_repeats)
+      .def_property_readonly("reference_rel_err_req", &SweepArgs::get_reference_rel_err_req)
+      .def_property_readonly("reference_max_eval", &SweepArgs::get_reference_max_eval);
+
+  // The GIL is released by accuracy_sweep for the sweep itself, and held again to convert its result to a dict
+  const char* ACCURACY_SWEEP_DOC =
+      "Time every setting of `args` integrating f over `paths` and compare it with a tight continuous integration. "
+      "Returns a dict of the reference values, their largest relative error estimate and a list of measurements, "
+      "each with its mode, settings, seconds, largest relative error over the paths and whether it is on the Pareto "
+      "frontier of seconds against error.";
+  m.def("accuracy_sweep", &accuracy_sweep<Function>, F, "paths"_a, ARGS, ACCURACY_SWEEP_DOC);
+  m.def("accuracy_sweep", &accuracy_sweep<MultiModalBivariateGaussian>, F, "paths"_a, ARGS, ACCURACY_SWEEP_DOC);
+
+  m.def(
+      "submit",
+      &submit,
+      "fn"_a,
+      "Call fn(*args, **kwargs) on a pool of native threads, one per hardware thread, and return a "
+      "concurrent.futures.Future of its result, which asyncio.wrap_future makes awaitable. The integrations release the "
+      "GIL while they run. A call cancelled before a thread has started it is never made.");
+  // Let the calls still queued finish before the interpreter goes away under them
+  py::module_::import("atexit").attr("register")(py::cpp_function(
+      []()
+      {
+        py::gil_scoped_release release;
+        jpathgen::async::default_pool().wait();
+      }));
+
+  py::module_ trace = m.def_submodule("trace", "Per-stage timing of the integration pipeline");
+  trace.def("enabled", &jpathgen::trace::enabled, "Whether the library was built with JPATHGEN_ENABLE_TRACING.");
+  trace.def(
+      "stats",
+      []()
+      {
+        jpathgen::trace::Stats snapshot = jpathgen::trace::stats();
+        py::dict stats;
+        for (std::size_t i = 0; i < jpathgen::trace::N_STAGES; i++)
+        {
+          stats[jpathgen::trace::to_string(static_cast<jpathgen::trace::Stage>(i))] = py::dict(
+              "calls"_a = snapshot[i].calls, "total_ns"_a = snapshot[i].total_ns, "max_ns"_a = snapshot[i].max_ns);
+        }
+        return stats;
+      },
+      "The number of calls, total and longest time in nanoseconds of every stage, summed over all threads.");
+  trace.def("reset", &jpathgen::trace::reset, "Zero the counters of every stage.");
+  trace.def(
+      "start_chrome_trace",
+      [](const std::string& path) { jpathgen::trace::set_sink(std::make_shared<jpathgen::trace::ChromeTraceSink>(path)); },
+      "path"_a,
+      "Write every stage to `path` in the Chrome trace event format until stop() is called.");
+  trace.def(
+      "stop", []() { jpathgen::trace::set_sink(nullptr); }, "Stop writing stages to the trace sink and close it.");
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include "jpathgen/sweep.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+
+#include "jpathgen/environment.h"
+#include "jpathgen/error.h"
+#include "jpathgen/function.h"
+#include "jpathgen/integration.h"
+
+namespace jpathgen
+{
+  namespace sweep
+  {
+    using geometry::EigenCoords;
+    using integration::ContinuousArgs;
+    using integration::DiscreteArgs;
+
+    namespace
+    {
+      /**
+       * Integrate over every path with integrate(path), n_repeats times, returning the fastest wall time and the values
+       * of the last repeat.
+       */
+      template<typename INTEGRATE>
+      double
+      time_paths(const std::vector<EigenCoords>& paths, int n_repeats, INTEGRATE integrate, std::vector<double>& values)
+      {
+        double seconds = std::numeric_limits<double>::infinity();
+        values.assign(paths.size(), 0);
+        for (int r = 0; r < std::max(n_repeats, 1); r++)
+        {
+          auto start = std::chrono::steady_clock::now();
+          for (std::size_t k = 0; k < paths.size(); k++)
+          {
+            values[k] = integrate(paths[k]);
+          }
+          seconds = std::min(seconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return seconds;
+      }
+
+      // The largest error relative to the reference, or absolute where the reference is 0
+      double largest_error(const std::vector<double>& values, const std::vector<double>& reference)
+      {
+        double error = 0;
+        for (std::size_t k = 0; k < values.size(); k++)
+        {
+          double scale = reference[k] == 0 ? 1 : std::abs(reference[k]);
+          error = std::max(error, std::abs(values[k] - reference[k]) / scale);
+        }
+        return error;
+      }
+
+      // JSON has no literal for infinities and NaN, so they are written as null
+      void write_number(std::ostream& out, double value)
+      {
+        if (std::isfinite(value))
+        {
+          out << value;
+        }
+        else
+        {
+          out << "null";
+        }
+      }
+    }  // namespace
+
+    template<typename FUNC>
+    SweepResult accuracy_sweep(FUNC f, const std::vector<EigenCoords>& paths, const SweepArgs& args)
+    {
+      Error(paths.empty(), "The sweep needs at least one path");
+      const double buffer_radius_m = args.get_buffer_radius_m();
+      SweepResult result;
+
+      ContinuousArgs reference_args(buffer_radius_m, 0, args.get_reference_rel_err_req(), args.get_reference_max_eval());
+      for (const EigenCoords& path : paths)
+      {
+        IntegrationResult reference =
+            integration::continuous_integration_over_path_with_diagnostics(f, path, &reference_args);
+        result.reference.push_back(reference.value);
+        double scale = reference.value == 0 ? 1 : std::abs(reference.value);
+        result.reference_error = std::max(result.reference_error, reference.error / scale);
+      }
+
+      std::vector<double> values;
+      for (double rel_err_req : args.get_rel_err_reqs())
+      {
+        for (unsigned long max_eval : args.get_max_evals())
+        {
+          ContinuousArgs continuous_args(buffer_radius_m, 0, rel_err_req, max_eval);
+          Measurement measurement;
+          measurement.mode = Mode::CONTINUOUS;
+          measurement.rel_err_req = rel_err_req;
+          measurement.max_eval = max_eval;
+          measurement.seconds = time_paths(
+              paths,
+              args.get_n_repeats(),
+              [&](const EigenCoords& path)
+              { return integration::continuous_integration_over_path(f, path, &continuous_args); },
+              values);
+          measurement.error = largest_error(values, result.reference);
+          result.measurements.push_back(measurement);
+        }
+      }
+
+      // The grid spans every buffered path, with M chosen for square cells
+      double minx = std::numeric_limits<double>::infinity(), maxx = -minx, miny = minx, maxy = -minx;
+      for (const EigenCoords& path : paths)
+      {
+        minx = std::min(minx, path.col(0).minCoeff() - buffer_radius_m);
+        maxx = std::max(maxx, path.col(0).maxCoeff() + buffer_radius_m);
+        miny = std::min(miny, path.col(1).minCoeff() - buffer_radius_m);
+        maxy = std::max(maxy, path.col(1).maxCoeff() + buffer_radius_m);
+      }
+      for (int N : args.get_grid_sizes())
+      {
+        const int M = std::max(2, static_cast<int>(std::lround(N * (maxy - miny) / std::max(maxx - minx, 1e-12))));
+        DiscreteArgs discrete_args(buffer_radius_m, N, M, minx, maxx, miny, maxy);
+        Measurement measurement;
+        measurement.mode = Mode::DISCRETE;
+        measurement.N = N;
+        measurement.M = M;
+        measurement.seconds = time_paths(
+            paths,
+            args.get_n_repeats(),
+            [&](const EigenCoords& path) { return integration::discrete_integration_over_path(f, path, &discrete_args); },
+            values);
+        measurement.error = largest_error(values, result.reference);
+        result.measurements.push_back(measurement);
+      }
+
+      mark_pareto_frontier(result.measurements);
+      return result;
+    }
+
+    template SweepResult
+    accuracy_sweep(environment::MultiModalBivariateGaussian, const std::vector<EigenCoords>&, const SweepArgs&);
+    template SweepResult accuracy_sweep(function::Function, const std::vector<EigenCoords>&, const SweepArgs&);
+    template SweepResult accuracy_sweep(double (*)(double, double), const std::vector<EigenCoords>&, const SweepArgs&);
+
+    void mark_pareto_frontier(std::vector<Measurement>& measurements)
+    {
+      std::vector<std::size_t> order(measurements.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(
+          order.begin(),
+          order.end(),
+          [&measurements](std::size_t a, std::size_t b)
+          {
+            return std::make_pair(measurements[a].seconds, measurements[a].error) <
+                   std::make_pair(measurements[b].seconds, measurements[b].error);
+          });
+      double best_error = std::numeric_limits<double>::infinity();
+      for (std::size_t k : order)
+      {
+        measurements[k].pareto = measurements[k].error < best_error;
+        best_error = std::min(best_error, measurements[k].error);
+      }
+    }
+
+    void write_json(std::ostream& out, const SweepResult& result)
+    {
+      std::ios::fmtflags flags = out.flags();
+      std::streamsize precision = out.precision();
+      out << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+      out << "{\n  \"reference\": [";
+      for (std::size_t k = 0; k < result.reference.size(); k++)
+      {
+        out << (k == 0 ? "" : ", ");
+        write_number(out, result.reference[k]);
+      }
+      out << "],\n  \"reference_error\": ";
+      write_number(out, result.reference_error);
+      out << ",\n  \"measurements\": [";
+      for (std::size_t k = 0; k < result.measurements.size(); k++)
+      {
+        const Measurement& measurement = result.measurements[k];
+        out << (k == 0 ? "\n" : ",\n") << "    {\"mode\": \"" << to_string(measurement.mode) << "\", ";
+        if (measurement.mode == Mode::CONTINUOUS)
+        {
+          out << "\"rel_err_req\": ";
+          write_number(out, measurement.rel_err_req);
+          out << ", \"max_eval\": " << measurement.max_eval << ", ";
+        }
+        else
+        {
+          out << "\"N\": " << measurement.N << ", \"M\": " << measurement.M << ", ";
+        }
+        out << "\"seconds\": ";
+        write_number(out, measurement.seconds);
+        out << ", \"error\": ";
+        write_number(out, measurement.error);
+        out << ", \"pareto\": " << (measurement.pareto ? "true" : "false") << "}";
+      }
+      out << "\n  ]\n}\n";
+
+      out.flags(flags);
+      out.precision(precision);
+    }
+  }  // namespace sweep
+}  // namespace jpathgen
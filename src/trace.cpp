@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include "jpathgen/trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "jpathgen/error.h"
+
+namespace jpathgen
+{
+  namespace trace
+  {
+    namespace
+    {
+      /**
+       * Only the owning thread writes to its counters, so relaxed loads and stores are enough. They are atomic so that
+       * stats() can read them from another thread.
+       */
+      struct Counters
+      {
+        std::array<std::atomic<std::uint64_t>, N_STAGES> calls{};
+        std::array<std::atomic<std::uint64_t>, N_STAGES> total_ns{};
+        std::array<std::atomic<std::uint64_t>, N_STAGES> max_ns{};
+
+        void add_to(Stats& stats) const
+        {
+          for (std::size_t i = 0; i < N_STAGES; i++)
+          {
+            stats[i].calls += calls[i].load(std::memory_order_relaxed);
+            stats[i].total_ns += total_ns[i].load(std::memory_order_relaxed);
+            stats[i].max_ns = std::max<std::uint64_t>(stats[i].max_ns, max_ns[i].load(std::memory_order_relaxed));
+          }
+        }
+
+        void clear()
+        {
+          for (std::size_t i = 0; i < N_STAGES; i++)
+          {
+            calls[i].store(0, std::memory_order_relaxed);
+            total_ns[i].store(0, std::memory_order_relaxed);
+            max_ns[i].store(0, std::memory_order_relaxed);
+          }
+        }
+      };
+
+      struct Registry
+      {
+        std::mutex mutex;
+        std::vector<Counters*> live;
+        Stats retired{};
+        std::shared_ptr<Sink> sink;
+        std::atomic<bool> has_sink{ false };
+      };
+
+      // Never destroyed, so that threads exiting after static destruction can still unregister.
+      Registry& registry()
+      {
+        static auto* r = new Registry;
+        return *r;
+      }
+
+      struct ThreadCounters
+      {
+        Counters counters;
+
+        ThreadCounters()
+        {
+          Registry& r = registry();
+          std::lock_guard<std::mutex> lock(r.mutex);
+          r.live.push_back(&counters);
+        }
+
+        ~ThreadCounters()
+        {
+          Registry& r = registry();
+          std::lock_guard<std::mutex> lock(r.mutex);
+          counters.add_to(r.retired);
+          r.live.erase(std::remove(r.live.begin(), r.live.end(), &counters), r.live.end());
+        }
+      };
+
+      ThreadCounters& local()
+      {
+        thread_local ThreadCounters counters;
+        return counters;
+      }
+
+      std::uint64_t to_ns(Clock::duration duration)
+      {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+      }
+    }  // namespace
+
+    /*********************
+     * CHROME TRACE SINK *
+     *********************/
+
+    ChromeTraceSink::ChromeTraceSink(std::ostream& out) : _out(&out)
+    {
+      *_out << "[";
+    }
+
+    ChromeTraceSink::ChromeTraceSink(const std::string& path)
+        : _file(std::make_unique<std::ofstream>(path)),
+          _out(_file.get())
+    {
+      Error(!_file->is_open(), "Could not open the trace file for writing");
+      *_out << "[";
+    }
+
+    ChromeTraceSink::~ChromeTraceSink()
+    {
+      *_out << "\n]\n";
+      _out->flush();
+    }
+
+    void ChromeTraceSink::record(Stage stage, Clock::time_point start, Clock::time_point end)
+    {
+      double ts_us = static_cast<double>(to_ns(start - _origin)) / 1000;
+      double dur_us = static_cast<double>(to_ns(end - start)) / 1000;
+      std::size_t tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+      std::lock_guard<std::mutex> lock(_mutex);
+      *_out << (_first ? "\n" : ",\n") << R"({"name":")" << to_string(stage) << R"(","cat":"jpathgen","ph":"X","ts":)"
+            << ts_us << R"(,"dur":)" << dur_us << R"(,"pid":0,"tid":)" << tid << "}";
+      _first = false;
+    }
+
+    /************
+     * COUNTERS *
+     ************/
+
+    void set_sink(std::shared_ptr<Sink> sink)
+    {
+      Registry& r = registry();
+      r.has_sink.store(sink != nullptr, std::memory_order_relaxed);
+      std::atomic_store(&r.sink, std::move(sink));
+    }
+
+    Stats stats()
+    {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      Stats stats = r.retired;
+      for (const Counters* counters : r.live)
+      {
+        counters->add_to(stats);
+      }
+      return stats;
+    }
+
+    Stats thread_stats()
+    {
+      Stats stats{};
+      local().counters.add_to(stats);
+      return stats;
+    }
+
+    void reset()
+    {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      r.retired = Stats{};
+      for (Counters* counters : r.live)
+      {
+        counters->clear();
+      }
+    }
+
+    void record(Stage stage, Clock::time_point start, Clock::time_point end)
+    {
+      std::size_t i = static_cast<std::size_t>(stage);
+      std::uint64_t ns = to_ns(end - start);
+
+      Counters& counters = local().counters;
+      counters.calls[i].store(counters.calls[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      counters.total_ns[i].store(counters.total_ns[i].load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+      if (ns > counters.max_ns[i].load(std::memory_order_relaxed))
+      {
+        counters.max_ns[i].store(ns, std::memory_order_relaxed);
+      }
+
+      if (registry().has_sink.load(std::memory_order_relaxed))
+      {
+        std::shared_ptr<Sink> sink = std::atomic_load(&registry().sink);
+        if (sink)
+        {
+          sink->record(stage, start, end);
+        }
+      }
+    }
+  }  // namespace trace
+}  // namespace jpathgen
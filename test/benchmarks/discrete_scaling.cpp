@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+/*
+ * Strong scaling of the discrete integration with the number of threads, on grids of 10^6 and 4 * 10^6 points over a
+ * buffered path covering most of the grid. The GMM is compute bound, the precomputed grid is memory bound and shows
+ * where the rasterisation and reduction overheads stop the scaling. Timings are wall clock, as the work is spread over
+ * threads the benchmark itself does not start. Every run past the single-threaded one of the same grid reports its
+ * speedup over it and its efficiency, the speedup per thread, so one run of the suite gives the scaling table.
+ */
+
+#include <benchmark/benchmark.h>
+#include <jpathgen/discrete_grid.h>
+#include <jpathgen/environment.h>
+#include <jpathgen/integration.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "fixtures.h"
+
+using namespace jpathgen::integration;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using namespace jpathgen::benchmarks;
+
+namespace
+{
+  // Wall time per iteration of the single-threaded run of each benchmark and grid side, which is registered first
+  std::map<std::pair<std::string, int>, double> single_thread_seconds;
+
+  void set_scaling(benchmark::State& state, const std::string& name, std::chrono::steady_clock::duration elapsed)
+  {
+    const int side = static_cast<int>(state.range(0)), n_threads = static_cast<int>(state.range(1));
+    const double seconds = std::chrono::duration<double>(elapsed).count() / static_cast<double>(state.iterations());
+    if (n_threads == 1)
+    {
+      single_thread_seconds[{ name, side }] = seconds;
+    }
+    auto single_thread = single_thread_seconds.find({ name, side });
+    if (single_thread != single_thread_seconds.end())
+    {
+      const double speedup = single_thread->second / seconds;
+      state.counters["speedup"] = speedup;
+      state.counters["efficiency"] = speedup / n_threads;
+    }
+  }
+
+  void BM_Path_Threads_GMM(benchmark::State& state)
+  {
+    const int side = static_cast<int>(state.range(0));
+    DiscreteArgs args(0.5, side, side, -2, 2, -2, 2, 0, static_cast<int>(state.range(1)));
+    MultiModalBivariateGaussian mmbg = generate_mmbg(5);
+    EigenCoords path = zigzag_path();
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_path(mmbg, path, &args));
+    }
+    set_scaling(state, "gmm", std::chrono::steady_clock::now() - start);
+    state.counters["points"] =
+        benchmark::Counter(static_cast<double>(side) * side, benchmark::Counter::kIsIterationInvariantRate);
+  }
+
+  void BM_Path_Threads_Grid(benchmark::State& state)
+  {
+    const int side = static_cast<int>(state.range(0));
+    DiscreteArgs args(0.5, side, side, -2, 2, -2, 2, 0, static_cast<int>(state.range(1)));
+    DiscreteGrid grid(generate_mmbg(5), args);
+    EigenCoords path = zigzag_path();
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_path(grid, path));
+    }
+    set_scaling(state, "grid", std::chrono::steady_clock::now() - start);
+    state.counters["points"] =
+        benchmark::Counter(static_cast<double>(side) * side, benchmark::Counter::kIsIterationInvariantRate);
+  }
+}  // namespace
+
+BENCHMARK(BM_Path_Threads_GMM)
+    ->ArgsProduct({ { 1000, 2000 }, { 1, 2, 4, 8, 16, 32 } })
+    ->ArgNames({ "side", "threads" })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Path_Threads_Grid)
+    ->ArgsProduct({ { 1000, 2000 }, { 1, 2, 4, 8, 16, 32 } })
+    ->ArgNames({ "side", "threads" })
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
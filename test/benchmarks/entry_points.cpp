@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+/*
+ * Every integration entry point over a path, paths, a polygon and a rectangle, with the GMM as the integrand. Each is
+ * parameterised over what drives its cost: the number of waypoints and modes, the buffer radius in tenths of a metre
+ * (radius_dm), and the grid side, tolerance (as 10^-tol) or refinement of its method. The _with_diagnostics variants
+ * run the same code and are left out. Run with --benchmark_format=json for machine-readable output.
+ */
+
+#include <benchmark/benchmark.h>
+#include <jpathgen/discrete_grid.h>
+#include <jpathgen/environment.h>
+#include <jpathgen/integration.h>
+
+#include <cmath>
+#include <vector>
+
+#include "fixtures.h"
+
+using namespace jpathgen::integration;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using namespace jpathgen::benchmarks;
+
+namespace
+{
+  std::vector<EigenCoords> generate_paths(int n_paths, int n_wps)
+  {
+    std::vector<EigenCoords> paths;
+    for (int k = 0; k < n_paths; k++)
+    {
+      paths.push_back(generate_path(n_wps));
+    }
+    return paths;
+  }
+
+  // A closed regular polygon of n_vertices vertices inscribed in the circle of radius 2 about the origin
+  STLCoords generate_polygon(int n_vertices)
+  {
+    STLCoords polygon;
+    for (int i = 0; i <= n_vertices; i++)
+    {
+      double angle = 2 * M_PI * (i % n_vertices) / n_vertices;
+      polygon.emplace_back(2 * std::cos(angle), 2 * std::sin(angle));
+    }
+    return polygon;
+  }
+
+  double radius(const benchmark::State& state, int k)
+  {
+    return static_cast<double>(state.range(k)) / 10;
+  }
+
+  double tolerance(const benchmark::State& state, int k)
+  {
+    return std::pow(10.0, -static_cast<double>(state.range(k)));
+  }
+
+  /***************
+   * OVER A PATH *
+   ***************/
+
+  void BM_Continuous_Path(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    ContinuousArgs args(radius(state, 2), 0, tolerance(state, 3));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(continuous_integration_over_path(mmbg, path, &args));
+    }
+  }
+
+  void BM_Continuous_Path_Gradient(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    ContinuousArgs args(radius(state, 2), 0, tolerance(state, 3));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(continuous_integration_over_path_with_gradient(mmbg, path, &args));
+    }
+  }
+
+  // Every iteration moves the last waypoint a little, as a planner refining a path would
+  void BM_Continuous_Path_Warm_Start(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    ContinuousArgs args(radius(state, 2), 0, tolerance(state, 3));
+    WarmStart warm_start;
+    int k = 0;
+    for (auto _ : state)
+    {
+      path(path.rows() - 1, 0) += (k++ % 2 == 0 ? 1e-3 : -1e-3);
+      benchmark::DoNotOptimize(continuous_integration_over_path(mmbg, path, &args, &warm_start));
+    }
+  }
+
+  void BM_Discrete_Path(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    const int side = static_cast<int>(state.range(3));
+    DiscreteArgs args(radius(state, 2), side, side, -5, 5, -5, 5);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_path(mmbg, path, &args));
+    }
+  }
+
+  void BM_Discrete_Grid_Path(benchmark::State& state)
+  {
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    const int side = static_cast<int>(state.range(3));
+    DiscreteArgs args(radius(state, 2), side, side, -5, 5, -5, 5);
+    DiscreteGrid grid(generate_mmbg(static_cast<int>(state.range(1))), args);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_path(grid, path));
+    }
+  }
+
+  void BM_Fixed_Path(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    FixedArgs args(radius(state, 2), static_cast<int>(state.range(3)));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(fixed_integration_over_path(mmbg, path, &args));
+    }
+  }
+
+  void BM_Qmc_Path(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    QmcArgs args(radius(state, 2), 1024, 8, 0, tolerance(state, 3));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(qmc_integration_over_path(mmbg, path, &args));
+    }
+  }
+
+  void BM_Quadtree_Path(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    QuadtreeArgs args(radius(state, 2), tolerance(state, 3));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(quadtree_integration_over_path(mmbg, path, &args));
+    }
+  }
+
+  /**************
+   * OVER PATHS *
+   **************/
+
+  void BM_Continuous_Paths(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(5);
+    std::vector<EigenCoords> paths = generate_paths(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    ContinuousArgs args(radius(state, 2), 0, 1e-3);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(continuous_integration_over_paths(mmbg, paths, &args));
+    }
+  }
+
+  void BM_Discrete_Paths(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(5);
+    std::vector<EigenCoords> paths = generate_paths(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    DiscreteArgs args(radius(state, 2), 500, 500, -5, 5, -5, 5);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_paths(mmbg, paths, &args));
+    }
+  }
+
+  void BM_Fixed_Paths(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(5);
+    std::vector<EigenCoords> paths = generate_paths(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    FixedArgs args(radius(state, 2));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(fixed_integration_over_paths(mmbg, paths, &args));
+    }
+  }
+
+  void BM_Qmc_Paths(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(5);
+    std::vector<EigenCoords> paths = generate_paths(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    QmcArgs args(radius(state, 2));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(qmc_integration_over_paths(mmbg, paths, &args));
+    }
+  }
+
+  void BM_Quadtree_Paths(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(5);
+    std::vector<EigenCoords> paths = generate_paths(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    QuadtreeArgs args(radius(state, 2), 1e-4);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(quadtree_integration_over_paths(mmbg, paths, &args));
+    }
+  }
+
+  /******************
+   * OVER A POLYGON *
+   ******************/
+
+  void BM_Continuous_Polygon(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    STLCoords polygon = generate_polygon(static_cast<int>(state.range(0)));
+    ContinuousArgs args(0, 0, tolerance(state, 2));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(continuous_integration_over_polygon(mmbg, polygon, &args));
+    }
+  }
+
+  void BM_Discrete_Polygon(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    STLCoords polygon = generate_polygon(static_cast<int>(state.range(0)));
+    const int side = static_cast<int>(state.range(2));
+    DiscreteArgs args(0, side, side, -5, 5, -5, 5);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_polygon(mmbg, polygon, &args));
+    }
+  }
+
+  void BM_Fixed_Polygon(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    STLCoords polygon = generate_polygon(static_cast<int>(state.range(0)));
+    FixedArgs args(0, static_cast<int>(state.range(2)));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(fixed_integration_over_polygon(mmbg, polygon, &args));
+    }
+  }
+
+  void BM_Qmc_Polygon(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    STLCoords polygon = generate_polygon(static_cast<int>(state.range(0)));
+    QmcArgs args(0, 1024, 8, 0, tolerance(state, 2));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(qmc_integration_over_polygon(mmbg, polygon, &args));
+    }
+  }
+
+  void BM_Quadtree_Polygon(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(1)));
+    STLCoords polygon = generate_polygon(static_cast<int>(state.range(0)));
+    QuadtreeArgs args(0, tolerance(state, 2));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(quadtree_integration_over_polygon(mmbg, polygon, &args));
+    }
+  }
+
+  /********************
+   * OVER A RECTANGLE *
+   ********************/
+
+  void BM_Continuous_Rectangle(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(0)));
+    ContinuousArgs args(0, 0, tolerance(state, 1));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(continuous_integration_over_rectangle(mmbg, -2, 2, -2, 2, &args));
+    }
+  }
+
+  void BM_Discrete_Rectangle(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(0)));
+    const int side = static_cast<int>(state.range(1));
+    DiscreteArgs args(0, side, side, -5, 5, -5, 5);
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_rectangle(mmbg, -2, 2, -2, 2, &args));
+    }
+  }
+
+  void BM_Summed_Area_Table_Rectangle(benchmark::State& state)
+  {
+    const int side = static_cast<int>(state.range(1));
+    DiscreteArgs args(0, side, side, -5, 5, -5, 5);
+    SummedAreaTable table(DiscreteGrid(generate_mmbg(static_cast<int>(state.range(0))), args));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(discrete_integration_over_rectangle(table, -2, 2, -2, 2));
+    }
+  }
+
+  void BM_Fixed_Rectangle(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(0)));
+    FixedArgs args(0, static_cast<int>(state.range(1)));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(fixed_integration_over_rectangle(mmbg, -2, 2, -2, 2, &args));
+    }
+  }
+
+  void BM_Qmc_Rectangle(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(0)));
+    QmcArgs args(0, 1024, 8, 0, tolerance(state, 1));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(qmc_integration_over_rectangle(mmbg, -2, 2, -2, 2, &args));
+    }
+  }
+
+  void BM_Quadtree_Rectangle(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(0)));
+    QuadtreeArgs args(0, tolerance(state, 1));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(quadtree_integration_over_rectangle(mmbg, -2, 2, -2, 2, &args));
+    }
+  }
+}  // namespace
+
+BENCHMARK(BM_Continuous_Path)
+    ->ArgsProduct({ { 2, 10, 50 }, { 1, 5, 25 }, { 1, 5, 20 }, { 2, 4, 6 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "tol" });
+BENCHMARK(BM_Continuous_Path_Gradient)
+    ->ArgsProduct({ { 2, 10, 50 }, { 1, 5, 25 }, { 1, 5, 20 }, { 2, 4, 6 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "tol" });
+BENCHMARK(BM_Continuous_Path_Warm_Start)
+    ->ArgsProduct({ { 2, 10, 50 }, { 1, 5, 25 }, { 1, 5, 20 }, { 2, 4, 6 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "tol" });
+BENCHMARK(BM_Discrete_Path)
+    ->ArgsProduct({ { 2, 10, 50 }, { 1, 5, 25 }, { 1, 5, 20 }, { 100, 500, 2000 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "side" });
+BENCHMARK(BM_Discrete_Grid_Path)
+    ->ArgsProduct({ { 2, 10, 50 }, { 5 }, { 1, 5, 20 }, { 100, 500, 2000 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "side" });
+BENCHMARK(BM_Fixed_Path)
+    ->ArgsProduct({ { 2, 10, 50 }, { 1, 5, 25 }, { 1, 5, 20 }, { 0, 1, 2 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "refinement" });
+BENCHMARK(BM_Qmc_Path)
+    ->ArgsProduct({ { 2, 10, 50 }, { 1, 5, 25 }, { 1, 5, 20 }, { 2, 3, 4 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "tol" });
+BENCHMARK(BM_Quadtree_Path)
+    ->ArgsProduct({ { 2, 10, 50 }, { 1, 5, 25 }, { 1, 5, 20 }, { 2, 4, 6 } })
+    ->ArgNames({ "waypoints", "modes", "radius_dm", "tol" });
+
+BENCHMARK(BM_Continuous_Paths)
+    ->ArgsProduct({ { 2, 8, 32 }, { 2, 10 }, { 1, 5, 20 } })
+    ->ArgNames({ "paths", "waypoints", "radius_dm" });
+BENCHMARK(BM_Discrete_Paths)
+    ->ArgsProduct({ { 2, 8, 32 }, { 2, 10 }, { 1, 5, 20 } })
+    ->ArgNames({ "paths", "waypoints", "radius_dm" });
+BENCHMARK(BM_Fixed_Paths)
+    ->ArgsProduct({ { 2, 8, 32 }, { 2, 10 }, { 1, 5, 20 } })
+    ->ArgNames({ "paths", "waypoints", "radius_dm" });
+BENCHMARK(BM_Qmc_Paths)
+    ->ArgsProduct({ { 2, 8, 32 }, { 2, 10 }, { 1, 5, 20 } })
+    ->ArgNames({ "paths", "waypoints", "radius_dm" });
+BENCHMARK(BM_Quadtree_Paths)
+    ->ArgsProduct({ { 2, 8, 32 }, { 2, 10 }, { 1, 5, 20 } })
+    ->ArgNames({ "paths", "waypoints", "radius_dm" });
+
+BENCHMARK(BM_Continuous_Polygon)
+    ->ArgsProduct({ { 4, 64 }, { 1, 5, 25 }, { 2, 4, 6 } })
+    ->ArgNames({ "vertices", "modes", "tol" });
+BENCHMARK(BM_Discrete_Polygon)
+    ->ArgsProduct({ { 4, 64 }, { 1, 5, 25 }, { 100, 500, 2000 } })
+    ->ArgNames({ "vertices", "modes", "side" });
+BENCHMARK(BM_Fixed_Polygon)
+    ->ArgsProduct({ { 4, 64 }, { 1, 5, 25 }, { 0, 1, 2 } })
+    ->ArgNames({ "vertices", "modes", "refinement" });
+BENCHMARK(BM_Qmc_Polygon)->ArgsProduct({ { 4, 64 }, { 1, 5, 25 }, { 2, 3, 4 } })->ArgNames({ "vertices", "modes", "tol" });
+BENCHMARK(BM_Quadtree_Polygon)
+    ->ArgsProduct({ { 4, 64 }, { 1, 5, 25 }, { 2, 4, 6 } })
+    ->ArgNames({ "vertices", "modes", "tol" });
+
+BENCHMARK(BM_Continuous_Rectangle)->ArgsProduct({ { 1, 5, 25 }, { 2, 4, 6 } })->ArgNames({ "modes", "tol" });
+BENCHMARK(BM_Discrete_Rectangle)->ArgsProduct({ { 1, 5, 25 }, { 100, 500, 2000 } })->ArgNames({ "modes", "side" });
+BENCHMARK(BM_Summed_Area_Table_Rectangle)->ArgsProduct({ { 5 }, { 100, 500, 2000 } })->ArgNames({ "modes", "side" });
+BENCHMARK(BM_Fixed_Rectangle)->ArgsProduct({ { 1, 5, 25 }, { 0, 1, 2 } })->ArgNames({ "modes", "refinement" });
+BENCHMARK(BM_Qmc_Rectangle)->ArgsProduct({ { 1, 5, 25 }, { 2, 3, 4 } })->ArgNames({ "modes", "tol" });
+BENCHMARK(BM_Quadtree_Rectangle)->ArgsProduct({ { 1, 5, 25 }, { 2, 4, 6 } })->ArgNames({ "modes", "tol" });
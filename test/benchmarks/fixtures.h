@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#ifndef JPATHGEN_BENCHMARKS_FIXTURES_H
+#define JPATHGEN_BENCHMARKS_FIXTURES_H
+
+#include <jpathgen/environment.h>
+#include <jpathgen/geometry.h>
+
+/*
+ * The inputs shared by every benchmark, so that their timings stay comparable.
+ */
+namespace jpathgen
+{
+  namespace benchmarks
+  {
+    // n_modes modes with random means in [-1, 1]^2 and identity covariances
+    inline environment::MultiModalBivariateGaussian generate_mmbg(int n_modes)
+    {
+      environment::MUS mus = environment::MUS::Random(n_modes, 2);
+      environment::COVS covs = environment::COVS::Zero(n_modes * 2, 2);
+      for (int i = 0; i < n_modes; ++i)
+      {
+        covs.block<2, 2>(i * 2, 0) = environment::COV::Identity();
+      }
+      return { mus, covs };
+    }
+
+    // A random walk of n_wps waypoints from the origin, with steps of up to 0.5 in either direction
+    inline geometry::EigenCoords generate_path(int n_wps)
+    {
+      geometry::EigenCoords path = geometry::EigenCoords::Zero(n_wps, 2);
+      for (int i = 1; i < n_wps; i++)
+      {
+        path.row(i) = path.row(i - 1) + Eigen::RowVector2d::Random() * 0.5;
+      }
+      return path;
+    }
+
+    // A fixed path of three waypoints, bent once about the origin
+    inline geometry::EigenCoords bent_path()
+    {
+      geometry::EigenCoords path(3, 2);
+      path << -1, -1, 0, 1, 1, -1;
+      return path;
+    }
+
+    // A fixed zigzag of five waypoints over [-1.5, 1.5]^2, which covers most of [-2, 2]^2 once buffered by 0.5
+    inline geometry::EigenCoords zigzag_path()
+    {
+      geometry::EigenCoords path(5, 2);
+      path << -1.5, -1.5, 1.5, -1.5, -1.5, 0, 1.5, 0, -1.5, 1.5;
+      return path;
+    }
+  }  // namespace benchmarks
+}  // namespace jpathgen
+
+#endif  // JPATHGEN_BENCHMARKS_FIXTURES_H
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+/*
+ * The cost of reaching the integrand. BM_Dispatch runs the native cubature of jpathgen::cubature on the same triangles
+ * with the same budget and only changes how the integrand is passed: as its own type, so that it is inlined into the
+ * rule loop, behind a std::function, or behind a cubpackpp::Function as the cubpackpp-backed integrations wrap it. The
+ * GMM passed as its own type is also called with every node of a split at once, which gmm_pointwise hides behind a
+ * pointwise lambda.
+ *
+ * The remaining benchmarks compare the cubpackpp-backed integrations with the inlined ones end to end. They differ in
+ * their adaptive algorithm as well as in the dispatch, so they do not spend the same number of evaluations.
+ * All run with rel_err_req = 0 so that they spend the full max_eval budget, and the evals counter is the number of
+ * evaluations the integration reports.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cubpackpp/cubpackpp.h>
+#include <jpathgen/cubature.h>
+#include <jpathgen/environment.h>
+#include <jpathgen/inline_integration.h>
+#include <jpathgen/integration.h>
+
+#include <functional>
+#include <vector>
+
+#include "fixtures.h"
+
+using namespace jpathgen::integration;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using namespace jpathgen::benchmarks;
+using jpathgen::IntegrationResult;
+using jpathgen::cubature::Triangle;
+
+namespace
+{
+  double constant_return_fn(double a, double b)
+  {
+    return 1;
+  }
+
+  template<typename FUNC>
+  auto pointwise(FUNC f)
+  {
+    return [f](double x, double y) { return f(x, y); };
+  }
+
+  template<typename FUNC>
+  std::function<double(double, double)> as_std_function(FUNC f)
+  {
+    return pointwise(f);
+  }
+
+  // As the cubpackpp-backed integrations call FUNC, through a cubpackpp::Function taking a cubpackpp::Point
+  template<typename FUNC>
+  auto as_cubpackpp_function(FUNC f)
+  {
+    cubpackpp::Function function = [f](const cubpackpp::Point& pt) { return f(pt.X(), pt.Y()); };
+    return [function](double x, double y) { return function(cubpackpp::Point(x, y)); };
+  }
+
+  // The triangles inlined::continuous_integration_over_path integrates over
+  std::vector<Triangle> path_triangles(const EigenCoords& path, double buffer_radius_m)
+  {
+    auto buffered = buffer_linestring(create_linestring(coord_sequence_from_array(path)), buffer_radius_m);
+    return geos_to_triangles(triangulate_polygon(std::move(buffered)));
+  }
+
+  const std::vector<Triangle> RECTANGLE{ Triangle{ -2, -2, 2, -2, 2, 2 }, Triangle{ -2, -2, 2, 2, -2, 2 } };
+
+  void set_evals(benchmark::State& state, unsigned long n_evals)
+  {
+    state.counters["evals"] =
+        benchmark::Counter(static_cast<double>(n_evals), benchmark::Counter::kIsIterationInvariantRate);
+  }
+
+  template<typename FUNC>
+  void BM_Dispatch(benchmark::State& state, FUNC f)
+  {
+    IntegrationResult result;
+    for (auto _ : state)
+    {
+      result = jpathgen::cubature::integrate(f, RECTANGLE, 0, 0, state.range(0));
+      benchmark::DoNotOptimize(result);
+    }
+    set_evals(state, result.n_evals);
+  }
+
+  template<typename FUNC>
+  void BM_Rectangle_Cubpackpp(benchmark::State& state, FUNC f)
+  {
+    ContinuousArgs args(1.0, 0, 0, state.range(0));
+    IntegrationResult result;
+    for (auto _ : state)
+    {
+      result = continuous_integration_over_rectangle_with_diagnostics(f, -2, 2, -2, 2, &args);
+      benchmark::DoNotOptimize(result);
+    }
+    set_evals(state, result.n_evals);
+  }
+
+  template<typename FUNC>
+  void BM_Rectangle_Inlined(benchmark::State& state, FUNC f)
+  {
+    ContinuousArgs args(1.0, 0, 0, state.range(0));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(inlined::continuous_integration_over_rectangle(f, -2, 2, -2, 2, &args));
+    }
+    // The inlined integrations only return the value, the cubature is deterministic so a separate run gives n_evals
+    set_evals(state, jpathgen::cubature::integrate(f, RECTANGLE, 0, 0, state.range(0)).n_evals);
+  }
+
+  template<typename FUNC>
+  void BM_Path_Cubpackpp(benchmark::State& state, FUNC f)
+  {
+    ContinuousArgs args(1.0, 0, 0, state.range(0));
+    EigenCoords path = bent_path();
+    IntegrationResult result;
+    for (auto _ : state)
+    {
+      result = continuous_integration_over_path_with_diagnostics(f, path, &args);
+      benchmark::DoNotOptimize(result);
+    }
+    set_evals(state, result.n_evals);
+  }
+
+  template<typename FUNC>
+  void BM_Path_Inlined(benchmark::State& state, FUNC f)
+  {
+    ContinuousArgs args(1.0, 0, 0, state.range(0));
+    EigenCoords path = bent_path();
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(inlined::continuous_integration_over_path(f, path, &args));
+    }
+    set_evals(state, jpathgen::cubature::integrate(f, path_triangles(path, 1.0), 0, 0, state.range(0)).n_evals);
+  }
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Dispatch, gmm, generate_mmbg(5))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, gmm_pointwise, pointwise(generate_mmbg(5)))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, gmm_std_function, as_std_function(generate_mmbg(5)))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, gmm_cubpackpp_function, as_cubpackpp_function(generate_mmbg(5)))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, fn_ptr, &constant_return_fn)->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, fn_ptr_std_function, as_std_function(&constant_return_fn))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Dispatch, fn_ptr_cubpackpp_function, as_cubpackpp_function(&constant_return_fn))
+    ->Range(1 << 10, 1 << 16);
+
+BENCHMARK_CAPTURE(BM_Rectangle_Cubpackpp, gmm, generate_mmbg(5))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Rectangle_Inlined, gmm, generate_mmbg(5))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Rectangle_Inlined, gmm_pointwise, pointwise(generate_mmbg(5)))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Rectangle_Cubpackpp, fn_ptr, &constant_return_fn)->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Rectangle_Inlined, fn_ptr, &constant_return_fn)->Range(1 << 10, 1 << 16);
+
+BENCHMARK_CAPTURE(BM_Path_Cubpackpp, gmm, generate_mmbg(5))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Path_Inlined, gmm, generate_mmbg(5))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Path_Inlined, gmm_pointwise, pointwise(generate_mmbg(5)))->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Path_Cubpackpp, fn_ptr, &constant_return_fn)->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Path_Inlined, fn_ptr, &constant_return_fn)->Range(1 << 10, 1 << 16);
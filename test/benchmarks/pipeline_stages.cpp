@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+/*
+ * The stages every path goes through before it is integrated over, timed on their own: evaluating the GMM, converting
+ * the waypoints to a GEOS coordinate sequence, buffering the linestring, taking the union of the buffered paths and
+ * triangulating the result. Inputs consumed by a stage are rebuilt outside of the timed region.
+ */
+
+#include <benchmark/benchmark.h>
+#include <jpathgen/environment.h>
+#include <jpathgen/geometry.h>
+
+#include <vector>
+
+#include "fixtures.h"
+
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using namespace jpathgen::benchmarks;
+
+namespace
+{
+  STLCoords to_stl(const EigenCoords& path)
+  {
+    STLCoords coords;
+    for (Eigen::Index i = 0; i < path.rows(); i++)
+    {
+      coords.emplace_back(path(i, 0), path(i, 1));
+    }
+    return coords;
+  }
+
+  std::unique_ptr<geos::geom::Geometry> buffered_path(const EigenCoords& path, double buffer_radius_m)
+  {
+    return buffer_linestring(create_linestring(coord_sequence_from_array(path)), buffer_radius_m);
+  }
+
+  void BM_GMM_Evaluation(benchmark::State& state)
+  {
+    MultiModalBivariateGaussian mmbg = generate_mmbg(static_cast<int>(state.range(0)));
+    EigenCoords points = EigenCoords::Random(1024, 2) * 2;
+    for (auto _ : state)
+    {
+      double sum = 0;
+      for (Eigen::Index i = 0; i < points.rows(); i++)
+      {
+        sum += mmbg(points(i, 0), points(i, 1));
+      }
+      benchmark::DoNotOptimize(sum);
+    }
+    state.counters["evals"] =
+        benchmark::Counter(static_cast<double>(points.rows()), benchmark::Counter::kIsIterationInvariantRate);
+  }
+
+  template<typename COORDS>
+  void BM_Coord_Conversion(benchmark::State& state, COORDS (*convert)(const EigenCoords&))
+  {
+    COORDS path = convert(generate_path(static_cast<int>(state.range(0))));
+    for (auto _ : state)
+    {
+      benchmark::DoNotOptimize(coord_sequence_from_array(path));
+    }
+    state.counters["waypoints"] = benchmark::Counter(static_cast<double>(state.range(0)));
+  }
+
+  EigenCoords as_eigen(const EigenCoords& path)
+  {
+    return path;
+  }
+
+  void BM_Buffer(benchmark::State& state)
+  {
+    EigenCoords path = generate_path(static_cast<int>(state.range(0)));
+    const double buffer_radius_m = static_cast<double>(state.range(1)) / 10;
+    for (auto _ : state)
+    {
+      state.PauseTiming();
+      std::unique_ptr<geos::geom::LineString> linestring = create_linestring(coord_sequence_from_array(path));
+      state.ResumeTiming();
+      benchmark::DoNotOptimize(buffer_linestring(std::move(linestring), buffer_radius_m));
+    }
+  }
+
+  void BM_Union(benchmark::State& state)
+  {
+    const double buffer_radius_m = static_cast<double>(state.range(2)) / 10;
+    std::vector<std::unique_ptr<geos::geom::Geometry>> buffered;
+    for (int k = 0; k < state.range(0); k++)
+    {
+      buffered.push_back(buffered_path(generate_path(static_cast<int>(state.range(1))), buffer_radius_m));
+    }
+    for (auto _ : state)
+    {
+      std::unique_ptr<geos::geom::Geometry> union_buffered_paths = buffered[0]->clone();
+      for (std::size_t k = 1; k < buffered.size(); k++)
+      {
+        union_buffered_paths = union_buffered_paths->Union(buffered[k].get());
+      }
+      benchmark::DoNotOptimize(union_buffered_paths);
+    }
+  }
+
+  void BM_Triangulation(benchmark::State& state)
+  {
+    std::unique_ptr<geos::geom::Geometry> buffered =
+        buffered_path(generate_path(static_cast<int>(state.range(0))), static_cast<double>(state.range(1)) / 10);
+    for (auto _ : state)
+    {
+      state.PauseTiming();
+      std::unique_ptr<geos::geom::Geometry> polygon = buffered->clone();
+      state.ResumeTiming();
+      benchmark::DoNotOptimize(triangulate_polygon(std::move(polygon)));
+    }
+    state.counters["vertices"] = benchmark::Counter(static_cast<double>(buffered->getNumPoints()));
+  }
+}  // namespace
+
+BENCHMARK(BM_GMM_Evaluation)->ArgName("modes")->RangeMultiplier(5)->Range(1, 125);
+
+BENCHMARK_CAPTURE(BM_Coord_Conversion, eigen, &as_eigen)->ArgName("waypoints")->RangeMultiplier(10)->Range(2, 2000);
+BENCHMARK_CAPTURE(BM_Coord_Conversion, stl, &to_stl)->ArgName("waypoints")->RangeMultiplier(10)->Range(2, 2000);
+
+BENCHMARK(BM_Buffer)->ArgsProduct({ { 2, 10, 100, 1000 }, { 1, 5, 20 } })->ArgNames({ "waypoints", "radius_dm" });
+
+BENCHMARK(BM_Union)
+    ->ArgsProduct({ { 2, 8, 32 }, { 10, 100 }, { 1, 5, 20 } })
+    ->ArgNames({ "paths", "waypoints", "radius_dm" });
+
+BENCHMARK(BM_Triangulation)->ArgsProduct({ { 2, 10, 100, 1000 }, { 1, 5, 20 } })->ArgNames({ "waypoints", "radius_dm" });
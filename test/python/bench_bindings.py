@@ -0,0 +1,186 @@
+#  Copyright (c) 2024.  Jan-Hendrik Ewers
+#  SPDX-License-Identifier: GPL-3.0-only
+"""
+Time every function exported by libjpathgen through the bindings, as called from Python. Each is called with every
+integrand it accepts (the native GMM, a Python callable, a VectorizedFunction and a precomputed grid or table) and with
+NumPy arrays, Fortran-ordered and float32 arrays and lists of tuples, at a small and a large size. C-contiguous float64
+arrays are read in place, anything else is converted first. The last column compares each time with that of the
+native GMM on the same input, which shows the cost of calling back into Python.
+
+    python test/python/bench_bindings.py [--repeat N] [--filter REGEX] [--json PATH]
+"""
+import argparse
+import json
+import math
+import pickle
+import re
+import timeit
+
+import numpy as np
+import libjpathgen
+
+SIZES = {"small": 5, "large": 200}
+METHOD_ARGS = {
+    "continuous": lambda: libjpathgen.ContinuousArgs(0.5),
+    "discrete": lambda: libjpathgen.DiscreteArgs(0.5, 100, 100, -5, 5, -5, 5),
+    "fixed": lambda: libjpathgen.FixedArgs(0.5),
+    "qmc": lambda: libjpathgen.QmcArgs(0.5, 1024, 4),
+    "quadtree": lambda: libjpathgen.QuadtreeArgs(0.5, 1e-3, 6),
+}
+ENTRY_POINT = re.compile(r"^(?P<method>[a-z]+)_integration_over_(?P<region>paths?|polygon|rectangles?)(?:_with_\w+)?$")
+
+
+def gaussian(x, y):
+    return math.exp(-(x * x + y * y) / 2) / (2 * math.pi)
+
+
+def vectorized_gaussian(xs, ys):
+    return np.exp(-(xs * xs + ys * ys) / 2) / (2 * np.pi)
+
+
+def as_inputs(coords: np.ndarray) -> dict:
+    return {
+        "ndarray": np.ascontiguousarray(coords),
+        "ndarray (fortran)": np.asfortranarray(coords),
+        "ndarray (float32)": coords.astype(np.float32),
+        "list": [tuple(c) for c in coords],
+    }
+
+
+def random_walk(n_wps: int, rng: np.random.Generator) -> np.ndarray:
+    # Steps shrink with the number of waypoints, so that paths of every size cover about the same area
+    return np.cumsum(rng.uniform(-1, 1, (n_wps, 2)) * 2 / math.sqrt(n_wps), axis=0)
+
+
+def regular_polygon(n_vertices: int) -> np.ndarray:
+    angles = 2 * np.pi * np.arange(n_vertices + 1) / n_vertices
+    return 2 * np.column_stack((np.cos(angles), np.sin(angles)))
+
+
+def unit_gmm() -> libjpathgen.MultiModalBivariateGaussian:
+    # The same function as gaussian, so that the native and Python integrands do the same work
+    return libjpathgen.MultiModalBivariateGaussian(np.zeros((1, 2)), np.eye(2))
+
+
+def has_no_overload(function: str, integrand: str) -> bool:
+    """Whether the bindings are expected to reject this integrand for the entry point, which is then not timed. Only
+    the summed-area table integrates over many rectangles, and the fixed, QMC and quadtree integrations and the
+    gradient have no VectorizedFunction overloads."""
+    match = ENTRY_POINT.match(function)
+    if match is None:
+        return False
+    if match["region"] == "rectangles":
+        return integrand != "table"
+    batched = match["method"] in ("continuous", "discrete") and not function.endswith("_with_gradient")
+    return integrand == "vectorized" and not batched
+
+
+def integrands(method: str, region: str) -> dict:
+    mmbg = unit_gmm()
+    found = {
+        "gmm": mmbg,
+        "callable": gaussian,
+        "vectorized": libjpathgen.VectorizedFunction(vectorized_gaussian),
+    }
+    if method == "discrete":
+        found["grid"] = libjpathgen.DiscreteGrid(mmbg, METHOD_ARGS["discrete"]())
+        if region.startswith("rectangle"):
+            found["table"] = libjpathgen.SummedAreaTable(found["grid"])
+    return found
+
+
+def entry_point_calls(rng: np.random.Generator):
+    """Yield (function, integrand, input, size, call) for every integration entry point."""
+    for function in libjpathgen.__all__:
+        match = ENTRY_POINT.match(function)
+        if match is None:
+            continue
+        fn = getattr(libjpathgen, function)
+        method, region = match["method"], match["region"]
+        args = METHOD_ARGS[method]()
+        for integrand, f in integrands(method, region).items():
+            if has_no_overload(function, integrand):
+                continue
+            # The grid and the table carry their own arguments
+            extra = () if integrand in ("grid", "table") else (args,)
+            if region == "rectangle":
+                yield function, integrand, "-", "-", lambda fn=fn, f=f, extra=extra: fn(f, -2, 2, -2, 2, *extra)
+                continue
+            for size, n in SIZES.items():
+                if region == "rectangles":
+                    rectangles = np.sort(rng.uniform(-4, 4, (n * 8, 4)).reshape(-1, 2, 2), axis=2).reshape(-1, 4)
+                    inputs = {"ndarray": rectangles}
+                elif region == "polygon":
+                    inputs = as_inputs(regular_polygon(n))
+                elif region == "path":
+                    inputs = as_inputs(random_walk(n, rng))
+                else:
+                    inputs = {name: [coords] * 8 for name, coords in as_inputs(random_walk(n, rng)).items()}
+                for name, coords in inputs.items():
+                    yield function, integrand, name, size, lambda fn=fn, f=f, c=coords, extra=extra: fn(f, c, *extra)
+
+
+def other_calls(rng: np.random.Generator):
+    """Yield (function, integrand, input, size, call) for the exported functions other than the integrations."""
+    mmbg = unit_gmm()
+    args = METHOD_ARGS["discrete"]()
+    yield "MultiModalBivariateGaussian.__call__", "gmm", "float", "-", lambda: mmbg(0.1, 0.2)
+    for size, n in (("small", 16), ("large", 100_000)):
+        xs, ys = rng.uniform(-2, 2, n), rng.uniform(-2, 2, n)
+        yield "MultiModalBivariateGaussian.__call__", "gmm", "ndarray", size, lambda xs=xs, ys=ys: mmbg(xs, ys)
+    yield "DiscreteGrid", "gmm", "-", "-", lambda: libjpathgen.DiscreteGrid(mmbg, args)
+    yield "DiscreteGrid", "callable", "-", "-", lambda: libjpathgen.DiscreteGrid(gaussian, args)
+    grid = libjpathgen.DiscreteGrid(mmbg, args)
+    yield "SummedAreaTable", "grid", "-", "-", lambda: libjpathgen.SummedAreaTable(grid)
+    state = pickle.dumps(grid)
+    yield "pickle.loads(DiscreteGrid)", "grid", "bytes", "-", lambda: pickle.loads(state)
+
+    for size, n in SIZES.items():
+        path = random_walk(n, rng)
+        for integrand, f in (("gmm", mmbg), ("callable", gaussian)):
+            # Every timed step starts from a fresh tracker, as stepping over the same segment again covers nothing new
+            for name, coords in as_inputs(path[:2]).items():
+                yield "CoverageTracker.step", integrand, name, size, lambda f=f, c=coords: libjpathgen.CoverageTracker(
+                    f, args).step(c)
+        yield "submit", "gmm", "ndarray", size, lambda p=path: libjpathgen.submit(
+            libjpathgen.continuous_integration_over_path, mmbg, p, libjpathgen.ContinuousArgs(0.5)).result()
+
+
+def time_call(call, repeat: int) -> float:
+    timer = timeit.Timer(call)
+    number, _ = timer.autorange()
+    number = max(1, min(number, repeat))
+    return min(timer.repeat(number=number, repeat=3)) / number
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--repeat", type=int, default=2000, help="most calls per timing")
+    parser.add_argument("--filter", default="", help="only time the functions matching this regular expression")
+    parser.add_argument("--json", help="also write the timings to this file as a list of JSON objects")
+    args = parser.parse_args()
+
+    rng = np.random.default_rng(0)
+    results = []
+    header = f"{'function':<56}{'integrand':<12}{'input':<20}{'size':<8}{'us/call':>12}{'vs gmm':>10}"
+    print(header)
+    print("-" * len(header))
+    for calls in (entry_point_calls(rng), other_calls(rng)):
+        for function, integrand, name, size, call in calls:
+            if not re.search(args.filter, function):
+                continue
+            t = time_call(call, args.repeat)
+            gmm = next((r["s_per_call"] for r in results if r["integrand"] == "gmm" and
+                        (r["function"], r["input"], r["size"]) == (function, name, size)), None)
+            ratio = f"{t / gmm:>10.1f}" if gmm else f"{'':>10}"
+            print(f"{function:<56}{integrand:<12}{name:<20}{size:<8}{t * 1e6:>12.2f}{ratio}")
+            results.append({"function": function, "integrand": integrand, "input": name, "size": size,
+                            "s_per_call": t})
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
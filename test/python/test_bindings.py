@@ -1,6 +1,12 @@
 #  Copyright (c) 2024.  Jan-Hendrik Ewers
 #  SPDX-License-Identifier: GPL-3.0-only
+import asyncio
+import dataclasses
+import io
+import os
+import pickle
 import textwrap
+import threading
 import warnings
 
 import pytest
@@ -9,7 +15,9 @@ import libjpathgen
 
 from typing import Type, Callable
 import itertools
+import json
 import re
+from multiprocessing.shared_memory import SharedMemory
 
 
 @pytest.fixture(params=[np.eye(2)])
@@ -62,6 +70,53 @@ def test_MMBG_vectorized_call_has_same_result(mmbg, inp):
     assert np.allclose(exp, act)
 
 
+@pytest.mark.parametrize("x_shape,y_shape", [((50,), (50,)), ((1, 3000), (40, 1)), ((3, 1, 7), (5, 1)), ((), (4, 2))])
+@pytest.mark.parametrize("n_threads", [1, 0])
+def test_MMBG_vectorized_call_broadcasts(mmbg, x_shape, y_shape, n_threads):
+    rng = np.random.default_rng(0)
+    x, y = rng.normal(size=x_shape), rng.normal(size=y_shape)
+    act = mmbg(x, y, n_threads=n_threads)
+
+    xb, yb = np.broadcast_arrays(x, y)
+    assert act.shape == xb.shape
+    exp = np.array([mmbg(xi, yi) for xi, yi in zip(xb.flat, yb.flat)]).reshape(xb.shape)
+    assert np.allclose(act, exp, rtol=1e-12, atol=0)
+
+
+def test_MMBG_vectorized_call_writes_to_out(mmbg):
+    x = np.linspace(-1, 1, 11)
+    y = np.linspace(-1, 1, 7)[:, None]
+    out = np.empty((7, 11))
+    assert mmbg(x, y, out=out) is out
+    assert np.allclose(out, mmbg(np.broadcast_to(x, (7, 11)).copy(), np.broadcast_to(y, (7, 11)).copy()))
+
+    # out may be one of the inputs
+    xs = np.broadcast_to(x, (7, 11)).copy()
+    exp = mmbg(xs, y)
+    mmbg(xs, y, out=xs)
+    assert np.array_equal(xs, exp)
+
+    with pytest.raises(ValueError):
+        mmbg(x, y, out=np.empty((7, 10)))
+    with pytest.raises(ValueError):
+        mmbg(np.zeros(3), np.zeros(4))
+
+
+def test_MMBG_vectorized_call_accepts_views_that_are_not_strided_by_whole_doubles(mmbg):
+    # Fields of a packed structured array are strided by 12 bytes, and the second starts 4 bytes in
+    points = np.zeros(50, dtype=np.dtype([("x", "<f8"), ("pad", "<i4")], align=False))
+    points["x"] = np.linspace(-1, 1, 50)
+    x = points["x"]
+    assert x.strides == (12,)
+    assert np.array_equal(mmbg(x, 0.5), mmbg(x.copy(), 0.5))
+
+    raw = np.zeros(50 * 8 + 1, dtype=np.uint8)
+    y = raw[1:].view(np.float64)
+    y[:] = np.linspace(-1, 1, 50)
+    assert not y.flags.aligned
+    assert np.array_equal(mmbg(0.5, y), mmbg(0.5, y.copy()))
+
+
 @pytest.mark.parametrize("bounds,exp", [
     [(0., 1., 0., 1.), 1.],
     [(0., 2., 0., 1.), 2.],
@@ -90,6 +145,350 @@ def testdiscrete_integration_over_rectangle(bounds, exp):
     assert np.isclose(act, exp, rtol=1e-1)
 
 
+@pytest.mark.parametrize("refinement", [0, 1, 2])
+@pytest.mark.parametrize("bounds,exp", [
+    [(0., 1., 0., 1.), 1.],
+    [(0., 2., 0., 1.), 2.],
+    [(100., 200., 50., 150.), 100. * 100.],
+])
+def test_fixed_integration_over_rectangle(bounds, exp, refinement):
+    act = libjpathgen.fixed_integration_over_rectangle(lambda x, y: 1, *bounds, libjpathgen.FixedArgs(2.5, refinement))
+    assert np.isclose(act.value, exp)
+    assert act.error >= 0
+
+
+@pytest.mark.parametrize("path", [np.array([[0., 0.], [1., 1.], [2., 0.]]), [(0., 0.), (1., 1.), (2., 0.)]])
+def test_fixed_integration_over_path(mmbg, path):
+    exp = libjpathgen.continuous_integration_over_path(mmbg, path, libjpathgen.ContinuousArgs(0.5, 0, 1e-8))
+    act = libjpathgen.fixed_integration_over_path(mmbg, path, libjpathgen.FixedArgs(0.5, 2))
+    assert np.isclose(act.value, exp, atol=max(act.error, 1e-8))
+
+
+@pytest.mark.parametrize("convert", [np.ascontiguousarray, np.asfortranarray, lambda a: a.astype(np.float32),
+                                     lambda a: [tuple(row) for row in a]])
+def test_path_and_polygon_inputs_give_the_same_result(mmbg, convert):
+    path = np.array([[0., 0.], [1., 1.], [2., 0.]])
+    polygon = np.array([[0., 0.], [0., 1.], [1., 1.], [1., 0.], [0., 0.]])
+    args = libjpathgen.FixedArgs(0.5)
+    exp = libjpathgen.fixed_integration_over_path(mmbg, path, args)
+    assert libjpathgen.fixed_integration_over_path(mmbg, convert(path), args) == exp
+    exp = libjpathgen.fixed_integration_over_paths(mmbg, [path, path[::-1].copy()], args)
+    assert libjpathgen.fixed_integration_over_paths(mmbg, [convert(path), convert(path[::-1])], args) == exp
+    exp = libjpathgen.fixed_integration_over_polygon(mmbg, [tuple(row) for row in polygon], args)
+    assert libjpathgen.fixed_integration_over_polygon(mmbg, convert(polygon), args) == exp
+
+
+@pytest.mark.parametrize("path", [np.array([[0., 0.], [1., 1.], [2., 0.]]), [(0., 0.), (1., 1.), (2., 0.)]])
+def test_continuous_integration_over_path_with_diagnostics(mmbg, path):
+    args = libjpathgen.ContinuousArgs(0.5, 0, 1e-4)
+    exp = libjpathgen.continuous_integration_over_path(mmbg, path, args)
+    act = libjpathgen.continuous_integration_over_path_with_diagnostics(mmbg, path, args)
+    assert dataclasses.is_dataclass(act)
+    assert isinstance(act, libjpathgen.IntegrationResult)
+    assert act.value == exp
+    assert act.error >= 0
+    assert act.n_evals > 0
+    assert act.n_regions > 0
+    assert act.termination == libjpathgen.Termination.CONVERGED
+
+
+def test_continuous_integration_over_path_with_deadline(mmbg):
+    path = [(0., 0.), (1., 1.), (2., 0.)]
+    exp = libjpathgen.continuous_integration_over_path(mmbg, path, libjpathgen.ContinuousArgs(0.5, 0, 1e-6))
+    args = libjpathgen.ContinuousArgs(0.5, 0, 1e-14, max_eval=100_000_000, deadline_s=1e-9)
+    act = libjpathgen.continuous_integration_over_path_with_diagnostics(mmbg, path, args)
+    assert act.termination == libjpathgen.Termination.DEADLINE
+    assert np.isclose(act.value, exp, rtol=1e-2)
+
+
+def test_discrete_integration_over_rectangle_with_diagnostics():
+    # Grid points on the edges of the rectangle are left out, so the grid is offset by half a cell to keep them off it
+    args = libjpathgen.DiscreteArgs(0, 100, 100, -0.005, 1.005, -0.005, 1.005)
+    act = libjpathgen.discrete_integration_over_rectangle_with_diagnostics(lambda x, y: 1, 0, 1, 0, 1, args)
+    assert np.isclose(act.value, 1, rtol=1e-2)
+    assert act.n_regions == 100 * 100
+    assert act.termination == libjpathgen.Termination.FIXED_BUDGET
+
+
+@pytest.mark.parametrize("f", [lambda x, y: np.exp(-x * x - y * y), "mmbg"])
+def test_discrete_integration_over_paths_with_threads(mmbg, f):
+    f = mmbg if f == "mmbg" else f
+    paths = [[(0., 0.), (1., 1.), (2., 0.)], [(-1., -1.), (0., 1.)]]
+    exp = libjpathgen.discrete_integration_over_paths(f, paths, libjpathgen.DiscreteArgs(0.5, 200, 200, -2, 3, -2, 2))
+    args = libjpathgen.DiscreteArgs(0.5, 200, 200, -2, 3, -2, 2, n_threads=4)
+    assert args.n_threads == 4
+    assert libjpathgen.discrete_integration_over_paths(f, paths, args) == exp
+
+
+def test_vectorized_function_is_called_once_per_batch(mmbg):
+    batch_sizes = []
+
+    def f(xs, ys):
+        batch_sizes.append(len(xs))
+        return mmbg(xs, ys)
+
+    vectorized = libjpathgen.VectorizedFunction(f)
+    paths = [[(0., 0.), (1., 1.), (2., 0.)], np.array([[-1., -1.], [0., 1.]])]
+    args = libjpathgen.DiscreteArgs(0.5, 200, 200, -2, 3, -2, 2, n_threads=4)
+    exp = libjpathgen.discrete_integration_over_paths(mmbg, paths, args)
+    assert np.isclose(libjpathgen.discrete_integration_over_paths(vectorized, paths, args), exp, rtol=1e-12)
+    assert sum(batch_sizes) > 10 * len(batch_sizes)
+
+    batch_sizes.clear()
+    args = libjpathgen.ContinuousArgs(0.5, 0, 1e-6)
+    exp = libjpathgen.continuous_integration_over_path(mmbg, paths[0], args)
+    act = libjpathgen.continuous_integration_over_path_with_diagnostics(vectorized, paths[0], args)
+    assert np.isclose(act.value, exp, rtol=1e-4)
+    assert sum(batch_sizes) == act.n_evals
+    assert sum(batch_sizes) > 10 * len(batch_sizes)
+
+
+def test_vectorized_function_must_return_one_value_per_point():
+    vectorized = libjpathgen.VectorizedFunction(lambda xs, ys: 1.0)
+    with pytest.raises(ValueError):
+        libjpathgen.continuous_integration_over_rectangle(vectorized, 0, 1, 0, 1, libjpathgen.ContinuousArgs(0))
+
+
+def test_discrete_integration_with_fractional_coverage():
+    args = libjpathgen.DiscreteArgs(0, 41, 41, -2, 2, -2, 2, fractional_coverage=True)
+    assert args.fractional_coverage
+    act = libjpathgen.discrete_integration_over_rectangle(lambda x, y: 1, -0.73, 1.18, -1.01, 0.57, args)
+    assert np.isclose(act, 1.91 * 1.58, rtol=1e-12)
+
+
+def test_discrete_grid_evaluates_every_integrand_on_several_threads(mmbg):
+    args = libjpathgen.DiscreteArgs(0.5, 64, 48, -2, 3, -2, 2, n_threads=4)
+    exp = libjpathgen.DiscreteGrid(mmbg, args).values
+    vectorized = libjpathgen.VectorizedFunction(lambda xs, ys: np.exp(-(xs * xs + ys * ys) / 2) / (2 * np.pi))
+    for f in (vectorized, lambda x, y: mmbg(x, y)):
+        assert np.allclose(libjpathgen.DiscreteGrid(f, args).values, exp, rtol=1e-12, atol=0)
+
+
+@pytest.mark.parametrize("single_precision", [False, True])
+def test_discrete_grid_matches_direct_integration(mmbg, single_precision):
+    args = libjpathgen.DiscreteArgs(0.5, 64, 48, -2, 3, -2, 2)
+    grid = libjpathgen.DiscreteGrid(mmbg, args, single_precision=single_precision)
+    assert grid.values.shape == (64, 48)
+    assert grid.single_precision == single_precision
+
+    rtol = 1e-6 if single_precision else 1e-12
+    paths = [[(0., 0.), (1., 1.), (2., 0.)], np.array([[-1., -1.], [0., 1.]])]
+    for path in paths:
+        exp = libjpathgen.discrete_integration_over_path(mmbg, path, args)
+        assert np.isclose(libjpathgen.discrete_integration_over_path(grid, path), exp, rtol=rtol)
+    exp = libjpathgen.discrete_integration_over_paths(mmbg, paths, args)
+    assert np.isclose(libjpathgen.discrete_integration_over_paths(grid, paths), exp, rtol=rtol)
+    exp = libjpathgen.discrete_integration_over_rectangle(mmbg, -1, 1, -1, 1, args)
+    assert np.isclose(libjpathgen.discrete_integration_over_rectangle(grid, -1, 1, -1, 1), exp, rtol=rtol)
+
+
+def test_summed_area_table_rectangles(mmbg):
+    grid = libjpathgen.DiscreteGrid(mmbg, libjpathgen.DiscreteArgs(0, 41, 33, -20, 20, -16, 16))
+    table = libjpathgen.SummedAreaTable(grid)
+    rectangles = np.array([[-2, 3, -1, 4], [-2.5, 3.5, -1.5, 4.5], [-20, 20, -16, 16]])
+    act = libjpathgen.discrete_integration_over_rectangles(table, rectangles)
+    assert act.shape == (3,)
+    for value, rectangle in zip(act, rectangles):
+        assert value == libjpathgen.discrete_integration_over_rectangle(table, *rectangle)
+        assert np.isclose(value, libjpathgen.discrete_integration_over_rectangle(grid, *rectangle), rtol=0, atol=1e-12)
+
+
+def test_environments_are_pickled(mmbg):
+    args = libjpathgen.DiscreteArgs(0.5, 64, 48, -2, 3, -2, 2, deadline_s=1.5, n_threads=2, fractional_coverage=True)
+    act = pickle.loads(pickle.dumps(args))
+    for name in ("buffer_radius_m", "N", "M", "minx", "maxx", "miny", "maxy", "deadline_s", "n_threads",
+                 "fractional_coverage"):
+        assert getattr(act, name) == getattr(args, name)
+
+    act = pickle.loads(pickle.dumps(mmbg))
+    assert np.array_equal(act._mus, mmbg._mus)
+    assert np.array_equal(act._covs, mmbg._covs)
+    assert act(0.3, -0.2) == mmbg(0.3, -0.2)
+
+    path = [(0., 0.), (1., 1.), (2., 0.)]
+    for single_precision in (False, True):
+        grid = libjpathgen.DiscreteGrid(mmbg, args, single_precision=single_precision)
+        act = pickle.loads(pickle.dumps(grid))
+        assert act.single_precision == single_precision
+        assert np.array_equal(act.values, grid.values)
+        assert libjpathgen.discrete_integration_over_path(act, path) == libjpathgen.discrete_integration_over_path(
+            grid, path)
+
+    table = libjpathgen.SummedAreaTable(grid)
+    act = pickle.loads(pickle.dumps(table))
+    rectangles = np.array([[-1, 1, -1, 1], [-1.5, 2.5, -0.5, 1.5]])
+    assert np.array_equal(libjpathgen.discrete_integration_over_rectangles(act, rectangles),
+                          libjpathgen.discrete_integration_over_rectangles(table, rectangles))
+
+
+def test_environments_are_read_from_shared_memory(mmbg):
+    grid = libjpathgen.DiscreteGrid(mmbg, libjpathgen.DiscreteArgs(0.5, 64, 48, -2, 3, -2, 2))
+    table = libjpathgen.SummedAreaTable(grid)
+    for obj in (mmbg, grid, table):
+        shm = libjpathgen.to_shared_memory(obj)
+        try:
+            attached = SharedMemory(name=shm.name)
+            act = type(obj).from_buffer(attached.buf)
+            assert act.__getstate__() == obj.__getstate__()
+            del act
+            attached.close()
+        finally:
+            shm.close()
+            shm.unlink()
+
+    with pytest.raises(ValueError):
+        libjpathgen.DiscreteGrid.from_buffer(table.__getstate__())
+    with pytest.raises(ValueError):
+        libjpathgen.DiscreteGrid.from_buffer(grid.__getstate__()[:-8])
+
+
+def test_submit_runs_integrations_in_the_background(mmbg):
+    paths = [np.array([[0., 0.], [1., 1.], [2., k]]) for k in range(8)]
+    args = libjpathgen.ContinuousArgs(0.5)
+    futures = [libjpathgen.submit(libjpathgen.continuous_integration_over_path, mmbg, path, args=args) for path in paths]
+    for future, path in zip(futures, paths):
+        assert future.result(timeout=60) == libjpathgen.continuous_integration_over_path(mmbg, path, args)
+
+    async def awaited():
+        return await asyncio.wrap_future(libjpathgen.submit(libjpathgen.fixed_integration_over_path, mmbg, paths[0],
+                                                            libjpathgen.FixedArgs(0.5)))
+
+    exp = libjpathgen.fixed_integration_over_path(mmbg, paths[0], libjpathgen.FixedArgs(0.5))
+    assert asyncio.run(awaited()) == exp
+
+    with pytest.raises(ValueError):
+        libjpathgen.submit(libjpathgen.MultiModalBivariateGaussian.from_buffer, b"").result(timeout=60)
+
+
+def test_submitted_calls_are_cancelled_until_started():
+    release = threading.Event()
+    # More calls than threads, so that the one cancelled is still queued behind them
+    blocking = [libjpathgen.submit(release.wait) for _ in range(2 * (os.cpu_count() or 1))]
+    calls = []
+    cancelled = libjpathgen.submit(calls.append, 1)
+    assert cancelled.cancel()
+    release.set()
+    for future in blocking:
+        assert future.result(timeout=60)
+    assert cancelled.cancelled()
+    assert libjpathgen.submit(calls.append, 2).result(timeout=60) is None
+    assert calls == [2]
+
+
+def test_accuracy_sweep_finds_the_cheapest_setting(mmbg, tmp_path, capsys):
+    paths = [np.array([[-1., 0.], [1., 0.]]), np.array([[-1., -1.], [0., 1.], [1., -1.]])]
+    args = libjpathgen.SweepArgs(0.5, rel_err_reqs=[1e-1, 1e-4], max_evals=[1000, 100000], grid_sizes=[20, 200],
+                                 n_repeats=1)
+    result = libjpathgen.accuracy_sweep(mmbg, paths, args)
+    assert np.allclose(result["reference"], [libjpathgen.continuous_integration_over_path(
+        mmbg, path, libjpathgen.ContinuousArgs(0.5, rel_err_req=1e-10, max_eval=10000000)) for path in paths])
+    assert [m["mode"] for m in result["measurements"]] == ["continuous"] * 4 + ["discrete"] * 2
+
+    frontier = libjpathgen.pareto_frontier(result)
+    assert len(frontier) > 0
+    # Every step along the frontier costs more time and buys a smaller error
+    for faster, slower in zip(frontier, frontier[1:]):
+        assert faster["seconds"] <= slower["seconds"]
+        assert faster["error"] > slower["error"]
+    assert libjpathgen.cheapest_setting(result, np.inf) == frontier[0]
+    assert libjpathgen.cheapest_setting(result, -1) is None
+    best = min(m["error"] for m in result["measurements"])
+    assert libjpathgen.cheapest_setting(result, best)["error"] == best
+
+    file = tmp_path / "sweep.txt"
+    file.write_text("# A single mode at the origin\nmode 0 0 1 0 0 1\npath -1 0 1 0\npath -1 -1 0 1 1 -1\n")
+    assert libjpathgen._sweep.main([str(file), "--buffer-radius", "0.5", "--repeats", "1", "--rel-err-reqs", "1e-3",
+                                    "--max-evals", "100000", "--grid-sizes", "50"]) == 0
+    printed = json.loads(capsys.readouterr().out)
+    assert np.allclose(printed["reference"], result["reference"])
+    assert len(printed["measurements"]) == 2
+    assert libjpathgen._sweep.main([str(file), "--buffer-radius", "0.5", "--max-error", "-1"]) == 1
+
+    # JSON has no literal for infinities and NaN
+    out = io.StringIO()
+    libjpathgen._sweep.write_json({"reference": [1.0, np.nan], "reference_error": np.inf}, out)
+    assert json.loads(out.getvalue()) == {"reference": [1.0, None], "reference_error": None}
+
+
+def test_coverage_tracker_rewards_newly_covered_mass(mmbg):
+    args = libjpathgen.DiscreteArgs(0.5, 200, 200, -2, 3, -2, 2)
+    path = np.array([[0., 0.], [1., 1.], [2., 0.], [0.5, 0.2]])
+    tracker = libjpathgen.CoverageTracker(mmbg, args)
+    rewards = [tracker.step(path[k:k + 2]) for k in range(len(path) - 1)]
+    assert all(reward > 0 for reward in rewards)
+    segments = [path[k:k + 2] for k in range(len(path) - 1)]
+    exp = libjpathgen.discrete_integration_over_paths(mmbg, segments, args)
+    assert np.isclose(sum(rewards), exp, rtol=1e-12)
+    assert np.isclose(tracker.value, exp, rtol=1e-12)
+    assert tracker.step([(0., 0.), (1., 1.)]) == 0
+
+    tracker.reset()
+    assert tracker.value == 0
+    assert tracker.n_evals == 0
+
+
+@pytest.mark.parametrize("path", [np.array([[0., 0.], [1., 1.], [2., 0.]]), [(0., 0.), (1., 1.), (2., 0.)]])
+@pytest.mark.parametrize("rel_err_req", [0, 1e-4])
+def test_qmc_integration_over_path(mmbg, path, rel_err_req):
+    exp = libjpathgen.continuous_integration_over_path(mmbg, path, libjpathgen.ContinuousArgs(0.5, 0, 1e-8))
+    act = libjpathgen.qmc_integration_over_path(mmbg, path, libjpathgen.QmcArgs(0.5, rel_err_req=rel_err_req))
+    assert act.error > 0
+    assert np.isclose(act.value, exp, rtol=0, atol=5 * act.error)
+
+
+@pytest.mark.parametrize("path", [np.array([[0., 0.], [1., 1.], [2., 0.]]), [(0., 0.), (1., 1.), (2., 0.)]])
+def test_quadtree_integration_over_path(mmbg, path):
+    exp = libjpathgen.continuous_integration_over_path(mmbg, path, libjpathgen.ContinuousArgs(0.5, 0, 1e-8))
+    act = libjpathgen.quadtree_integration_over_path(mmbg, path, libjpathgen.QuadtreeArgs(0.5, target_error=1e-3))
+    assert act.n_regions > 0
+    assert np.isclose(act.value, exp, rtol=0, atol=act.error)
+
+
+@pytest.mark.parametrize("path", [np.array([[0., 0.], [1., 1.], [2., 0.]]), [(0., 0.), (1., 1.), (2., 0.)]])
+def test_continuous_integration_over_path_with_gradient(mmbg, path):
+    args = libjpathgen.ContinuousArgs(0.5, 0, 1e-10)
+    value, gradient = libjpathgen.continuous_integration_over_path_with_gradient(mmbg, path, args)
+    assert np.isclose(value, libjpathgen.continuous_integration_over_path(mmbg, path, args))
+    assert gradient.shape == (3, 2)
+
+    h = 1e-4
+    path = np.asarray(path)
+    fd = np.zeros_like(gradient)
+    for i, j in itertools.product(range(3), range(2)):
+        step = np.zeros_like(path)
+        step[i, j] = h
+        fd[i, j] = (libjpathgen.continuous_integration_over_path(mmbg, path + step, args) -
+                    libjpathgen.continuous_integration_over_path(mmbg, path - step, args)) / (2 * h)
+    assert np.allclose(gradient, fd, rtol=0, atol=1e-2 * np.abs(gradient).max())
+
+
+@pytest.mark.parametrize("path", [np.array([[0., 0.], [1., 1.], [2., 0.]]), [(0., 0.), (1., 1.), (2., 0.)]])
+def test_continuous_integration_over_path_with_warm_start(mmbg, path):
+    args = libjpathgen.ContinuousArgs(0.5, 0, 1e-6)
+    warm_start = libjpathgen.WarmStart()
+    assert not warm_start
+
+    exp = libjpathgen.continuous_integration_over_path(mmbg, path, args)
+    for _ in range(2):
+        act = libjpathgen.continuous_integration_over_path(mmbg, path, args, warm_start)
+        assert warm_start
+        assert warm_start.n_evals > 0
+        assert np.isclose(act, exp)
+
+    with pytest.raises(TypeError):
+        libjpathgen.continuous_integration_over_path(mmbg, path, args, None)
+
+
+def test_trace_stats(mmbg):
+    libjpathgen.trace.reset()
+    libjpathgen.continuous_integration_over_path(mmbg, [(0., 0.), (1., 1.)], libjpathgen.ContinuousArgs(0.5))
+    stats = libjpathgen.trace.stats()
+    assert {"coord_conversion", "buffer", "triangulation", "cubature"} <= stats.keys()
+    expected_calls = 1 if libjpathgen.trace.enabled() else 0
+    assert stats["buffer"]["calls"] == expected_calls
+    assert stats["cubature"]["calls"] == expected_calls
+
+
 def get_methods(cls: type, include_base: bool = True):
     fns_and_classes = []
 
@@ -99,7 +498,10 @@ def get_methods(cls: type, include_base: bool = True):
     for f in filter(lambda f: (not f.startswith("_")) and f in cls.__dict__, dir(cls)):
         maybe_callable = cls.__dict__[f]
 
-        if isinstance(maybe_callable, type):
+        if dataclasses.is_dataclass(maybe_callable):
+            # The generated __init__ of a dataclass has no docstring, its arguments are the documented fields
+            fns_and_classes.append(maybe_callable)
+        elif isinstance(maybe_callable, type):
             fns_and_classes.append(maybe_callable.__init__)
         elif isinstance(maybe_callable, Callable):
             fns_and_classes.append(maybe_callable)
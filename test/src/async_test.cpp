@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/async.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <chrono>
+#include <cstring>
+
+#include "jpathgen/environment.h"
+#include "jpathgen/error.h"
+#include "jpathgen/integration.h"
+
+using namespace jpathgen::async;
+using namespace jpathgen::integration;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using Catch::Matchers::WithinRel;
+
+TEST_CASE("Submitted tasks return their results through futures", "[async]")
+{
+  ThreadPool pool(3);
+  REQUIRE(pool.size() == 3);
+
+  std::vector<std::future<int>> futures;
+  for (int k = 0; k < 100; k++)
+  {
+    futures.push_back(pool.submit([](int a, int b) { return a * b; }, k, k + 1));
+  }
+  for (int k = 0; k < 100; k++)
+  {
+    REQUIRE(futures[k].get() == k * (k + 1));
+  }
+
+  std::atomic<int> n_runs{ 0 };
+  for (int k = 0; k < 10; k++)
+  {
+    pool.submit([&n_runs]() { n_runs++; });
+  }
+  pool.wait();
+  REQUIRE(n_runs == 10);
+}
+
+TEST_CASE("An exception is rethrown by the future", "[async]")
+{
+  ThreadPool pool(1);
+  std::future<double> future = pool.submit(
+      []() -> double
+      {
+        jpathgen::Error(true, "Failed");
+        return 0;
+      });
+  REQUIRE_THROWS(future.get());
+}
+
+TEST_CASE("A task cancelled before it starts is not run", "[async]")
+{
+  ThreadPool pool(1);
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::future<void> blocking = pool.submit([released]() { released.wait(); });
+
+  Cancellation cancellation;
+  bool ran = false;
+  std::future<void> cancelled = pool.submit(cancellation, [&ran]() { ran = true; });
+  cancellation.cancel();
+  release.set_value();
+
+  blocking.get();
+  try
+  {
+    cancelled.get();
+    FAIL("The cancelled task returned");
+  }
+  catch (const char* message)
+  {
+    REQUIRE(std::strcmp(message, "The task was cancelled") == 0);
+  }
+  REQUIRE_FALSE(ran);
+}
+
+TEST_CASE("Integrations run on the default pool", "[async, integration, geos]")
+{
+  EigenCoords path = Eigen::Matrix<double, -1, 2>::Random(5, 2);
+  MUS mus = Eigen::Matrix<double, -1, 2>::Zero(1, 2);
+  COVS covs = COV::Identity();
+  MultiModalBivariateGaussian mmbg(mus, covs);
+  auto *continuous_args = new ContinuousArgs(1);
+  auto *discrete_args = new DiscreteArgs(1, 100, 100, -3, 3, -3, 3);
+
+  std::future<double> continuous = submit(
+      [continuous_args](const MultiModalBivariateGaussian& f, const EigenCoords& coords)
+      { return continuous_integration_over_path(f, coords, continuous_args); },
+      mmbg,
+      path);
+  std::future<double> discrete = submit(
+      static_cast<double (*)(MultiModalBivariateGaussian, EigenCoords, DiscreteArgs*)>(discrete_integration_over_path),
+      mmbg,
+      path,
+      discrete_args);
+
+  REQUIRE_THAT(continuous.get(), WithinRel(continuous_integration_over_path(mmbg, path, continuous_args), 1e-12));
+  REQUIRE_THAT(discrete.get(), WithinRel(discrete_integration_over_path(mmbg, path, discrete_args), 1e-12));
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/cubature.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace jpathgen::cubature;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+  double factorial(int n)
+  {
+    return n <= 1 ? 1 : n * factorial(n - 1);
+  }
+}  // namespace
+
+TEST_CASE("Triangles are split into four congruent triangles", "[cubature]")
+{
+  Triangle t{ 0, 0, 2, 0, 1, 3 };
+  double total = 0;
+  for (const Triangle& child : t.split())
+  {
+    REQUIRE_THAT(child.area(), WithinRel(t.area() / 4));
+    total += child.area();
+  }
+  REQUIRE_THAT(total, WithinRel(3.0));
+}
+
+TEST_CASE("A single rule application is exact for polynomials up to degree 8", "[cubature]")
+{
+  Triangle unit{ 0, 0, 1, 0, 0, 1 };
+  for (int i = 0; i <= 8; i++)
+  {
+    for (int j = 0; i + j <= 8; j++)
+    {
+      CAPTURE(i, j);
+      auto monomial = [i, j](double x, double y) { return std::pow(x, i) * std::pow(y, j); };
+
+      Estimate estimate = apply_rule(monomial, unit);
+      REQUIRE_THAT(estimate.value, WithinAbs(factorial(i) * factorial(j) / factorial(i + j + 2), 1e-14));
+      if (i + j <= 5)
+      {
+        REQUIRE_THAT(estimate.error, WithinAbs(0, 1e-14));
+      }
+    }
+  }
+}
+
+TEST_CASE("A Gaussian is adaptively integrated", "[cubature]")
+{
+  double rel_err_req = GENERATE(1e-3, 1e-6, 1e-9);
+  std::vector<Triangle> square{ Triangle{ -10, -10, 10, -10, 10, 10 }, Triangle{ -10, -10, 10, 10, -10, 10 } };
+  auto gaussian = [](double x, double y) { return std::exp(-(x * x + y * y) / 2) / (2 * M_PI); };
+
+  jpathgen::IntegrationResult result = integrate(gaussian, square, 0, rel_err_req, 10000000);
+  REQUIRE_THAT(result.value, WithinRel(1.0, rel_err_req));
+  REQUIRE(result.error <= rel_err_req * result.value);
+  REQUIRE(result.n_regions == 2);
+  REQUIRE(result.n_evals % NODES_PER_TRIANGLE == 0);
+  REQUIRE(result.termination == jpathgen::Termination::CONVERGED);
+}
+
+TEST_CASE("The adaptive integration reports running out of evaluations", "[cubature]")
+{
+  std::vector<Triangle> square{ Triangle{ -10, -10, 10, -10, 10, 10 }, Triangle{ -10, -10, 10, 10, -10, 10 } };
+  auto gaussian = [](double x, double y) { return std::exp(-(x * x + y * y) / 2) / (2 * M_PI); };
+
+  unsigned long max_eval = 10 * NODES_PER_TRIANGLE;
+  jpathgen::IntegrationResult result = integrate(gaussian, square, 0, 1e-12, max_eval);
+  REQUIRE(result.n_evals <= max_eval);
+  REQUIRE(result.n_evals + 4 * NODES_PER_TRIANGLE > max_eval);
+  REQUIRE(result.error > 1e-12 * result.value);
+  REQUIRE(result.termination == jpathgen::Termination::MAX_EVAL);
+}
+
+TEST_CASE("The adaptive integration returns its current estimate at the deadline", "[cubature]")
+{
+  std::vector<Triangle> square{ Triangle{ -10, -10, 10, -10, 10, 10 }, Triangle{ -10, -10, 10, 10, -10, 10 } };
+  auto gaussian = [](double x, double y) { return std::exp(-(x * x + y * y) / 2) / (2 * M_PI); };
+
+  jpathgen::IntegrationResult result = integrate(gaussian, square, 0, 1e-12, 10000000, std::chrono::steady_clock::now());
+  REQUIRE(result.n_evals == square.size() * NODES_PER_TRIANGLE);
+  REQUIRE(result.error > 0);
+  REQUIRE(std::isfinite(result.value));
+  REQUIRE(result.termination == jpathgen::Termination::DEADLINE);
+}
+
+TEST_CASE("Batched integrands are evaluated one batch at a time", "[cubature]")
+{
+  std::vector<Triangle> square{ Triangle{ -10, -10, 10, -10, 10, 10 }, Triangle{ -10, -10, 10, 10, -10, 10 } };
+  auto gaussian = [](double x, double y) { return std::exp(-(x * x + y * y) / 2) / (2 * M_PI); };
+
+  unsigned long n_calls = 0, n_evals = 0;
+  auto batched = [&](const double* xs, const double* ys, double* out, std::size_t n)
+  {
+    n_calls++;
+    n_evals += n;
+    for (std::size_t i = 0; i < n; i++)
+    {
+      out[i] = gaussian(xs[i], ys[i]);
+    }
+  };
+  STATIC_REQUIRE(is_batch_integrand_v<decltype(batched)>);
+  STATIC_REQUIRE_FALSE(is_batch_integrand_v<decltype(gaussian)>);
+
+  double result = integrate(batched, square, 0, 1e-6, 10000000).value;
+  REQUIRE_THAT(result, WithinRel(integrate(gaussian, square, 0, 1e-6, 10000000).value));
+  // One call for the initial triangles, then one per split of four children
+  REQUIRE(n_evals == NODES_PER_TRIANGLE * (square.size() + 4 * (n_calls - 1)));
+}
+
+TEST_CASE("A Gaussian is integrated with a fixed rule", "[cubature]")
+{
+  int refinement = GENERATE(0, 1, 2);
+  std::vector<Triangle> square{ Triangle{ -5, -5, 5, -5, 5, 5 }, Triangle{ -5, -5, 5, 5, -5, 5 } };
+  unsigned long n_evals = 0;
+  auto gaussian = [&n_evals](double x, double y)
+  {
+    n_evals++;
+    return std::exp(-(x * x + y * y) / 2) / (2 * M_PI);
+  };
+
+  jpathgen::IntegrationResult estimate = integrate_fixed(gaussian, square, refinement);
+
+  // Only the last level and the one before it, which the error is estimated against, are evaluated
+  unsigned long n_triangles = 0;
+  for (int level = std::max(0, refinement - 1); level <= refinement; level++)
+  {
+    n_triangles += square.size() << (2 * level);
+  }
+  REQUIRE(n_evals == n_triangles * NODES_PER_TRIANGLE);
+  REQUIRE(estimate.n_evals == n_evals);
+  REQUIRE(estimate.n_regions == square.size());
+  REQUIRE(estimate.termination == jpathgen::Termination::FIXED_BUDGET);
+  REQUIRE(estimate.error > 0);
+  REQUIRE_THAT(estimate.value, WithinAbs(std::erf(5 / std::sqrt(2)) * std::erf(5 / std::sqrt(2)), estimate.error));
+}
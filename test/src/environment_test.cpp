@@ -110,3 +110,29 @@ SCENARIO("MVBivarGaussians throws expected exceptions", "[MVBG]"){
   }
 }
 
+SCENARIO("MVBivarGaussians can be evaluated in batches", "[MVBG]")
+{
+  int N = GENERATE(1, 5);
+  MultiModalBivariateGaussian mmbg = create_unit_mmbg(N, METHOD::EIGEN);
+  GIVEN("A set of points")
+  {
+    std::vector<double> xs, ys;
+    for (double xi = -2; xi <= 2; xi += 0.25)
+    {
+      for (double yi = -2; yi <= 2; yi += 0.5)
+      {
+        xs.push_back(xi);
+        ys.push_back(yi);
+      }
+    }
+    THEN("The batched result is the same as the pointwise result")
+    {
+      std::vector<double> out(xs.size(), -1);
+      mmbg(xs.data(), ys.data(), out.data(), xs.size());
+      for (size_t i = 0; i < xs.size(); i++)
+      {
+        REQUIRE_THAT(out[i], WithinRel(mmbg(xs[i], ys[i])));
+      }
+    }
+  }
+}
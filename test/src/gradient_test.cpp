@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/gradient.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+
+using namespace jpathgen::gradient;
+using Catch::Matchers::WithinAbs;
+
+namespace
+{
+  /**
+   * The buffer around a single segment from (0, 0) to (length, 0), with the round caps approximated by
+   * `quadrant_segments` chords per quarter circle as GEOS does.
+   */
+  Ring stadium(double length, double radius, int quadrant_segments)
+  {
+    Ring ring;
+    int n = 2 * quadrant_segments;
+    for (int k = 0; k <= n; k++)
+    {
+      double theta = -M_PI / 2 + M_PI * k / n;
+      ring.emplace_back(length + radius * std::cos(theta), radius * std::sin(theta));
+    }
+    for (int k = 0; k <= n; k++)
+    {
+      double theta = M_PI / 2 + M_PI * k / n;
+      ring.emplace_back(radius * std::cos(theta), radius * std::sin(theta));
+    }
+    ring.push_back(ring.front());
+    return ring;
+  }
+}  // namespace
+
+TEST_CASE("The nearest point on a path is found", "[gradient]")
+{
+  Waypoints waypoints(3, 2);
+  waypoints << 0, 0, 2, 0, 2, 2;
+
+  NearestPoint a = nearest_point(waypoints, 1, -1);
+  REQUIRE(a.segment == 0);
+  REQUIRE_THAT(a.t, WithinAbs(0.5, 1e-12));
+
+  NearestPoint b = nearest_point(waypoints, 3, 1.5);
+  REQUIRE(b.segment == 1);
+  REQUIRE_THAT(b.t, WithinAbs(0.75, 1e-12));
+
+  NearestPoint c = nearest_point(waypoints, -1, -1);
+  REQUIRE(c.segment == 0);
+  REQUIRE_THAT(c.t, WithinAbs(0, 1e-12));
+}
+
+TEST_CASE("The boundary gradient over a buffered segment is exact", "[gradient]")
+{
+  double length = GENERATE(0.5, 2.0);
+  double radius = GENERATE(0.25, 1.0);
+  int quadrant_segments = GENERATE(2, 8);
+  std::vector<Ring> rings{ stadium(length, radius, quadrant_segments) };
+
+  Waypoints waypoints(2, 2);
+  waypoints << 0, 0, length, 0;
+
+  // Area = 2 r L + pi r^2, so dA/dx_0 = -2r and dA/dx_1 = 2r
+  double area = 2 * radius * length + M_PI * radius * radius;
+
+  SECTION("Of a constant")
+  {
+    auto one = [](double, double) { return 1.0; };
+    Waypoints gradient = boundary_gradient(one, rings, waypoints, radius, radius / 8);
+    REQUIRE_THAT(gradient(0, 0), WithinAbs(-2 * radius, 1e-6));
+    REQUIRE_THAT(gradient(1, 0), WithinAbs(2 * radius, 1e-6));
+    REQUIRE_THAT(gradient(0, 1), WithinAbs(0, 1e-6));
+    REQUIRE_THAT(gradient(1, 1), WithinAbs(0, 1e-6));
+  }
+  SECTION("Of x")
+  {
+    // I = A (x_0 + x_1) / 2
+    auto x = [](double x, double) { return x; };
+    Waypoints gradient = boundary_gradient(x, rings, waypoints, radius, radius / 8);
+    REQUIRE_THAT(gradient(0, 0), WithinAbs(-2 * radius * length / 2 + area / 2, 1e-6));
+    REQUIRE_THAT(gradient(1, 0), WithinAbs(2 * radius * length / 2 + area / 2, 1e-6));
+  }
+}
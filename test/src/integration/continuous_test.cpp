@@ -11,13 +11,16 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
 
 #include "jpathgen/environment.h"
+#include "jpathgen/inline_integration.h"
 
 using namespace jpathgen::integration;
 using namespace jpathgen::function;
 using namespace jpathgen::environment;
 using namespace jpathgen::geometry;
+using Catch::Matchers::WithinAbs;
 using Catch::Matchers::WithinRel;
 
 namespace
@@ -247,6 +250,59 @@ TEST_CASE("Buffered path is continuously integrated over", "[continuous, integra
   }
 }
 
+TEST_CASE("Buffered path integration reports its diagnostics", "[continuous, integration, path, diagnostics]")
+{
+  EigenCoords path{ { 0, 0 }, { 1, 1 }, { 2, 0 } };
+  MultiModalBivariateGaussian mmbg = generate_mmbg();
+
+  SECTION("A generous evaluation budget converges")
+  {
+    auto *continuous_args = new ContinuousArgs(0.5, 0, 0.01);
+    jpathgen::IntegrationResult result =
+        continuous_integration_over_path_with_diagnostics(mmbg, path, continuous_args);
+
+    REQUIRE(result.value == continuous_integration_over_path(mmbg, path, continuous_args));
+    REQUIRE(result.error >= 0);
+    REQUIRE(result.n_evals > 0);
+    REQUIRE(result.n_regions > 0);
+    REQUIRE(result.termination == jpathgen::Termination::CONVERGED);
+  }
+  SECTION("A tiny evaluation budget runs out")
+  {
+    auto *continuous_args = new ContinuousArgs(0.5, 0, 1e-12, 10);
+    jpathgen::IntegrationResult result =
+        continuous_integration_over_path_with_diagnostics(mmbg, path, continuous_args);
+
+    REQUIRE(result.termination == jpathgen::Termination::MAX_EVAL);
+  }
+  SECTION("A deadline stops the refinement with the current estimate")
+  {
+    auto *continuous_args = new ContinuousArgs(0.5, 0, 1e-14, 100000000, 1e-9);
+    auto *reference_args = new ContinuousArgs(0.5, 0, 1e-6);
+    jpathgen::IntegrationResult result =
+        continuous_integration_over_path_with_diagnostics(mmbg, path, continuous_args);
+
+    REQUIRE(result.termination == jpathgen::Termination::DEADLINE);
+    REQUIRE(result.n_evals < continuous_args->get_max_eval());
+    REQUIRE_THAT(result.value, WithinRel(continuous_integration_over_path(mmbg, path, reference_args), 0.01));
+  }
+  SECTION("A deadline that does not pass spends the same budget as no deadline")
+  {
+    // The budget is handed to cubpackpp in several chunks, which must add up to max_eval rather than exceed it
+    auto *continuous_args = new ContinuousArgs(0.5, 0, 1e-14, 20000, 60);
+    auto *reference_args = new ContinuousArgs(0.5, 0, 1e-14, 20000);
+    jpathgen::IntegrationResult result =
+        continuous_integration_over_path_with_diagnostics(mmbg, path, continuous_args);
+    jpathgen::IntegrationResult reference =
+        continuous_integration_over_path_with_diagnostics(mmbg, path, reference_args);
+
+    REQUIRE(result.termination == jpathgen::Termination::MAX_EVAL);
+    REQUIRE(result.n_evals <= continuous_args->get_max_eval());
+    REQUIRE(result.n_evals == reference.n_evals);
+    REQUIRE_THAT(result.value, WithinRel(reference.value, 1e-12));
+  }
+}
+
 /*******************************
  * TEST INTEGRATION OVER PATHS *
  *******************************/
@@ -318,3 +374,185 @@ TEST_CASE("Rectangle is continuously integrated over", "[continuous, integration
     REQUIRE_THAT(1.0, WithinRel(result));
   }
 }
+
+/*************************************
+ * TEST WARM STARTED PATH INTEGRATION *
+ *************************************/
+
+TEST_CASE("Buffered path is continuously integrated over with a warm start", "[continuous, integration, path, warm_start]")
+{
+  auto *continuous_args = new ContinuousArgs(1.0, 0, 1e-6);
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  WarmStart warm_start;
+
+  EigenCoords path = Eigen::Matrix<double, -1, 2>::Random(5, 2);
+  double cold = continuous_integration_over_path(mmbg, path, continuous_args);
+
+  REQUIRE(warm_start.empty());
+  double first = continuous_integration_over_path(mmbg, path, continuous_args, &warm_start);
+  REQUIRE_FALSE(warm_start.empty());
+  REQUIRE(warm_start.get_n_evals() > 0);
+  REQUIRE_THAT(first, WithinRel(cold, 1e-4));
+
+  SECTION("The same path")
+  {
+    double second = continuous_integration_over_path(mmbg, path, continuous_args, &warm_start);
+    REQUIRE_THAT(second, WithinRel(cold, 1e-4));
+  }
+  SECTION("A slightly perturbed path")
+  {
+    EigenCoords perturbed = path.array() + 0.01;
+    double second = continuous_integration_over_path(mmbg, perturbed, continuous_args, &warm_start);
+    REQUIRE_THAT(second, WithinRel(continuous_integration_over_path(mmbg, perturbed, continuous_args), 1e-4));
+  }
+  SECTION("Resetting the handle")
+  {
+    warm_start.reset();
+    REQUIRE(warm_start.empty());
+    REQUIRE(warm_start.get_n_evals() == 0);
+  }
+}
+
+TEST_CASE("A warm start spends fewer evaluations than a cold start", "[continuous, integration, path, warm_start]")
+{
+  auto *continuous_args = new ContinuousArgs(1.0, 0, 1e-6);
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  WarmStart warm_start;
+
+  EigenCoords path = Eigen::Matrix<double, -1, 2>::Random(5, 2);
+  continuous_integration_over_path(mmbg, path, continuous_args, &warm_start);
+
+  SECTION("The same path")
+  {
+    jpathgen::IntegrationResult cold = continuous_integration_over_path_with_diagnostics(mmbg, path, continuous_args);
+    jpathgen::IntegrationResult warm =
+        continuous_integration_over_path_with_diagnostics(mmbg, path, continuous_args, &warm_start);
+    REQUIRE(warm.n_evals < cold.n_evals);
+    REQUIRE(warm.n_regions > cold.n_regions);
+  }
+  SECTION("A slightly moved path")
+  {
+    EigenCoords moved = path.array() + 0.01;
+    jpathgen::IntegrationResult cold = continuous_integration_over_path_with_diagnostics(mmbg, moved, continuous_args);
+    jpathgen::IntegrationResult warm =
+        continuous_integration_over_path_with_diagnostics(mmbg, moved, continuous_args, &warm_start);
+    REQUIRE(warm.n_evals < cold.n_evals);
+  }
+}
+
+/****************************************
+ * TEST INLINED (TEMPLATED) INTEGRATION *
+ ****************************************/
+
+TEST_CASE("Inlined integration agrees with the cubpackpp integration", "[continuous, integration, inlined]")
+{
+  auto *continuous_args = new ContinuousArgs(1.0, 0, 1e-6);
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  EigenCoords path = build_coords(5);
+
+  SECTION("Over a path with a GMM")
+  {
+    double exp = continuous_integration_over_path(mmbg, path, continuous_args);
+    double act = inlined::continuous_integration_over_path(mmbg, path, continuous_args);
+    REQUIRE_THAT(act, WithinRel(exp, 1e-4));
+  }
+  SECTION("Over a path with a function pointer")
+  {
+    double exp = continuous_integration_over_path(constant_return_fn, path, continuous_args);
+    double act = inlined::continuous_integration_over_path(constant_return_fn, path, continuous_args);
+    REQUIRE_THAT(act, WithinRel(exp, 1e-4));
+  }
+  SECTION("Over paths with a lambda")
+  {
+    std::vector<EigenCoords> paths{ path, build_coords(5) };
+    auto fn = [&mmbg](double x, double y) { return 2 * mmbg(x, y); };
+    double exp = 2 * continuous_integration_over_paths(mmbg, paths, continuous_args);
+    double act = inlined::continuous_integration_over_paths(fn, paths, continuous_args);
+    REQUIRE_THAT(act, WithinRel(exp, 1e-4));
+  }
+  SECTION("Over a rectangle")
+  {
+    double act = inlined::continuous_integration_over_rectangle(constant_return_fn, 0, 0.5, 0, 2, continuous_args);
+    REQUIRE_THAT(act, WithinRel(1.0));
+  }
+}
+
+/******************************************
+ * TEST INTEGRATION OF A BATCHED INTEGRAND *
+ ******************************************/
+
+TEST_CASE("A batched integrand is called once per split", "[continuous, integration, batch]")
+{
+  auto *continuous_args = new ContinuousArgs(1.0, 0, 1e-6);
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  EigenCoords path = build_coords(5);
+
+  unsigned long n_calls = 0, n_points = 0;
+  BatchFunction f = [&mmbg, &n_calls, &n_points](const double *xs, const double *ys, double *out, std::size_t n)
+  {
+    n_calls++;
+    n_points += n;
+    mmbg(xs, ys, out, n);
+  };
+
+  SECTION("Over a path")
+  {
+    jpathgen::IntegrationResult result = continuous_integration_over_path_with_diagnostics(f, path, continuous_args);
+    REQUIRE_THAT(result.value, WithinRel(continuous_integration_over_path(mmbg, path, continuous_args), 1e-4));
+    REQUIRE(result.termination == jpathgen::Termination::CONVERGED);
+    REQUIRE(n_points == result.n_evals);
+    REQUIRE(n_calls <= 1 + n_points / (4 * jpathgen::cubature::NODES_PER_TRIANGLE));
+  }
+  SECTION("Over paths")
+  {
+    std::vector<EigenCoords> paths{ path, build_coords(5) };
+    double exp = continuous_integration_over_paths(mmbg, paths, continuous_args);
+    REQUIRE_THAT(continuous_integration_over_paths(f, paths, continuous_args), WithinRel(exp, 1e-4));
+  }
+  SECTION("Over a rectangle")
+  {
+    BatchFunction constant = [](const double *xs, const double *ys, double *out, std::size_t n)
+    { std::fill(out, out + n, 1.0); };
+    REQUIRE_THAT(continuous_integration_over_rectangle(constant, 0, 0.5, 0, 2, continuous_args), WithinRel(1.0));
+  }
+}
+
+/***********************************************
+ * TEST PATH INTEGRATION GRADIENT WRT WAYPOINTS *
+ ***********************************************/
+
+TEST_CASE("The gradient of a path integral agrees with finite differences", "[continuous, integration, path, gradient]")
+{
+  auto *continuous_args = new ContinuousArgs(GENERATE(0.5, 1.0), 0, 1e-10);
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  EigenCoords path = build_coords(GENERATE(2, 4));
+
+  ValueAndGradient result = continuous_integration_over_path_with_gradient(mmbg, path, continuous_args);
+  REQUIRE_THAT(result.value, WithinRel(continuous_integration_over_path(mmbg, path, continuous_args), 1e-8));
+  REQUIRE(result.gradient.rows() == path.rows());
+
+  // GEOS approximates the round caps and joins with chords, whereas the gradient is that of the exact buffer, so the
+  // two only agree to within the chord error.
+  double h = 1e-4;
+  for (Eigen::Index i = 0; i < path.rows(); i++)
+  {
+    for (Eigen::Index j = 0; j < 2; j++)
+    {
+      EigenCoords forward = path, backward = path;
+      forward(i, j) += h;
+      backward(i, j) -= h;
+      double fd = (continuous_integration_over_path(mmbg, forward, continuous_args) -
+                   continuous_integration_over_path(mmbg, backward, continuous_args)) /
+                  (2 * h);
+      CAPTURE(i, j);
+      REQUIRE_THAT(result.gradient(i, j), WithinAbs(fd, 1e-2 * result.gradient.cwiseAbs().maxCoeff()));
+    }
+  }
+
+  SECTION("STLCoords")
+  {
+    ValueAndGradient stl_result =
+        continuous_integration_over_path_with_gradient(mmbg, eigen_to_stl_coords(path), continuous_args);
+    REQUIRE(stl_result.gradient.isApprox(result.gradient));
+  }
+}
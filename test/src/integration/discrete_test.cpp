@@ -2,6 +2,8 @@
  * Copyright (c) 2024.  Jan-Hendrik Ewers
  * SPDX-License-Identifier: GPL-3.0-only
  */
+#include <jpathgen/discrete_grid.h>
+#include <jpathgen/error.h>
 #include <jpathgen/function.h>
 #include <jpathgen/integration.h>
 
@@ -10,6 +12,7 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <eigen3/Eigen/Core>
+#include <atomic>
 
 #include "jpathgen/environment.h"
 
@@ -17,6 +20,7 @@ using namespace jpathgen::integration;
 using namespace jpathgen::function;
 using namespace jpathgen::environment;
 using namespace jpathgen::geometry;
+using Catch::Matchers::WithinAbs;
 using Catch::Matchers::WithinRel;
 
 #define REL_ACCEPTABLE_ERROR 0.01
@@ -30,6 +34,12 @@ namespace
     return 1;
   }
 
+  double throwing_fn(double a, double b)
+  {
+    jpathgen::Error(a > 0.5, "Integrand failed");
+    return 1;
+  }
+
   MultiModalBivariateGaussian generate_mmbg(int n_modes = 1)
   {
     MUS mus = Eigen::Matrix<double, -1, 2>::Zero(n_modes, 2);
@@ -232,6 +242,29 @@ TEST_CASE("Buffered paths are discretely integrated over", "[discrete, integrati
   }
 }
 
+TEST_CASE("Paths are rasterised to the points of the union of their buffers", "[discrete, integration, paths, geos]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  std::vector<EigenCoords> paths{ build_coords(6), build_coords(4), build_coords(6) };
+  std::unique_ptr<geos::geom::Geometry> polygon = geos::geom::GeometryFactory::getDefaultInstance()->createPolygon();
+  for (const EigenCoords& path : paths)
+  {
+    polygon = polygon->Union(buffer_linestring(create_linestring(coord_sequence_from_array(path)), 0.4).get());
+  }
+  int n_threads = GENERATE(1, 3);
+  auto *discrete_args = new DiscreteArgs(0.4, N / 2, M / 2, -6, 6, -6, 6, 0, n_threads);
+
+  jpathgen::IntegrationResult result = discrete_integration_over_paths_with_diagnostics(mmbg, paths, discrete_args);
+  jpathgen::IntegrationResult expected =
+      discrete_integration_over_polygon_with_diagnostics(mmbg, std::move(polygon), discrete_args);
+
+  CAPTURE(n_threads);
+  REQUIRE(result.n_evals == expected.n_evals);
+  REQUIRE_THAT(result.value, WithinRel(expected.value, 1e-12));
+  REQUIRE_THAT(result.error, WithinAbs(expected.error, 1e-12));
+  REQUIRE(discrete_integration_over_paths(mmbg, std::vector<EigenCoords>{}, discrete_args) == 0);
+}
+
 /***********************************
  * TEST INTEGRATION OVER RECTANGLE *
  **********************************/
@@ -255,3 +288,345 @@ TEST_CASE("Rectangle is discretely integrated over", "[discrete, integration, re
     REQUIRE_THAT(1.0, WithinRel(result, REL_ACCEPTABLE_ERROR));
   }
 }
+
+TEST_CASE("Rectangle integration reports its diagnostics", "[discrete, integration, rectangle, diagnostics]")
+{
+  auto *discrete_args = new DiscreteArgs(0.0, N, M, 0, 1, 0, 1);
+  jpathgen::IntegrationResult result =
+      discrete_integration_over_rectangle_with_diagnostics(constant_return_fn, 0, 1, 0, 1, discrete_args);
+
+  REQUIRE_THAT(result.value, WithinRel(1.0, REL_ACCEPTABLE_ERROR));
+  REQUIRE(result.error >= 0);
+  REQUIRE(result.n_evals > 0);
+  REQUIRE(result.n_regions == static_cast<unsigned long>(N * M));
+  REQUIRE(result.termination == jpathgen::Termination::FIXED_BUDGET);
+}
+
+TEST_CASE("The grid is visited coarse to fine until the deadline", "[discrete, integration, polygon, deadline]")
+{
+  STLCoords square{ { -1, -1 }, { -1, 1 }, { 1, 1 }, { 1, -1 }, { -1, -1 } };
+
+  SECTION("A deadline that has already passed returns the coarsest sub-grid")
+  {
+    auto *discrete_args = new DiscreteArgs(0.0, N, M, -2, 2, -2, 2, 1e-9);
+    jpathgen::IntegrationResult result =
+        discrete_integration_over_polygon_with_diagnostics(constant_return_fn, square, discrete_args);
+
+    REQUIRE(result.termination == jpathgen::Termination::DEADLINE);
+    REQUIRE(result.n_evals < static_cast<unsigned long>(N * M) / 100);
+    REQUIRE_THAT(result.value, WithinRel(4.0, 0.1));
+  }
+  SECTION("A generous deadline visits the whole grid")
+  {
+    auto *discrete_args = new DiscreteArgs(0.0, N / 10, M / 10, -2, 2, -2, 2, 1000);
+    auto *args_without_deadline = new DiscreteArgs(0.0, N / 10, M / 10, -2, 2, -2, 2);
+    jpathgen::IntegrationResult result =
+        discrete_integration_over_polygon_with_diagnostics(constant_return_fn, square, discrete_args);
+    jpathgen::IntegrationResult expected =
+        discrete_integration_over_polygon_with_diagnostics(constant_return_fn, square, args_without_deadline);
+
+    REQUIRE(result.termination == jpathgen::Termination::FIXED_BUDGET);
+    REQUIRE(result.n_evals == expected.n_evals);
+    REQUIRE_THAT(result.value, WithinRel(expected.value, 1e-12));
+    REQUIRE_THAT(result.error, WithinAbs(expected.error, 1e-9));
+  }
+}
+
+TEST_CASE("The result does not depend on the number of threads", "[discrete, integration, paths, threads]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(3);
+  std::vector<EigenCoords> coords_vec{ build_coords(20), build_coords(7) };
+  double deadline_s = GENERATE(0.0, 1000.0);
+
+  auto *serial_args = new DiscreteArgs(0.3, N, M, -5, 5, -5, 5, deadline_s, 1);
+  jpathgen::IntegrationResult expected = discrete_integration_over_paths_with_diagnostics(mmbg, coords_vec, serial_args);
+  for (int n_threads : { 2, 5, 0 })
+  {
+    auto *discrete_args = new DiscreteArgs(0.3, N, M, -5, 5, -5, 5, deadline_s, n_threads);
+    jpathgen::IntegrationResult result = discrete_integration_over_paths_with_diagnostics(mmbg, coords_vec, discrete_args);
+
+    CAPTURE(n_threads);
+    REQUIRE(result.value == expected.value);
+    REQUIRE(result.error == expected.error);
+    REQUIRE(result.n_evals == expected.n_evals);
+  }
+}
+
+TEST_CASE("An exception thrown on a worker thread is rethrown", "[discrete, integration, rectangle, threads]")
+{
+  auto *discrete_args = new DiscreteArgs(0.0, N, M, -1, 1, -1, 1, 0, 4);
+  REQUIRE_THROWS(discrete_integration_over_rectangle(throwing_fn, -1, 1, -1, 1, discrete_args));
+}
+
+TEST_CASE("A batched integrand is called once per run of grid points", "[discrete, integration, paths, batch]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(3);
+  std::vector<EigenCoords> coords_vec{ build_coords(20), build_coords(7) };
+  auto *discrete_args = new DiscreteArgs(0.3, N, M, -5, 5, -5, 5);
+
+  unsigned long n_calls = 0, n_points = 0;
+  BatchFunction f = [&mmbg, &n_calls, &n_points](const double *xs, const double *ys, double *out, std::size_t n)
+  {
+    n_calls++;
+    n_points += n;
+    mmbg(xs, ys, out, n);
+  };
+  jpathgen::IntegrationResult expected = discrete_integration_over_paths_with_diagnostics(mmbg, coords_vec, discrete_args);
+  jpathgen::IntegrationResult result = discrete_integration_over_paths_with_diagnostics(f, coords_vec, discrete_args);
+
+  REQUIRE(result.value == expected.value);
+  REQUIRE(result.n_evals == expected.n_evals);
+  REQUIRE(n_points == result.n_evals);
+  REQUIRE(n_calls < n_points / 10);
+}
+
+/********************************************
+ * TEST INTEGRATION OVER A PRECOMPUTED GRID *
+ ********************************************/
+
+TEST_CASE("A precomputed grid gives the same results as the integrand", "[discrete, integration, grid]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg();
+  DiscreteArgs discrete_args(0.5, N / 4, M / 5, -3, 4, -3, 3);
+  bool single_precision = GENERATE(false, true);
+  DiscreteGrid grid(mmbg, discrete_args, single_precision);
+  double rel = single_precision ? 1e-6 : 1e-12;
+
+  REQUIRE(grid.values().rows() == N / 4);
+  REQUIRE(grid.values().cols() == M / 5);
+  REQUIRE_THAT(grid.value(3, 7), WithinRel(mmbg(grid.get_xs()[3], grid.get_ys()[7]), rel));
+
+  EigenCoords coords = build_coords(10);
+  std::vector<STLCoords> coords_vec{ eigen_to_stl_coords(coords), eigen_to_stl_coords(build_coords(5)) };
+  STLCoords polygon{ { -1, -1 }, { -1, 1 }, { 1, 2 }, { 1, -1 }, { -1, -1 } };
+
+  REQUIRE_THAT(
+      discrete_integration_over_path(grid, coords),
+      WithinRel(discrete_integration_over_path(mmbg, coords, &discrete_args), rel));
+  REQUIRE_THAT(
+      discrete_integration_over_paths(grid, coords_vec),
+      WithinRel(discrete_integration_over_paths(mmbg, coords_vec, &discrete_args), rel));
+  REQUIRE_THAT(
+      discrete_integration_over_polygon(grid, polygon),
+      WithinRel(discrete_integration_over_polygon(mmbg, polygon, &discrete_args), rel));
+  REQUIRE_THAT(
+      discrete_integration_over_rectangle(grid, -1, 2, -2, 1),
+      WithinRel(discrete_integration_over_rectangle(mmbg, -1, 2, -2, 1, &discrete_args), rel));
+
+  jpathgen::IntegrationResult result = discrete_integration_over_polygon_with_diagnostics(grid, polygon);
+  jpathgen::IntegrationResult expected = discrete_integration_over_polygon_with_diagnostics(mmbg, polygon, &discrete_args);
+  REQUIRE(result.n_evals == expected.n_evals);
+  REQUIRE(result.termination == expected.termination);
+}
+
+TEST_CASE("A grid is evaluated a column at a time on several threads", "[discrete, integration, grid, batch]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  DiscreteArgs discrete_args(0.5, 37, 29, -3, 4, -3, 3);
+  DiscreteArgs threaded_args(0.5, 37, 29, -3, 4, -3, 3, 0, 4);
+  DiscreteGrid expected(mmbg, discrete_args);
+
+  std::atomic<int> n_calls{ 0 };
+  BatchFunction f = [&mmbg, &n_calls](const double *xs, const double *ys, double *out, std::size_t n)
+  {
+    n_calls++;
+    mmbg(xs, ys, out, n);
+  };
+  bool single_precision = GENERATE(false, true);
+  DiscreteGrid grid(f, threaded_args, single_precision);
+  REQUIRE(n_calls == threaded_args.get_N());
+  REQUIRE(grid.values().isApprox(expected.values(), single_precision ? 1e-6 : 1e-15));
+  REQUIRE(DiscreteGrid(mmbg, threaded_args).values() == expected.values());
+}
+
+TEST_CASE("A summed-area table gives the same rectangle integrals as the grid", "[discrete, integration, grid, rectangle]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  // Grid points on the integers, so that rectangle edges fall exactly on grid points
+  DiscreteArgs discrete_args(0.0, 41, 33, -20, 20, -16, 16);
+  DiscreteGrid grid(mmbg, discrete_args);
+  SummedAreaTable table(grid);
+
+  Rectangles rectangles(6, 4);
+  rectangles << -2, 3, -1, 4,      // edges on grid points
+      -2.5, 3.5, -1.5, 4.5,        // edges between grid points
+      3, -2, 4, -1,                // reversed
+      -20, 20, -16, 16,            // the whole grid
+      -30, 30, -30, 30,            // beyond the grid
+      1, 1, -5, 5;                 // empty
+  Eigen::VectorXd values = discrete_integration_over_rectangles(table, rectangles);
+
+  for (Eigen::Index k = 0; k < rectangles.rows(); k++)
+  {
+    double left = rectangles(k, 0), right = rectangles(k, 1), bottom = rectangles(k, 2), top = rectangles(k, 3);
+    jpathgen::IntegrationResult result =
+        discrete_integration_over_rectangle_with_diagnostics(table, left, right, bottom, top);
+    jpathgen::IntegrationResult expected =
+        discrete_integration_over_rectangle_with_diagnostics(grid, left, right, bottom, top);
+
+    CAPTURE(k);
+    REQUIRE(result.n_evals == expected.n_evals);
+    REQUIRE_THAT(result.value, WithinAbs(expected.value, 1e-12));
+    REQUIRE_THAT(result.error, WithinAbs(expected.error, 1e-12));
+    REQUIRE(values[k] == result.value);
+  }
+  // Grid points on the edges are left out, as Geometry::contains leaves them out, so only -1..2 by 0..3 is counted
+  REQUIRE(discrete_integration_over_rectangle_with_diagnostics(table, -2, 3, -1, 4).n_evals == 16);
+}
+
+TEST_CASE("A grid and a table over stored values are read in place", "[discrete, integration, grid, rectangle]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  DiscreteArgs discrete_args(0.5, 41, 33, -4, 4, -3, 3);
+  DiscreteGrid grid(mmbg, discrete_args, GENERATE(false, true));
+  SummedAreaTable table(grid);
+
+  std::vector<double> values(grid.values().size());
+  std::vector<float> single_values(values.size());
+  for (int i = 0; i < discrete_args.get_N(); i++)
+  {
+    for (int j = 0; j < discrete_args.get_M(); j++)
+    {
+      values[grid.index(i, j)] = grid.value(i, j);
+      single_values[grid.index(i, j)] = static_cast<float>(grid.value(i, j));
+    }
+  }
+  // Views that do not own the values, as of memory held elsewhere
+  DiscreteGrid stored = grid.is_single_precision()
+                            ? DiscreteGrid(discrete_args, std::shared_ptr<const float>(single_values.data(), [](auto) {}))
+                            : DiscreteGrid(discrete_args, std::shared_ptr<const double>(values.data(), [](auto) {}));
+  SummedAreaTable stored_table(
+      discrete_args,
+      std::shared_ptr<const double>(table.sums(), [](auto) {}),
+      std::shared_ptr<const double>(table.coarse_sums(), [](auto) {}));
+
+  REQUIRE(stored.is_single_precision() == grid.is_single_precision());
+  REQUIRE(stored.values() == grid.values());
+  EigenCoords coords = build_coords(10);
+  REQUIRE(discrete_integration_over_path(stored, coords) == discrete_integration_over_path(grid, coords));
+  REQUIRE(
+      discrete_integration_over_rectangle(stored_table, -1, 2.5, -2, 1) ==
+      discrete_integration_over_rectangle(table, -1, 2.5, -2, 1));
+  REQUIRE_THROWS(DiscreteGrid(discrete_args, std::shared_ptr<const double>()));
+}
+
+/************************************
+ * TEST FRACTIONAL COVERAGE WEIGHTS *
+ ************************************/
+
+TEST_CASE("Fractional coverage integrates a constant exactly", "[discrete, integration, coverage]")
+{
+  auto *discrete_args = new DiscreteArgs(0.3, 141, 123, -7, 7, -7, 7, 0, 1, true);
+  STLCoords triangle{ { -1.13, -0.71 }, { 1.37, -0.29 }, { 0.08, 1.53 }, { -1.13, -0.71 } };
+  double triangle_area = (2.5 * 2.24 - 1.21 * 0.42) / 2;
+
+  REQUIRE_THAT(
+      discrete_integration_over_polygon(constant_return_fn, triangle, discrete_args), WithinRel(triangle_area, 1e-12));
+  REQUIRE_THAT(
+      discrete_integration_over_rectangle(constant_return_fn, -1.27, 0.93, -0.41, 2.08, discrete_args),
+      WithinRel(2.2 * 2.49, 1e-12));
+
+  EigenCoords coords = build_coords(6);
+  auto buffered = buffer_linestring(create_linestring(coord_sequence_from_array(coords)), 0.3);
+  REQUIRE_THAT(
+      discrete_integration_over_path(constant_return_fn, coords, discrete_args),
+      WithinRel(buffered->getArea(), 1e-9));
+}
+
+TEST_CASE("Fractional coverage converges faster than counting grid points", "[discrete, integration, coverage]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  STLCoords quadrilateral{ { -1.61, -0.53 }, { 0.97, -1.48 }, { 1.72, 0.81 }, { -0.44, 1.37 }, { -1.61, -0.53 } };
+  double expected = continuous_integration_over_polygon(mmbg, quadrilateral, new ContinuousArgs(0.0, 0, 1e-10, 10000000));
+
+  // Both rules weight a point by the same cell area, so only the coverage of the boundary cells differs
+  std::vector<double> coverage_errors, centre_errors;
+  for (int n : { 61, 121, 241 })
+  {
+    auto *coverage_args = new DiscreteArgs(0.0, n, n, -3, 3, -3, 3, 0, 1, true);
+    auto *centre_args = new DiscreteArgs(0.0, n, n, -3, 3, -3, 3);
+    jpathgen::IntegrationResult result =
+        discrete_integration_over_polygon_with_diagnostics(mmbg, quadrilateral, coverage_args);
+    coverage_errors.push_back(std::abs(result.value - expected));
+    centre_errors.push_back(std::abs(discrete_integration_over_polygon(mmbg, quadrilateral, centre_args) - expected));
+
+    REQUIRE(result.error > 0);
+    REQUIRE(result.termination == jpathgen::Termination::FIXED_BUDGET);
+  }
+
+  // Second order: halving the grid spacing roughly quarters the error, which the staircase of the centre rule does not
+  REQUIRE(coverage_errors[1] < coverage_errors[0] / 3);
+  REQUIRE(coverage_errors[2] < coverage_errors[1] / 3);
+  REQUIRE(coverage_errors[2] < centre_errors[2] / 5);
+
+  auto *deadline_args = new DiscreteArgs(0.0, 61, 61, -3, 3, -3, 3, 1, 1, true);
+  REQUIRE_THROWS(discrete_integration_over_polygon(mmbg, quadrilateral, deadline_args));
+}
+
+TEST_CASE("A summed-area table weights the edge cells of a rectangle", "[discrete, integration, coverage, rectangle]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  DiscreteArgs discrete_args(0.0, 41, 33, -4, 4, -3, 3, 0, 1, true);
+  DiscreteGrid grid(mmbg, discrete_args);
+  SummedAreaTable table(grid);
+
+  Rectangles rectangles(5, 4);
+  rectangles << -1.13, 2.71, -0.52, 1.94,  // edges inside cells
+      -1.1, 2.7, -0.5, 1.9,                // edges on cell boundaries in x
+      0.05, 0.12, -0.01, 0.03,             // smaller than a cell
+      -9, 9, -9, 9,                        // beyond the grid
+      2, 2, -1, 1;                         // empty
+  for (Eigen::Index k = 0; k < rectangles.rows(); k++)
+  {
+    double left = rectangles(k, 0), right = rectangles(k, 1), bottom = rectangles(k, 2), top = rectangles(k, 3);
+    jpathgen::IntegrationResult result =
+        discrete_integration_over_rectangle_with_diagnostics(table, left, right, bottom, top);
+    jpathgen::IntegrationResult expected =
+        discrete_integration_over_rectangle_with_diagnostics(grid, left, right, bottom, top);
+
+    CAPTURE(k);
+    REQUIRE_THAT(result.value, WithinAbs(expected.value, 1e-12));
+    REQUIRE_THAT(result.error, WithinAbs(expected.error, 1e-12));
+  }
+  REQUIRE_THAT(
+      discrete_integration_over_rectangle(table, -1.13, 2.71, -0.52, 1.94),
+      WithinRel(discrete_integration_over_rectangle(mmbg, -1.13, 2.71, -0.52, 1.94, &discrete_args), 1e-12));
+}
+
+/*************************
+ * TEST COVERAGE TRACKER *
+ *************************/
+
+TEST_CASE("The coverage tracker rewards newly covered mass", "[discrete, integration, paths, tracker, geos]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  // The waypoints of build_coords(10) are within 0 <= x < 10 and -10 < y < 10
+  DiscreteArgs discrete_args(0.3, N / 2, M, -1, 10, -10, 10);
+  STLCoords path = eigen_to_stl_coords(build_coords(10));
+  CoverageTracker tracker(mmbg, discrete_args);
+
+  std::vector<STLCoords> segments;
+  double total = 0;
+  for (std::size_t k = 0; k + 1 < path.size(); k++)
+  {
+    segments.push_back(STLCoords{ path[k], path[k + 1] });
+    double reward = tracker.step(segments.back());
+    REQUIRE(reward >= 0);
+    total += reward;
+  }
+  jpathgen::IntegrationResult expected = discrete_integration_over_paths_with_diagnostics(mmbg, segments, &discrete_args);
+  REQUIRE_THAT(total, WithinRel(expected.value, 1e-12));
+  REQUIRE_THAT(tracker.get_value(), WithinRel(expected.value, 1e-12));
+  REQUIRE(tracker.get_n_evals() == expected.n_evals);
+  REQUIRE_THAT(tracker.get_value(), WithinRel(discrete_integration_over_path(mmbg, path, &discrete_args), 0.01));
+
+  unsigned long n_evals = tracker.get_n_evals();
+  REQUIRE(tracker.step(segments.front()) == 0);
+  REQUIRE(tracker.get_n_evals() == n_evals);
+
+  tracker.reset();
+  REQUIRE(tracker.get_value() == 0);
+  REQUIRE_THAT(
+      tracker.step(segments.front()),
+      WithinRel(discrete_integration_over_path(mmbg, segments.front(), &discrete_args), 1e-12));
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/integration.h>
+
+#include <algorithm>
+#include <cmath>
+#include <eigen3/Eigen/Core>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "jpathgen/environment.h"
+
+using namespace jpathgen::integration;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+  double constant_return_fn(double a, double b)
+  {
+    return 1;
+  }
+
+  MultiModalBivariateGaussian generate_mmbg(int n_modes = 1)
+  {
+    MUS mus = Eigen::Matrix<double, -1, 2>::Zero(n_modes, 2);
+    COVS covs = Eigen::Matrix<double, -1, 2>::Zero(n_modes * 2, 2);
+    for (int i = 0; i < n_modes; ++i)
+    {
+      covs.block<2, 2>(i * 2, 0) = COV::Identity();
+    }
+    return { mus, covs };
+  }
+}  // namespace
+
+/***************************************
+ * TEST FIXED INTEGRATION OVER POLYGON *
+ ***************************************/
+
+TEST_CASE("Polygon is integrated over with a fixed rule", "[fixed, integration, polygon, geos]")
+{
+  int refinement = GENERATE(0, 1, 2);
+  auto *fixed_args = new FixedArgs(2.5, refinement);
+
+  SECTION("A rectangle as a vector of coords")
+  {
+    STLCoords corners{ { 0, 0 }, { 0, 0.5 }, { 2, 0.5 }, { 2, 0 }, { 0, 0 } };
+    jpathgen::IntegrationResult result = fixed_integration_over_polygon(constant_return_fn, corners, fixed_args);
+    REQUIRE_THAT(result.value, WithinRel(1.0));
+    REQUIRE_THAT(result.error, WithinAbs(0.0, 1e-12));
+  }
+  SECTION("A rectangle as a view of row-major coords")
+  {
+    double corners[] = { 0, 0, 0, 0.5, 2, 0.5, 2, 0, 0, 0 };
+    Eigen::Map<const Eigen::Matrix<double, 5, 2, Eigen::RowMajor>> view(corners);
+    jpathgen::IntegrationResult result = fixed_integration_over_polygon(constant_return_fn, view, fixed_args);
+    REQUIRE_THAT(result.value, WithinRel(1.0));
+  }
+}
+
+/************************************
+ * TEST FIXED INTEGRATION OVER PATH *
+ ************************************/
+
+TEST_CASE("Buffered path is integrated over with a fixed rule", "[fixed, integration, path, geos]")
+{
+  int n_wps = GENERATE(2, 5, 10);
+  double buffer_radius_m = GENERATE(1, 2, 5);
+  auto *fixed_args = new FixedArgs(buffer_radius_m);
+
+  EigenCoords path = Eigen::Matrix<double, -1, 2>::Random(n_wps, 2);
+  std::unique_ptr<geos::geom::CoordinateSequenceCompat> cs = coord_sequence_from_array(path);
+  auto ls = create_linestring(std::move(cs));
+  auto buffered_path = buffer_linestring(std::move(ls), fixed_args->get_buffer_radius_m());
+
+  SECTION("Function pointer")
+  {
+    jpathgen::IntegrationResult result = fixed_integration_over_path(constant_return_fn, path, fixed_args);
+    REQUIRE_THAT(result.value, WithinRel(buffered_path->getArea(), 1e-9));
+  }
+  SECTION("Paths")
+  {
+    std::vector<EigenCoords> paths{ path, path };
+    jpathgen::IntegrationResult result = fixed_integration_over_paths(constant_return_fn, paths, fixed_args);
+    REQUIRE_THAT(result.value, WithinRel(buffered_path->getArea(), 1e-9));
+  }
+  SECTION("Views of row-major paths")
+  {
+    Eigen::Matrix<double, -1, 2, Eigen::RowMajor> row_major = path;
+    EigenCoordsRef view(row_major);
+    jpathgen::IntegrationResult result = fixed_integration_over_path(constant_return_fn, view, fixed_args);
+    REQUIRE(result.value == fixed_integration_over_path(constant_return_fn, path, fixed_args).value);
+
+    std::vector<EigenCoordsRef> paths{ row_major, row_major };
+    result = fixed_integration_over_paths(constant_return_fn, paths, fixed_args);
+    REQUIRE_THAT(result.value, WithinRel(buffered_path->getArea(), 1e-9));
+  }
+}
+
+TEST_CASE("Refining the fixed rule tightens the estimate", "[fixed, integration, path]")
+{
+  MultiModalBivariateGaussian mmbg = generate_mmbg(2);
+  EigenCoords path = Eigen::Matrix<double, -1, 2>::Random(5, 2);
+
+  auto *continuous_args = new ContinuousArgs(1.0, 0, 1e-8);
+  double exp = continuous_integration_over_path(mmbg, path, continuous_args);
+
+  double previous_error = INFINITY;
+  for (int refinement = 0; refinement < 3; refinement++)
+  {
+    auto *fixed_args = new FixedArgs(1.0, refinement);
+    jpathgen::IntegrationResult result = fixed_integration_over_path(mmbg, path, fixed_args);
+    REQUIRE_THAT(result.value, WithinAbs(exp, std::max(result.error, 1e-8)));
+    REQUIRE(result.error <= previous_error);
+    previous_error = result.error;
+  }
+}
+
+TEST_CASE("The refinement of the fixed rule is bounded", "[fixed, integration]")
+{
+  REQUIRE_NOTHROW(FixedArgs(1.0, FixedArgs::MAX_REFINEMENT));
+  REQUIRE_THROWS(FixedArgs(1.0, -1));
+  REQUIRE_THROWS(FixedArgs(1.0, FixedArgs::MAX_REFINEMENT + 1));
+}
+
+/*****************************************
+ * TEST FIXED INTEGRATION OVER RECTANGLE *
+ *****************************************/
+
+TEST_CASE("Rectangle is integrated over with a fixed rule", "[fixed, integration, rectangle]")
+{
+  auto *fixed_args = new FixedArgs(2.5);
+  std::vector<double> corners = GENERATE(std::vector<double>{ 0, 1, 0, 1 }, std::vector<double>{ 0, 0.5, 0, 2 });
+
+  jpathgen::IntegrationResult result =
+      fixed_integration_over_rectangle(constant_return_fn, corners[0], corners[1], corners[2], corners[3], fixed_args);
+  REQUIRE_THAT(result.value, WithinRel(1.0));
+}
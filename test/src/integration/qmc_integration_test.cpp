@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/integration.h>
+
+#include <eigen3/Eigen/Core>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "jpathgen/environment.h"
+
+using namespace jpathgen::integration;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+  double constant_return_fn(double a, double b)
+  {
+    return 1;
+  }
+}  // namespace
+
+/*************************************
+ * TEST QMC INTEGRATION OVER POLYGON *
+ *************************************/
+
+TEST_CASE("Polygon is integrated over with randomised QMC", "[qmc, integration, polygon, geos]")
+{
+  auto *qmc_args = new QmcArgs(2.5, 1024);
+  STLCoords corners{ { 0, 0 }, { 0, 0.5 }, { 2, 0.5 }, { 2, 0 }, { 0, 0 } };
+  jpathgen::IntegrationResult result = qmc_integration_over_polygon(constant_return_fn, corners, qmc_args);
+  REQUIRE_THAT(result.value, WithinRel(1.0));
+  REQUIRE_THAT(result.error, WithinAbs(0.0, 1e-12));
+}
+
+/**********************************
+ * TEST QMC INTEGRATION OVER PATH *
+ **********************************/
+
+TEST_CASE("Buffered path is integrated over with randomised QMC", "[qmc, integration, path, geos]")
+{
+  int n_wps = GENERATE(2, 5, 10);
+  double buffer_radius_m = GENERATE(1, 2, 5);
+
+  EigenCoords path = Eigen::Matrix<double, -1, 2>::Random(n_wps, 2);
+  MUS mus = Eigen::Matrix<double, -1, 2>::Zero(1, 2);
+  COVS covs = COV::Identity();
+  MultiModalBivariateGaussian mmbg(mus, covs);
+
+  auto *continuous_args = new ContinuousArgs(buffer_radius_m, 0, 1e-8);
+  double exp = continuous_integration_over_path(mmbg, path, continuous_args);
+
+  SECTION("With a fixed sample count")
+  {
+    auto *qmc_args = new QmcArgs(buffer_radius_m, 4096);
+    jpathgen::IntegrationResult result = qmc_integration_over_path(mmbg, path, qmc_args);
+    REQUIRE_THAT(result.value, WithinAbs(exp, 5 * result.error));
+  }
+  SECTION("With an error target")
+  {
+    auto *qmc_args = new QmcArgs(buffer_radius_m, 256, 8, 0, 1e-4);
+    jpathgen::IntegrationResult result = qmc_integration_over_path(mmbg, path, qmc_args);
+    REQUIRE(result.error <= 1e-4 * result.value);
+    REQUIRE_THAT(result.value, WithinAbs(exp, 5 * result.error));
+  }
+  SECTION("Over paths")
+  {
+    auto *qmc_args = new QmcArgs(buffer_radius_m, 4096);
+    std::vector<EigenCoords> paths{ path, path };
+    jpathgen::IntegrationResult result = qmc_integration_over_paths(mmbg, paths, qmc_args);
+    REQUIRE_THAT(result.value, WithinAbs(exp, 5 * result.error));
+  }
+}
+
+/***************************************
+ * TEST QMC INTEGRATION OVER RECTANGLE *
+ ***************************************/
+
+TEST_CASE("Rectangle is integrated over with randomised QMC", "[qmc, integration, rectangle]")
+{
+  auto *qmc_args = new QmcArgs(2.5);
+  std::vector<double> corners = GENERATE(std::vector<double>{ 0, 1, 0, 1 }, std::vector<double>{ 0, 0.5, 0, 2 });
+
+  jpathgen::IntegrationResult result =
+      qmc_integration_over_rectangle(constant_return_fn, corners[0], corners[1], corners[2], corners[3], qmc_args);
+  REQUIRE_THAT(result.value, WithinRel(1.0));
+}
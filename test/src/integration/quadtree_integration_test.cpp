@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/integration.h>
+
+#include <eigen3/Eigen/Core>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "jpathgen/environment.h"
+
+using namespace jpathgen::integration;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+  double constant_return_fn(double a, double b)
+  {
+    return 1;
+  }
+}  // namespace
+
+/******************************************
+ * TEST QUADTREE INTEGRATION OVER POLYGON *
+ ******************************************/
+
+TEST_CASE("Polygon is integrated over with a quadtree", "[quadtree, integration, polygon, geos]")
+{
+  STLCoords corners{ { 0, 0 }, { 0, 0.5 }, { 2, 0.5 }, { 2, 0 }, { 0, 0 } };
+
+  SECTION("A constant over the envelope is only split down to the minimum depth")
+  {
+    auto *quadtree_args = new QuadtreeArgs(2.5, 1e-6, 10, 3);
+    jpathgen::IntegrationResult result = quadtree_integration_over_polygon(constant_return_fn, corners, quadtree_args);
+    REQUIRE_THAT(result.value, WithinRel(1.0));
+    REQUIRE_THAT(result.error, WithinAbs(0.0, 1e-12));
+    REQUIRE(result.termination == jpathgen::Termination::CONVERGED);
+    REQUIRE(result.n_regions == 1 + 4 + 16 + 64);
+  }
+  SECTION("A target out of reach of the maximum depth")
+  {
+    STLCoords triangle{ { 0, 0 }, { 0, 1 }, { 2, 0 }, { 0, 0 } };
+    auto *quadtree_args = new QuadtreeArgs(2.5, 1e-9, 4, 1);
+    jpathgen::IntegrationResult result = quadtree_integration_over_polygon(constant_return_fn, triangle, quadtree_args);
+    REQUIRE(result.termination == jpathgen::Termination::MAX_EVAL);
+    REQUIRE(result.error > 1e-9);
+    REQUIRE_THAT(result.value, WithinAbs(1.0, 2 * result.error));
+  }
+}
+
+/***************************************
+ * TEST QUADTREE INTEGRATION OVER PATH *
+ ***************************************/
+
+TEST_CASE("Buffered path is integrated over with a quadtree", "[quadtree, integration, path, geos]")
+{
+  int n_wps = GENERATE(2, 5, 10);
+  double buffer_radius_m = GENERATE(1, 2, 5);
+
+  EigenCoords path = Eigen::Matrix<double, -1, 2>::Random(n_wps, 2);
+  MUS mus = Eigen::Matrix<double, -1, 2>::Zero(1, 2);
+  COVS covs = COV::Identity();
+  MultiModalBivariateGaussian mmbg(mus, covs);
+
+  auto *continuous_args = new ContinuousArgs(buffer_radius_m, 0, 1e-8);
+  double exp = continuous_integration_over_path(mmbg, path, continuous_args);
+
+  auto *quadtree_args = new QuadtreeArgs(buffer_radius_m, 1e-3);
+  SECTION("Over a path")
+  {
+    jpathgen::IntegrationResult result = quadtree_integration_over_path(mmbg, path, quadtree_args);
+    REQUIRE(result.n_regions > 0);
+    REQUIRE(result.n_evals > result.n_regions);
+    REQUIRE_THAT(result.value, WithinAbs(exp, result.error));
+    if (result.termination == jpathgen::Termination::CONVERGED)
+    {
+      REQUIRE(result.error <= 1e-3);
+    }
+  }
+  SECTION("Over paths")
+  {
+    std::vector<EigenCoords> paths{ path, path };
+    jpathgen::IntegrationResult result = quadtree_integration_over_paths(mmbg, paths, quadtree_args);
+    REQUIRE_THAT(result.value, WithinAbs(exp, result.error));
+  }
+}
+
+/********************************************
+ * TEST QUADTREE INTEGRATION OVER RECTANGLE *
+ ********************************************/
+
+TEST_CASE("Rectangle is integrated over with a quadtree", "[quadtree, integration, rectangle]")
+{
+  auto *quadtree_args = new QuadtreeArgs(2.5);
+  std::vector<double> corners = GENERATE(std::vector<double>{ 0, 1, 0, 1 }, std::vector<double>{ 0, 0.5, 0, 2 });
+
+  jpathgen::IntegrationResult result =
+      quadtree_integration_over_rectangle(constant_return_fn, corners[0], corners[1], corners[2], corners[3], quadtree_args);
+  REQUIRE_THAT(result.value, WithinRel(1.0));
+}
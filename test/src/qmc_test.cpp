@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/qmc.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <set>
+
+using namespace jpathgen::qmc;
+using jpathgen::IntegrationResult;
+using jpathgen::cubature::Triangle;
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+TEST_CASE("Scrambled Sobol points are stratified", "[qmc]")
+{
+  std::mt19937_64 rng(GENERATE(0, 1, 2));
+  ScrambledSobol2D sobol(rng);
+
+  // Every power-of-two prefix places exactly one point in each of the 4x4 elementary boxes
+  std::set<int> boxes;
+  for (int i = 0; i < 16; i++)
+  {
+    double u, v;
+    sobol.next(u, v);
+    REQUIRE(u > 0);
+    REQUIRE(u < 1);
+    REQUIRE(v > 0);
+    REQUIRE(v < 1);
+    boxes.insert(static_cast<int>(u * 4) * 4 + static_cast<int>(v * 4));
+  }
+  REQUIRE(boxes.size() == 16);
+}
+
+TEST_CASE("Points are mapped uniformly onto triangles", "[qmc]")
+{
+  TriangleMap map({ Triangle{ 0, 0, 2, 0, 0, 1 }, Triangle{ 2, 0, 2, 1, 0, 1 } });
+  REQUIRE_THAT(map.area(), WithinRel(2.0));
+
+  std::mt19937_64 rng(0);
+  ScrambledSobol2D sobol(rng);
+  double mean_x = 0, mean_y = 0;
+  int n = 1 << 14;
+  for (int i = 0; i < n; i++)
+  {
+    double u, v, x, y;
+    sobol.next(u, v);
+    map(u, v, x, y);
+    REQUIRE(x >= 0);
+    REQUIRE(x <= 2);
+    REQUIRE(y >= 0);
+    REQUIRE(y <= 1);
+    mean_x += x / n;
+    mean_y += y / n;
+  }
+  REQUIRE_THAT(mean_x, WithinAbs(1.0, 1e-3));
+  REQUIRE_THAT(mean_y, WithinAbs(0.5, 1e-3));
+}
+
+TEST_CASE("A Gaussian is integrated with randomised QMC", "[qmc]")
+{
+  std::vector<Triangle> square{ Triangle{ -1, -1, 1, -1, 1, 1 }, Triangle{ -1, -1, 1, 1, -1, 1 } };
+  auto gaussian = [](double x, double y) { return std::exp(-(x * x + y * y) / 2) / (2 * M_PI); };
+  double exp = std::pow(std::erf(1 / std::sqrt(2.0)), 2);
+
+  SECTION("With a fixed sample count")
+  {
+    unsigned long n_evals = 0;
+    auto counted = [&](double x, double y)
+    {
+      n_evals++;
+      return gaussian(x, y);
+    };
+    IntegrationResult estimate = integrate(counted, square, 4096, 8, 0, 0, 1 << 20, 0);
+    REQUIRE(n_evals == 4096 * 8);
+    REQUIRE(estimate.n_evals == n_evals);
+    REQUIRE(estimate.termination == jpathgen::Termination::FIXED_BUDGET);
+    REQUIRE(estimate.error > 0);
+    REQUIRE_THAT(estimate.value, WithinAbs(exp, 5 * estimate.error));
+  }
+  SECTION("With an error target")
+  {
+    double rel_err_req = GENERATE(1e-3, 1e-5);
+    IntegrationResult estimate = integrate(gaussian, square, 256, 8, 0, rel_err_req, 1 << 24, 0);
+    REQUIRE(estimate.error <= rel_err_req * estimate.value);
+    REQUIRE(estimate.termination == jpathgen::Termination::CONVERGED);
+    REQUIRE_THAT(estimate.value, WithinAbs(exp, 5 * estimate.error));
+  }
+  SECTION("Replicates are reproducible from the seed")
+  {
+    IntegrationResult a = integrate(gaussian, square, 1024, 4, 0, 0, 1 << 20, 42);
+    IntegrationResult b = integrate(gaussian, square, 1024, 4, 0, 0, 1 << 20, 42);
+    REQUIRE(a.value == b.value);
+    REQUIRE(a.error == b.error);
+  }
+}
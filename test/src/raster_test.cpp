@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/raster.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace jpathgen::raster;
+
+namespace
+{
+  // Crossing number test of a horizontal ray from (x, y), independent of the scanline code
+  bool inside(const std::vector<Ring>& rings, double x, double y)
+  {
+    bool in = false;
+    for (const Ring& ring : rings)
+    {
+      for (std::size_t k = 0; k + 1 < ring.size(); k++)
+      {
+        auto [ax, ay] = ring[k];
+        auto [bx, by] = ring[k + 1];
+        if ((ay > y) != (by > y) && x < ax + (y - ay) * (bx - ax) / (by - ay))
+        {
+          in = !in;
+        }
+      }
+    }
+    return in;
+  }
+
+  Ring square(double cx, double cy, double half)
+  {
+    return { { cx - half, cy - half }, { cx + half, cy - half }, { cx + half, cy + half },
+             { cx - half, cy + half }, { cx - half, cy - half } };
+  }
+
+  Ring star(double cx, double cy, double r_outer, double r_inner, int n_points)
+  {
+    Ring ring;
+    for (int k = 0; k <= 2 * n_points; k++)
+    {
+      double r = k % 2 == 0 ? r_outer : r_inner;
+      double angle = M_PI * k / n_points + 0.1;
+      ring.emplace_back(cx + r * std::cos(angle), cy + r * std::sin(angle));
+    }
+    return ring;
+  }
+
+  double signed_area(const Ring& ring)
+  {
+    double area = 0;
+    for (std::size_t k = 0; k + 1 < ring.size(); k++)
+    {
+      area += ring[k].first * ring[k + 1].second - ring[k + 1].first * ring[k].second;
+    }
+    return area / 2;
+  }
+
+  Ring reversed(Ring ring)
+  {
+    std::reverse(ring.begin(), ring.end());
+    return ring;
+  }
+}  // namespace
+
+TEST_CASE("Scanline spans match a point in polygon test", "[raster]")
+{
+  auto rings = GENERATE(
+      std::vector<Ring>{ square(0.013, 0.027, 0.61) },
+      std::vector<Ring>{ square(0.013, 0.027, 0.81), square(0.051, -0.033, 0.37) },
+      std::vector<Ring>{ square(-0.5, -0.5, 0.33), square(0.45, 0.52, 0.28) },
+      std::vector<Ring>{ star(0.01, -0.02, 0.93, 0.41, 7) },
+      std::vector<Ring>{ { { -0.71, -0.63 }, { 0.83, -0.21 }, { -0.12, 0.77 }, { -0.71, -0.63 } } });
+
+  const int N = 97, M = 89;
+  std::vector<double> xs(N), ys(M);
+  for (int i = 0; i < N; i++)
+  {
+    xs[i] = -1 + 2.0 * i / (N - 1);
+  }
+  for (int j = 0; j < M; j++)
+  {
+    ys[j] = -1 + 2.0 * j / (M - 1);
+  }
+
+  Scanline scanline(rings);
+  int n_inside = 0;
+  for (int pass = 0; pass < 2; pass++)
+  {
+    for (int i = 0; i < N; i++)
+    {
+      std::vector<bool> expected(M), actual(M, false);
+      for (int j = 0; j < M; j++)
+      {
+        expected[j] = inside(rings, xs[i], ys[j]);
+      }
+      for (const Span& span : scanline.spans(xs[i], ys.data(), M))
+      {
+        for (int j = span.begin; j < span.end; j++)
+        {
+          actual[j] = true;
+          n_inside++;
+        }
+      }
+      CAPTURE(pass, i);
+      REQUIRE(actual == expected);
+    }
+  }
+  REQUIRE(n_inside > 0);
+}
+
+TEST_CASE("Grid points on the boundary are outside", "[raster]")
+{
+  // Every edge of the square and of its notch lies on a grid line
+  std::vector<Ring> notched{
+    { { -0.5, -0.5 }, { 0.5, -0.5 }, { 0.5, 0 }, { 0, 0 }, { 0, 0.5 }, { -0.5, 0.5 }, { -0.5, -0.5 } }
+  };
+  const int N = 9;
+  std::vector<double> grid(N);
+  for (int i = 0; i < N; i++)
+  {
+    grid[i] = -1 + 0.25 * i;
+  }
+
+  Scanline scanline(notched);
+  std::vector<std::pair<double, double>> points;
+  for (int i = 0; i < N; i++)
+  {
+    for (const Span& span : scanline.spans(grid[i], grid.data(), N))
+    {
+      for (int j = span.begin; j < span.end; j++)
+      {
+        points.emplace_back(grid[i], grid[j]);
+      }
+    }
+  }
+  std::vector<std::pair<double, double>> expected{ { -0.25, -0.25 }, { -0.25, 0 }, { -0.25, 0.25 }, { 0, -0.25 },
+                                                   { 0.25, -0.25 } };
+  REQUIRE(points == expected);
+}
+
+TEST_CASE("A scanline through a vertex crosses the boundary twice", "[raster]")
+{
+  std::vector<Ring> diamond{ { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } } };
+  Scanline scanline(diamond);
+
+  REQUIRE(scanline.crossings(-1).size() == 2);
+  REQUIRE(scanline.crossings(0).size() == 2);
+  REQUIRE(scanline.crossings(0.5).size() == 2);
+  REQUIRE(scanline.crossings(1).empty());
+}
+
+TEST_CASE("Cell coverage adds up to the area of the polygon", "[raster]")
+{
+  auto rings = GENERATE(
+      std::vector<Ring>{ square(0.013, 0.027, 0.61) },
+      std::vector<Ring>{ square(0.013, 0.027, 0.81), reversed(square(0.051, -0.033, 0.37)) },
+      std::vector<Ring>{ square(-0.5, -0.5, 0.33), square(0.45, 0.52, 0.28) },
+      std::vector<Ring>{ star(0.01, -0.02, 0.93, 0.41, 7) },
+      std::vector<Ring>{ { { -0.71, -0.63 }, { 0.83, -0.21 }, { -0.12, 0.77 }, { -0.71, -0.63 } } });
+
+  double area = 0;
+  for (const Ring& ring : rings)
+  {
+    area += signed_area(ring);
+  }
+
+  const int N = 37, M = 29;
+  const double dx = 2.0 / N, dy = 2.0 / M;
+  Coverage coverage(rings);
+  double covered = 0;
+  for (int i = 0; i < N; i++)
+  {
+    double x0 = -1 + i * dx, x1 = x0 + dx;
+    std::vector<bool> partial(M, false);
+    for (const PartialCell& cell : coverage.partial_cells(x0, x1, -1, dy, M))
+    {
+      // Compare with the fraction of a 64 by 64 sub-grid of the cell inside the polygon
+      int n_inside = 0;
+      for (int a = 0; a < 64; a++)
+      {
+        for (int b = 0; b < 64; b++)
+        {
+          n_inside += inside(rings, x0 + (a + 0.5) * dx / 64, -1 + (cell.j + (b + 0.5) / 64) * dy);
+        }
+      }
+      CAPTURE(i, cell.j);
+      REQUIRE(std::abs(cell.coverage - n_inside / 4096.0) < 0.02);
+      partial[cell.j] = true;
+      covered += cell.coverage * dx * dy;
+    }
+    for (int j = 0; j < M; j++)
+    {
+      if (!partial[j] && inside(rings, x0 + dx / 2, -1 + (j + 0.5) * dy))
+      {
+        covered += dx * dy;
+      }
+    }
+  }
+  REQUIRE(std::abs(covered - area) < 1e-12);
+}
+
+TEST_CASE("A bitmask holds the union of the spans set on it", "[raster]")
+{
+  const int N = 7, M = 150;
+  Bitmask a(N, M), b(N, M);
+  std::vector<std::vector<bool>> expected(N, std::vector<bool>(M, false));
+  auto set = [&expected](Bitmask& mask, int i, int begin, int end)
+  {
+    mask.set(i, begin, end);
+    for (int j = begin; j < end; j++)
+    {
+      expected[i][j] = true;
+    }
+  };
+  set(a, 1, 3, 5);
+  set(a, 1, 60, 70);
+  set(a, 2, 0, 150);
+  set(b, 1, 4, 61);
+  set(b, 4, 64, 128);
+  set(b, 4, 140, 141);
+  set(b, 5, 10, 10);
+
+  REQUIRE(a.column_begin() == 1);
+  REQUIRE(a.column_end() == 3);
+  a |= b;
+  REQUIRE(a.column_begin() == 1);
+  REQUIRE(a.column_end() == 5);
+
+  std::size_t n_set = 0;
+  std::vector<Span> spans;
+  for (int i = 0; i < N; i++)
+  {
+    std::vector<bool> actual(M, false);
+    for (const Span& span : a.spans(i, spans))
+    {
+      REQUIRE(span.begin < span.end);
+      for (int j = span.begin; j < span.end; j++)
+      {
+        actual[j] = true;
+        n_set++;
+      }
+    }
+    for (int j = 0; j < M; j++)
+    {
+      REQUIRE(a.test(i, j) == expected[i][j]);
+    }
+    CAPTURE(i);
+    REQUIRE(actual == expected[i]);
+  }
+  REQUIRE(a.spans(1, spans).size() == 1);
+  REQUIRE(n_set == a.count());
+  REQUIRE(n_set == (70 - 3) + 150 + (128 - 64) + 1);
+
+  a.clear();
+  REQUIRE(a.count() == 0);
+  REQUIRE(a.column_begin() >= a.column_end());
+}
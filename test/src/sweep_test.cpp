@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/sweep.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "jpathgen/environment.h"
+
+using namespace jpathgen::sweep;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using Catch::Matchers::WithinRel;
+
+namespace
+{
+  Measurement measurement(double seconds, double error)
+  {
+    Measurement m;
+    m.seconds = seconds;
+    m.error = error;
+    return m;
+  }
+}  // namespace
+
+TEST_CASE("The Pareto frontier keeps the settings that nothing beats on both time and error", "[sweep]")
+{
+  std::vector<Measurement> measurements = {
+    measurement(3, 1e-2),  // Slower than 1 and less accurate
+    measurement(1, 1e-3),
+    measurement(2, 1e-3),  // As accurate as 1 but slower
+    measurement(5, 1e-6),
+    measurement(0.5, 1e-1),
+    measurement(4, 1e-5),
+  };
+  mark_pareto_frontier(measurements);
+
+  std::vector<bool> pareto;
+  for (const Measurement& m : measurements)
+  {
+    pareto.push_back(m.pareto);
+  }
+  REQUIRE(pareto == std::vector<bool>{ false, true, false, true, true, true });
+}
+
+TEST_CASE("Numbers that are not finite are written to JSON as null", "[sweep]")
+{
+  SweepResult result;
+  result.reference = { 1, std::numeric_limits<double>::quiet_NaN() };
+  result.reference_error = std::numeric_limits<double>::infinity();
+  result.measurements = { measurement(1, std::numeric_limits<double>::quiet_NaN()),
+                          measurement(-std::numeric_limits<double>::infinity(), 1e-3) };
+
+  std::ostringstream out;
+  write_json(out, result);
+  const std::string json = out.str();
+  REQUIRE(json.find("\"reference\": [1, null]") != std::string::npos);
+  REQUIRE(json.find("\"reference_error\": null") != std::string::npos);
+  REQUIRE(json.find("\"error\": null") != std::string::npos);
+  REQUIRE(json.find("\"seconds\": null") != std::string::npos);
+  REQUIRE(json.find("inf") == std::string::npos);
+  REQUIRE(json.find("nan") == std::string::npos);
+}
+
+TEST_CASE("A sweep compares every setting with the reference", "[sweep]")
+{
+  MUS mus = MUS::Zero(1, 2);
+  COVS covs = COVS::Zero(2, 2);
+  covs.block<2, 2>(0, 0) = COV::Identity();
+  MultiModalBivariateGaussian mmbg(mus, covs);
+
+  EigenCoords straight(2, 2), bent(3, 2);
+  straight << -1, 0, 1, 0;
+  bent << -1, -1, 0, 1, 1, -1;
+  std::vector<EigenCoords> paths = { straight, bent };
+
+  SweepArgs args(0.5, { 1e-1, 1e-4 }, { 1000, 100000 }, { 20, 200 }, 1);
+  SweepResult result = accuracy_sweep(mmbg, paths, args);
+
+  REQUIRE(result.reference.size() == 2);
+  REQUIRE(result.reference[0] > 0);
+  REQUIRE(result.reference[1] > 0);
+  REQUIRE(result.reference_error < 1e-6);
+  REQUIRE(result.measurements.size() == 6);
+  REQUIRE(std::count_if(result.measurements.begin(), result.measurements.end(), [](auto& m) { return m.pareto; }) > 0);
+
+  for (const Measurement& m : result.measurements)
+  {
+    REQUIRE(m.seconds >= 0);
+    REQUIRE(m.error >= 0);
+    if (m.mode == Mode::DISCRETE)
+    {
+      REQUIRE(m.M >= 2);
+    }
+  }
+  // The tightest continuous setting lands close to the reference, and the finer grid does better than the coarse one
+  REQUIRE(result.measurements[3].error < 1e-3);
+  REQUIRE(result.measurements[5].error < result.measurements[4].error);
+
+  std::ostringstream out;
+  write_json(out, result);
+  REQUIRE(out.str().find("\"reference_error\"") != std::string::npos);
+  REQUIRE(out.str().find("\"mode\": \"discrete\"") != std::string::npos);
+
+  REQUIRE_THROWS(accuracy_sweep(mmbg, std::vector<EigenCoords>(), args));
+}
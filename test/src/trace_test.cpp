@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+#include <jpathgen/trace.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace jpathgen::trace;
+
+namespace
+{
+  StageStats stage(const Stats& stats, Stage s)
+  {
+    return stats[static_cast<std::size_t>(s)];
+  }
+
+  void traced_buffer()
+  {
+    JPATHGEN_TRACE_SCOPE(BUFFER);
+  }
+}  // namespace
+
+TEST_CASE("Recorded stages are counted per thread and in aggregate", "[trace]")
+{
+  reset();
+  Clock::time_point start = Clock::now();
+  record(Stage::UNION, start, start + std::chrono::microseconds(5));
+  record(Stage::UNION, start, start + std::chrono::microseconds(2));
+
+  REQUIRE(stage(thread_stats(), Stage::UNION).calls == 2);
+  REQUIRE(stage(thread_stats(), Stage::UNION).total_ns == 7000);
+  REQUIRE(stage(thread_stats(), Stage::UNION).max_ns == 5000);
+  REQUIRE(stage(thread_stats(), Stage::CUBATURE).calls == 0);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.emplace_back([start]() { record(Stage::UNION, start, start + std::chrono::microseconds(1)); });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  REQUIRE(stage(stats(), Stage::UNION).calls == 6);
+  REQUIRE(stage(stats(), Stage::UNION).total_ns == 11000);
+  REQUIRE(stage(thread_stats(), Stage::UNION).calls == 2);
+
+  reset();
+  REQUIRE(stage(stats(), Stage::UNION).calls == 0);
+}
+
+TEST_CASE("The trace scope compiles out when tracing is disabled", "[trace]")
+{
+  reset();
+  traced_buffer();
+  REQUIRE(stage(stats(), Stage::BUFFER).calls == (enabled() ? 1 : 0));
+}
+
+TEST_CASE("The Chrome trace sink writes one complete event per stage", "[trace]")
+{
+  std::ostringstream out;
+  {
+    auto sink = std::make_shared<ChromeTraceSink>(out);
+    set_sink(sink);
+    Clock::time_point start = Clock::now();
+    record(Stage::BUFFER, start, start + std::chrono::microseconds(3));
+    record(Stage::CUBATURE, start, start + std::chrono::microseconds(4));
+    set_sink(nullptr);
+  }
+  std::string trace = out.str();
+  REQUIRE(trace.front() == '[');
+  REQUIRE(trace.find(R"("name":"buffer")") != std::string::npos);
+  REQUIRE(trace.find(R"("name":"cubature")") != std::string::npos);
+  REQUIRE(trace.find(R"("ph":"X")") != std::string::npos);
+  REQUIRE(trace.find("]\n") == trace.size() - 2);
+}
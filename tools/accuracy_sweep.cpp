@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024.  Jan-Hendrik Ewers
+ * SPDX-License-Identifier: GPL-3.0-only
+ */
+
+/*
+ * Sweep the integration settings over a representative environment and path set, and print the wall time and error of
+ * every setting as JSON, with the Pareto frontier flagged. The input file has one mode or path per line:
+ *
+ *     # comment
+ *     mode mu_x mu_y sigma_xx sigma_xy sigma_yx sigma_yy
+ *     path x0 y0 x1 y1 ...
+ *
+ *     jpathgen_accuracy_sweep FILE [--buffer-radius R] [--repeats K] [--rel-err-reqs A,B,...] [--max-evals A,B,...]
+ *                                  [--grid-sizes A,B,...]
+ */
+
+#include <jpathgen/environment.h>
+#include <jpathgen/error.h>
+#include <jpathgen/sweep.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jpathgen;
+using namespace jpathgen::environment;
+using namespace jpathgen::geometry;
+using namespace jpathgen::sweep;
+
+namespace
+{
+  const char* const USAGE =
+      "usage: jpathgen_accuracy_sweep FILE [--buffer-radius R] [--repeats K] [--rel-err-reqs A,B,...] "
+      "[--max-evals A,B,...] [--grid-sizes A,B,...]\n";
+
+  template<typename T>
+  std::vector<T> parse_list(const std::string& text)
+  {
+    std::vector<T> values;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+      std::istringstream item_stream(item);
+      T value;
+      Error(!(item_stream >> value), "Could not parse a comma separated list");
+      values.push_back(value);
+    }
+    Error(values.empty(), "A comma separated list is empty");
+    return values;
+  }
+
+  void read_input(std::istream& in, std::vector<std::vector<double>>& modes, std::vector<EigenCoords>& paths)
+  {
+    std::string line;
+    while (std::getline(in, line))
+    {
+      std::istringstream stream(line);
+      std::string kind;
+      if (!(stream >> kind) || kind[0] == '#')
+      {
+        continue;
+      }
+      std::vector<double> values;
+      double value;
+      while (stream >> value)
+      {
+        values.push_back(value);
+      }
+      Error(!stream.eof(), "Could not parse a number in the input");
+      if (kind == "mode")
+      {
+        Error(values.size() != 6, "A mode needs mu_x mu_y sigma_xx sigma_xy sigma_yx sigma_yy");
+        modes.push_back(values);
+      }
+      else if (kind == "path")
+      {
+        Error(values.size() < 4 || values.size() % 2 != 0, "A path needs at least two x y waypoints");
+        EigenCoords path(values.size() / 2, 2);
+        for (std::size_t k = 0; k < values.size() / 2; k++)
+        {
+          path(k, 0) = values[2 * k];
+          path(k, 1) = values[2 * k + 1];
+        }
+        paths.push_back(path);
+      }
+      else
+      {
+        Error(true, "Lines must start with mode, path or #");
+      }
+    }
+    Error(modes.empty(), "The input has no modes");
+    Error(paths.empty(), "The input has no paths");
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    std::string file;
+    double buffer_radius_m = 1;
+    SweepArgs defaults(buffer_radius_m);
+    std::vector<double> rel_err_reqs = defaults.get_rel_err_reqs();
+    std::vector<unsigned long> max_evals = defaults.get_max_evals();
+    std::vector<int> grid_sizes = defaults.get_grid_sizes();
+    int n_repeats = defaults.get_n_repeats();
+
+    for (int k = 1; k < argc; k++)
+    {
+      std::string arg = argv[k];
+      if (arg == "-h" || arg == "--help")
+      {
+        std::cout << USAGE;
+        return 0;
+      }
+      if (arg.rfind("--", 0) != 0)
+      {
+        Error(!file.empty(), "Only one input file can be given");
+        file = arg;
+        continue;
+      }
+      Error(k + 1 >= argc, "An option is missing its value");
+      std::string value = argv[++k];
+      if (arg == "--buffer-radius")
+      {
+        buffer_radius_m = parse_list<double>(value).at(0);
+      }
+      else if (arg == "--repeats")
+      {
+        n_repeats = parse_list<int>(value).at(0);
+      }
+      else if (arg == "--rel-err-reqs")
+      {
+        rel_err_reqs = parse_list<double>(value);
+      }
+      else if (arg == "--max-evals")
+      {
+        max_evals = parse_list<unsigned long>(value);
+      }
+      else if (arg == "--grid-sizes")
+      {
+        grid_sizes = parse_list<int>(value);
+      }
+      else
+      {
+        Error(true, "Unknown option");
+      }
+    }
+    Error(file.empty(), "No input file was given");
+
+    std::vector<std::vector<double>> modes;
+    std::vector<EigenCoords> paths;
+    std::ifstream in(file);
+    Error(!in, "Could not open the input file");
+    read_input(in, modes, paths);
+
+    MUS mus(modes.size(), 2);
+    COVS covs(modes.size() * 2, 2);
+    for (std::size_t k = 0; k < modes.size(); k++)
+    {
+      mus.row(k) << modes[k][0], modes[k][1];
+      covs.block<2, 2>(2 * k, 0) << modes[k][2], modes[k][3], modes[k][4], modes[k][5];
+    }
+    MultiModalBivariateGaussian mmbg(mus, covs);
+
+    SweepArgs args(buffer_radius_m, rel_err_reqs, max_evals, grid_sizes, n_repeats);
+    write_json(std::cout, accuracy_sweep(mmbg, paths, args));
+  }
+  catch (const char* message)
+  {
+    std::cerr << message << "\n" << USAGE;
+    return 1;
+  }
+  return 0;
+}